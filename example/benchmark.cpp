@@ -0,0 +1,679 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <ctime>
+
+#include <chzzkpp/ChzzkChat.h>
+#include <chzzkpp/ChzzkMockServer.h>
+#include <chzzkpp/ChzzkChatRecorder.h>
+
+#if _USE_SIMDJSON
+#include <simdjson.h>
+#endif
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//replays chat frames from ChzzkMockServer as fast as the chats handle them, and reports the throughput and the latency
+//usage: benchmark [chats] [messages per chat] [string|view|chat|shared] [inline|queued] [--allocs]
+//--allocs counts the heap calls while the frames are replayed, and reports them per frame
+//ex) benchmark 4 200000 chat queued
+//ex) benchmark 1 100000 view inline --allocs
+//
+//reads the fields of the chats in a corpus of frames with the json backend, and reports GB/s and msgs/s
+//usage: benchmark --backend=nlohmann|simdjson [--corpus=path] [--loops=n]
+//simdjson needs _USE_SIMDJSON
+//
+//compares the receive loop of the chat before and after it blocked on the socket readiness, and reports msgs/s and the receive latency
+//usage: benchmark --receive [--corpus=path] [--frames=n] [--rate=frames per second]
+//the throughput is measured with the frames written as fast as possible, and the latency with the frames written at the rate. not on windows
+//
+//handles a corpus of frames with each kind of chat and donation handlers, and reports the cpu time and the heap calls per message
+//usage: benchmark --handlers [--corpus=path] [--loops=n]
+//string+parse parses the string in the handler again, like the handlers did before the typed ones
+//
+//--corpus is a log of ChzzkChatRecorder, or a file with a frame on each line like ChzzkMockServer::loadFrames
+//generated chat and donation frames are used if not given
+
+#if defined(__GNUC__) && !defined(__clang__)
+//the replaced operators below are paired, but gcc warns when it sees free of a pointer from operator new
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+//heap calls of the whole process, counted only while countAllocations is set
+static std::atomic<bool> countAllocations(false);
+static std::atomic<size_t> allocations(0);
+
+void* operator new(std::size_t size)
+{
+	if (countAllocations.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+static std::string makeFrame(int index)
+{
+	//same shape as the CHAT frames of the server, with a few messages of different length
+	std::string message = "benchmark message " + std::to_string(index) + std::string(index % 4 * 16, 'a');
+
+	return R"({"svcid":"game","ver":"1","bdy":[{"svcid":"game","cid":"N1","mbrCnt":1234,"uid":"user)" + std::to_string(index) + R"(","profile":"{\"userIdHash\":\"user)" + std::to_string(index)
+		+ R"(\",\"nickname\":\"viewer)" + std::to_string(index) + R"(\",\"profileImageUrl\":\"\",\"userRoleCode\":\"common_user\",\"badge\":null,\"title\":null,\"verifiedMark\":false,\"activityBadges\":[],\"streamingProperty\":{}}","msg":")"
+		+ message + R"(","msgTypeCode":1,"msgStatusType":"NORMAL","extras":"{\"chatType\":\"STREAMING\",\"osType\":\"PC\",\"emojis\":{}}","ctime":1700000000000,"utime":1700000000000,"msgTid":null,"msgTime":1700000000000}],"cmd":93101,"tid":null,"cid":"N1"})";
+}
+
+static std::string makeDonationFrame(int index)
+{
+	return R"({"svcid":"game","ver":"1","bdy":[{"svcid":"game","cid":"N1","mbrCnt":1234,"uid":"user)" + std::to_string(index) + R"(","profile":"{\"userIdHash\":\"user)" + std::to_string(index)
+		+ R"(\",\"nickname\":\"donator)" + std::to_string(index) + R"(\",\"profileImageUrl\":\"\",\"userRoleCode\":\"common_user\",\"badge\":null,\"title\":null,\"verifiedMark\":false,\"activityBadges\":[],\"streamingProperty\":{}}","msg":"donation )"
+		+ std::to_string(index) + R"(","msgTypeCode":10,"msgStatusType":"NORMAL","extras":"{\"isAnonymous\":false,\"payType\":\"CURRENCY\",\"payAmount\":)" + std::to_string(1000 * (index % 10 + 1))
+		+ R"(,\"donationType\":\"CHAT\",\"chatType\":\"STREAMING\",\"osType\":\"PC\",\"emojis\":{}}","ctime":1700000000000,"utime":1700000000000,"msgTid":null,"msgTime":1700000000000}],"cmd":93102,"tid":null,"cid":"N1"})";
+}
+
+//frames of the corpus. generated if path is empty
+static std::vector<std::string> loadCorpus(const std::string& path)
+{
+	std::vector<std::string> frames;
+
+	if (path.empty())
+	{
+		//a donation for every 20 chats
+		for (int i = 0; i < 1000; i++)
+			frames.push_back(i % 20 == 19 ? makeDonationFrame(i) : makeFrame(i));
+
+		return frames;
+	}
+
+	chzzkpp::ChzzkChatReplayer replayer(path);
+
+	if (!replayer.getSegments().empty())
+	{
+		replayer.replay([&](uint64_t, std::string_view frame) { frames.emplace_back(frame); });
+		return frames;
+	}
+
+	//one frame for each line, same as ChzzkMockServer::loadFrames
+	std::ifstream file(path);
+
+	for (std::string line; std::getline(file, line);)
+		if (!line.empty()) frames.push_back(line);
+
+	return frames;
+}
+
+//sum of the fields read from the chats. keeps the reads from being optimized out
+struct ChatFields
+{
+	size_t chats = 0;
+	size_t characters = 0;
+	unsigned long long numbers = 0;
+};
+
+//reads the chat fields of onMessage from a frame with nlohmann::json. returns false if the frame is not json
+static bool readNlohmann(const std::string& frame, ChatFields& fields)
+{
+	nlohmann::json json = nlohmann::json::parse(frame, nullptr, false);
+	if (json.is_discarded() || !json.is_object()) return false;
+
+	auto body = json.find("bdy");
+	if (body == json.end()) return true;
+
+	const nlohmann::json* list = &*body;
+
+	if (body->is_object())
+	{
+		auto messageList = body->find("messageList");
+		if (messageList == body->end()) return true;
+
+		list = &*messageList;
+	}
+
+	if (!list->is_array()) return true;
+
+	for (auto& chat : *list)
+	{
+		if (!chat.is_object()) continue;
+
+		for (auto& item : chat.items())
+		{
+			if (item.value().is_string()) fields.characters += item.value().get_ref<const std::string&>().size();
+			else if (item.value().is_number_integer()) fields.numbers += item.value().get<long long>();
+		}
+
+		fields.chats++;
+	}
+
+	return true;
+}
+
+#if _USE_SIMDJSON
+//same as readNlohmann with simdjson on-demand parser
+static bool readSimdjson(simdjson::ondemand::parser& parser, const simdjson::padded_string& frame, ChatFields& fields)
+{
+	simdjson::ondemand::document document;
+	if (parser.iterate(frame).get(document)) return false;
+
+	simdjson::ondemand::value body;
+	if (document["bdy"].get(body)) return true;
+
+	simdjson::ondemand::json_type type;
+	if (body.type().get(type)) return false;
+
+	simdjson::ondemand::array list;
+
+	if (type == simdjson::ondemand::json_type::object)
+	{
+		if (body["messageList"].get_array().get(list)) return true;
+	}
+	else if (type != simdjson::ondemand::json_type::array || body.get_array().get(list)) return true;
+
+	for (auto element : list)
+	{
+		simdjson::ondemand::object chat;
+		if (element.get_object().get(chat)) continue;
+
+		for (auto field : chat)
+		{
+			simdjson::ondemand::value value;
+			if (field.value().get(value) || value.type().get(type)) return false;
+
+			if (type == simdjson::ondemand::json_type::string)
+			{
+				std::string_view str;
+				if (value.get_string().get(str)) return false;
+
+				fields.characters += str.size();
+			}
+			else if (type == simdjson::ondemand::json_type::number)
+			{
+				int64_t number;
+				if (!value.get_int64().get(number)) fields.numbers += number;
+			}
+		}
+
+		fields.chats++;
+	}
+
+	return true;
+}
+#endif
+
+static int runBackend(const std::string& backend, const std::vector<std::string>& frames, size_t loops)
+{
+	size_t bytes = 0;
+
+	for (auto& frame : frames)
+		bytes += frame.size();
+
+	ChatFields fields;
+	size_t failed = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	if (backend == "nlohmann")
+	{
+		for (size_t loop = 0; loop < loops; loop++)
+			for (auto& frame : frames)
+				if (!readNlohmann(frame, fields)) failed++;
+	}
+	else if (backend == "simdjson")
+	{
+#if _USE_SIMDJSON
+		//the frames are padded before the run. the chat copies each frame into its padded buffer
+		std::vector<simdjson::padded_string> padded;
+		padded.reserve(frames.size());
+
+		for (auto& frame : frames)
+			padded.emplace_back(frame);
+
+		simdjson::ondemand::parser parser;
+		start = std::chrono::steady_clock::now();
+
+		for (size_t loop = 0; loop < loops; loop++)
+			for (auto& frame : padded)
+				if (!readSimdjson(parser, frame, fields)) failed++;
+#else
+		std::cerr << "simdjson backend needs _USE_SIMDJSON" << std::endl;
+		return 1;
+#endif
+	}
+	else
+	{
+		std::cerr << "unknown backend " << backend << std::endl;
+		return 1;
+	}
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	size_t count = frames.size() * loops;
+
+	std::cout << "backend " << backend << ", frames " << count << ", chats " << fields.chats << ", failed " << failed << std::endl;
+	std::cout << std::fixed << std::setprecision(3) << (double)bytes * loops / elapsed / 1e9 << " GB/s, "
+		<< std::setprecision(0) << count / elapsed << " msgs/s" << std::endl;
+
+	return fields.characters || fields.numbers ? 0 : 1;
+}
+
+//feeds the corpus to a chat with the kind of handlers, counting the cpu time and the heap calls
+static void runHandlers(const std::string& kind, const std::vector<std::string>& frames, size_t loops)
+{
+	chzzkpp::ChzzkChat chat(nullptr, chzzkpp::ChzzkChatOptions());
+
+	size_t messages = 0;
+	size_t characters = 0;
+
+	if (kind == "string" || kind == "string+parse")
+	{
+		bool parse = kind == "string+parse";
+
+		for (auto type : { chzzkpp::ChzzkChatEvent::CHAT, chzzkpp::ChzzkChatEvent::DONATION })
+		{
+			chat.addHandler(type, [&, parse](const std::string& message) {
+				if (parse) characters += nlohmann::json::parse(message)["message"].get_ref<const std::string&>().size();
+				else characters += message.size();
+
+				messages++;
+			});
+		}
+	}
+	else if (kind == "view")
+	{
+		for (auto type : { chzzkpp::ChzzkChatEvent::CHAT, chzzkpp::ChzzkChatEvent::DONATION })
+			chat.addViewHandler(type, [&](const chzzkpp::ChzzkChatView& view) { characters += view.message().size(); messages++; });
+	}
+	else if (kind == "typed")
+	{
+		chat.addChatHandler([&](const chzzkpp::ChzzkChatMessage& message) { characters += message.message.size(); messages++; });
+		chat.addDonationHandler([&](const chzzkpp::ChzzkDonationMessage& message) { characters += message.message.size() + message.payAmount; messages++; });
+	}
+	else if (kind == "shared")
+	{
+		chat.addSharedChatHandler([&](const chzzkpp::ChzzkSharedChatMessage& message) { characters += message->message.message.size(); messages++; });
+		chat.addSharedDonationHandler([&](const chzzkpp::ChzzkSharedDonationMessage& message) { characters += message->message.message.size() + message->message.payAmount; messages++; });
+	}
+
+	allocations = 0;
+	countAllocations = true;
+
+	std::clock_t start = std::clock();
+
+	for (size_t loop = 0; loop < loops; loop++)
+		for (auto& frame : frames)
+			chat.feed(frame);
+
+	std::clock_t end = std::clock();
+	countAllocations = false;
+
+	double cpu = (double)(end - start) / CLOCKS_PER_SEC;
+	size_t count = messages ? messages : 1;
+
+	std::cout << std::left << std::setw(14) << kind << std::right << std::fixed
+		<< " messages " << std::setw(9) << messages
+		<< "  cpu " << std::setprecision(0) << std::setw(7) << cpu * 1e9 / count << "ns"
+		<< "  heap calls " << std::setprecision(1) << std::setw(6) << (double)allocations / count << std::endl;
+}
+
+#ifndef _WIN32
+//receive loops compared by --receive. the frames are written to a local socket with their length, and handled with ChzzkChat::feed
+//the parsing and the handlers are the same, so only the loops differ
+enum class ReceiveLoop
+{
+	SLEEP,	//the loop before: reads up to 255 bytes, and sleeps 10 ms after every read
+	POLL,	//the loop now: blocks until the socket is readable, and handles every frame available on the wakeup
+};
+
+struct ReceiveResult
+{
+	size_t frames;
+	double elapsed;
+	chzzkpp::ChzzkHistogramSnapshot latency;	//from the write of the frame until its handlers returned
+};
+
+//@rate frames per second written to the socket. as fast as possible if 0
+//@maxTime seconds until the loop stops, even if some frames are not received
+static ReceiveResult runReceive(ReceiveLoop loop, const std::vector<std::string>& frames, size_t count, int rate, double maxTime)
+{
+	using Clock = std::chrono::steady_clock;
+
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) return ReceiveResult();
+
+	fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+	//the chat is not connected, so feed handles the frames on this thread
+	chzzkpp::ChzzkChat chat(nullptr, chzzkpp::ChzzkChatOptions());
+
+	size_t characters = 0;
+	chat.addViewHandler(chzzkpp::ChzzkChatEvent::CHAT, [&](const chzzkpp::ChzzkChatView& view) { characters += view.message().size(); });
+	chat.addViewHandler(chzzkpp::ChzzkChatEvent::DONATION, [&](const chzzkpp::ChzzkChatView& view) { characters += view.message().size(); });
+
+	//nanoseconds since start when each frame was written
+	std::unique_ptr<std::atomic<int64_t>[]> sentAt(new std::atomic<int64_t>[count]);
+	std::atomic<bool> stopped(false);
+
+	auto start = Clock::now();
+
+	std::thread sender([&]() {
+		std::string packet;
+
+		for (size_t i = 0; i < count && !stopped; i++)
+		{
+			if (rate) std::this_thread::sleep_until(start + std::chrono::microseconds(i * 1000000 / rate));
+
+			const std::string& frame = frames[i % frames.size()];
+			uint32_t length = (uint32_t)frame.size();
+
+			packet.assign((const char*)&length, sizeof(length));
+			packet += frame;
+
+			sentAt[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+			//blocks while the receiver is behind. fails once the receiver is closed
+			for (size_t sent = 0; sent < packet.size();)
+			{
+				ssize_t n = send(fds[1], packet.data() + sent, packet.size() - sent, MSG_NOSIGNAL);
+				if (n <= 0) return;
+
+				sent += n;
+			}
+		}
+	});
+
+	chzzkpp::ChzzkHistogram latency;
+	std::string pending;	//bytes of the frames not complete yet
+	std::vector<char> chunk(64 * 1024);
+	size_t received = 0;
+
+	//handles the complete frames in pending
+	auto handle = [&]() {
+		size_t offset = 0;
+
+		while (pending.size() - offset >= sizeof(uint32_t))
+		{
+			uint32_t length;
+			std::memcpy(&length, pending.data() + offset, sizeof(length));
+
+			if (pending.size() - offset - sizeof(length) < length) break;
+
+			chat.feed(std::string_view(pending.data() + offset + sizeof(length), length));
+
+			int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+			latency.record((uint64_t)(now - sentAt[received]) / 1000);
+
+			received++;
+			offset += sizeof(length) + length;
+		}
+
+		pending.erase(0, offset);
+	};
+
+	while (received < count && std::chrono::duration<double>(Clock::now() - start).count() < maxTime)
+	{
+		if (loop == ReceiveLoop::SLEEP)
+		{
+			ssize_t n = recv(fds[0], chunk.data(), 255, 0);
+
+			if (n > 0)
+			{
+				pending.append(chunk.data(), n);
+				handle();
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		else
+		{
+			pollfd descriptor = { fds[0], POLLIN, 0 };
+			if (poll(&descriptor, 1, 100) <= 0) continue;
+
+			for (ssize_t n; (n = recv(fds[0], chunk.data(), chunk.size(), 0)) > 0;)
+				pending.append(chunk.data(), n);
+
+			handle();
+		}
+	}
+
+	ReceiveResult result;
+	result.frames = received;
+	result.elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	result.latency = latency.snapshot();
+
+	stopped = true;
+	close(fds[0]);
+
+	sender.join();
+	close(fds[1]);
+
+	return result;
+}
+#endif
+
+static void printHistogram(const std::string& name, const chzzkpp::ChzzkHistogramSnapshot& snapshot)
+{
+	std::cout << std::left << std::setw(10) << name << std::right
+		<< " count " << std::setw(10) << snapshot.count
+		<< "  p50 " << std::setw(7) << snapshot.percentile(50) << "us"
+		<< "  p99 " << std::setw(7) << snapshot.percentile(99) << "us"
+		<< "  max " << std::setw(7) << snapshot.max << "us" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	//options start with --, and the others are positional
+	std::vector<std::string> args;
+	bool countAllocs = false;
+	std::string backend, corpus;
+	size_t loops = 100;
+	bool handlers = false;
+	bool receive = false;
+	size_t receiveFrames = 20000;
+	int receiveRate = 20;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--allocs") countAllocs = true;
+		else if (arg.rfind("--backend=", 0) == 0) backend = arg.substr(10);
+		else if (arg.rfind("--corpus=", 0) == 0) corpus = arg.substr(9);
+		else if (arg.rfind("--loops=", 0) == 0) loops = std::stoul(arg.substr(8));
+		else if (arg == "--handlers") handlers = true;
+		else if (arg == "--receive") receive = true;
+		else if (arg.rfind("--frames=", 0) == 0) receiveFrames = std::stoul(arg.substr(9));
+		else if (arg.rfind("--rate=", 0) == 0) receiveRate = std::stoi(arg.substr(7));
+		else args.push_back(arg);
+	}
+
+	if (handlers)
+	{
+		auto frames = loadCorpus(corpus);
+		if (frames.empty())
+		{
+			std::cerr << "no frames in " << corpus << std::endl;
+			return 1;
+		}
+
+		//per message, including the parsing of the frame
+		for (auto kind : { "string", "string+parse", "view", "typed", "shared" })
+			runHandlers(kind, frames, loops);
+
+		return 0;
+	}
+
+	if (receive)
+	{
+#ifndef _WIN32
+		auto frames = loadCorpus(corpus);
+		if (frames.empty())
+		{
+			std::cerr << "no frames in " << corpus << std::endl;
+			return 1;
+		}
+
+		for (auto loop : { ReceiveLoop::SLEEP, ReceiveLoop::POLL })
+		{
+			std::string name = loop == ReceiveLoop::SLEEP ? "sleep" : "poll";
+
+			//the sleeping loop can't keep up with the flood, so it is cut after a few seconds
+			ReceiveResult flood = runReceive(loop, frames, receiveFrames, 0, 5);
+			std::cout << name << ": received " << flood.frames << "/" << receiveFrames << " in " << std::fixed << std::setprecision(3) << flood.elapsed << "s, "
+				<< std::setprecision(0) << flood.frames / flood.elapsed << " msgs/s" << std::endl;
+
+			ReceiveResult paced = runReceive(loop, frames, (size_t)receiveRate * 5, receiveRate, 10);
+			printHistogram(name + " " + std::to_string(receiveRate) + "/s", paced.latency);
+		}
+
+		return 0;
+#else
+		std::cerr << "--receive is not supported on windows" << std::endl;
+		return 1;
+#endif
+	}
+
+	if (!backend.empty())
+	{
+		auto frames = loadCorpus(corpus);
+		if (frames.empty())
+		{
+			std::cerr << "no frames in " << corpus << std::endl;
+			return 1;
+		}
+
+		return runBackend(backend, frames, loops);
+	}
+
+	size_t chatCount = args.size() > 0 ? std::stoul(args[0]) : 4;
+	size_t messages = args.size() > 1 ? std::stoul(args[1]) : 100000;
+	std::string handler = args.size() > 2 ? args[2] : "chat";
+	bool queued = args.size() > 3 && args[3] == "queued";
+
+	const int FRAME_COUNT = 100;
+
+	chzzkpp::ChzzkMockServer server;
+
+	for (int i = 0; i < FRAME_COUNT; i++)
+		server.addFrame(makeFrame(i));
+
+	server.setReplayRate(0);
+	server.setReplayLoops((int)((messages + FRAME_COUNT - 1) / FRAME_COUNT));
+
+	size_t expected = chatCount * server.getReplayLoops() * FRAME_COUNT;
+
+	std::atomic<size_t> received(0);
+	std::atomic<size_t> characters(0); //keeps the handlers from being optimized out
+
+	std::vector<std::unique_ptr<chzzkpp::ChzzkChat>> chats;
+
+	for (size_t i = 0; i < chatCount; i++)
+	{
+		//chatChannelID and accessToken are given, so the chats connect without the api
+		chzzkpp::ChzzkChatOptions option;
+		option.chatChannelID = "N" + std::to_string(i);
+		option.accessToken = "benchmark";
+		option.pollTime = 0;
+		option.transport = &server;
+		option.trackLatency = true;
+
+		if (queued)
+		{
+			option.dispatchMode = chzzkpp::ChzzkDispatchMode::QUEUED;
+			option.overflowPolicy = chzzkpp::ChzzkOverflowPolicy::BLOCK;
+		}
+
+		auto chat = std::make_unique<chzzkpp::ChzzkChat>(nullptr, option);
+
+		if (handler == "string")
+			chat->addHandler(chzzkpp::ChzzkChatEvent::CHAT, [&](const std::string& message) { characters += message.size(); received++; });
+		else if (handler == "view")
+			chat->addViewHandler(chzzkpp::ChzzkChatEvent::CHAT, [&](const chzzkpp::ChzzkChatView& view) { characters += view.message().size(); received++; });
+		else if (handler == "shared")
+			chat->addSharedChatHandler([&](const chzzkpp::ChzzkSharedChatMessage& message) { characters += message->message.message.size(); received++; });
+		else
+			chat->addChatHandler([&](const chzzkpp::ChzzkChatMessage& message) { characters += message.message.size(); received++; });
+
+		chats.push_back(std::move(chat));
+	}
+
+	std::cout << "chats " << chatCount << ", messages " << expected << ", handler " << handler << ", " << (queued ? "queued" : "inline") << std::endl;
+
+	auto start = std::chrono::steady_clock::now();
+
+	allocations = 0;
+	countAllocations = countAllocs;
+
+	for (auto& chat : chats)
+		chat->connect();
+
+	//the replay ends after the loops, so stop waiting if nothing arrives for a while
+	size_t last = 0;
+	auto lastChange = std::chrono::steady_clock::now();
+
+	while (received < expected)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		if (received != last)
+		{
+			last = received;
+			lastChange = std::chrono::steady_clock::now();
+		}
+		else if (std::chrono::steady_clock::now() - lastChange > std::chrono::seconds(5))
+			break;
+	}
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	countAllocations = false;
+
+	std::cout << "received " << received << " in " << std::fixed << std::setprecision(3) << elapsed << "s, "
+		<< std::setprecision(0) << received / elapsed << " msgs/s" << std::endl;
+
+	//each frame has a message, so this includes the connection and the replay of the server spread over the frames
+	if (countAllocs)
+		std::cout << "heap calls " << allocations << ", " << std::setprecision(2) << (double)allocations / (received ? received.load() : 1) << " per frame" << std::endl;
+
+	//latency of every chat
+	for (size_t i = 0; i < chats.size(); i++)
+	{
+		auto stats = chats[i]->getLatencyStats();
+
+		std::cout << "chat " << i << std::endl;
+		printHistogram("dispatch", stats.dispatch);
+		printHistogram("total", stats.total);
+
+		if (stats.handlers.count(chzzkpp::ChzzkChatEvent::CHAT))
+			printHistogram("handler", stats.handlers[chzzkpp::ChzzkChatEvent::CHAT]);
+
+		if (queued)
+		{
+			auto dispatch = chats[i]->getDispatchStats();
+			std::cout << "dispatched " << dispatch.dispatched << ", dropped " << dispatch.dropped << ", failed " << dispatch.failed << std::endl;
+		}
+	}
+
+	for (auto& chat : chats)
+		chat->close();
+
+	return characters ? 0 : 1;
+}
@@ -59,13 +59,10 @@ int main()
 	{
 		chat->connect();
 
-		chat->addHandler(chzzkpp::ChzzkChatEvent::CHAT, [](auto& str) {
-			auto json = nlohmann::json::parse(str);
-
-			std::string nickname = json.find("profile") != json.end() ? json["profile"]["nickname"] : u8"͸";
-			std::string message = json["message"];
+		chat->addChatHandler([](auto& chatMessage) {
+			std::string nickname = chatMessage.profile.available ? chatMessage.profile.nickname : u8"͸";
 
-			std::cout << nickname << ": " << message << std::endl;
+			std::cout << nickname << ": " << chatMessage.message << std::endl;
 		});
 
 		std::unordered_map<std::string, chzzkpp::ChzzkMissionInfo> current_missions;
@@ -75,18 +72,13 @@ int main()
 			updateMissions(chat, current_missions);
 		});
 
-		size_t handlerID = chat->addHandler(chzzkpp::ChzzkChatEvent::DONATION, [&](auto& str) {
-			auto json = nlohmann::json::parse(str);
-
-			std::string nickname = "";
-			if (json["extras"]["isAnonymous"] == true)
-				nickname = u8"(͸ Ŀ)";
-			else nickname = json["extras"]["nickname"];
+		size_t handlerID = chat->addDonationHandler([&](auto& donation) {
+			std::string nickname = donation.isAnonymous ? u8"(͸ Ŀ)" : donation.nickname;
 
-			int amount = json["extras"]["payAmount"];
-			std::string message = json["message"];
+			int amount = donation.payAmount;
+			const std::string& message = donation.message;
 
-			std::string donationType = json["extras"]["donationType"];
+			std::string donationType = donation.donationType;
 			
 			if (donationType == chzzkpp::ChzzkDonationType::CHAT) donationType = u8"ä";
 			else if (donationType == chzzkpp::ChzzkDonationType::VIDEO) donationType = u8"";
@@ -96,24 +88,15 @@ int main()
 			else
 			{
 				//unknown
-				std::cout << json.dump(4) << std::endl;
+				std::cout << donationType << std::endl;
 			}
 
 			if (donationType == u8"ä" || donationType == u8"" || donationType == u8"̼")
 				std::cout << u8"[" << nickname << u8" " << amount << u8" " + donationType + (donationType != u8"̼" ? u8" Ŀ!] " : u8" !] ") << message << std::endl;
 		});
 
-		chat->addHandler(chzzkpp::ChzzkChatEvent::SUBSCRIPTION, [](auto& str) {
-			auto json = nlohmann::json::parse(str);
-			
-			std::string nickname = json["extras"]["nickname"];
-			int month = json["extras"]["month"];
-			std::string tierName = json["extras"]["tierName"];
-			//int tierNo = json["extras"]["tierNo"];
-
-			std::string message = json["message"];
-
-			std::cout << u8"[" << nickname << u8" " << month << u8" " << tierName << u8"!] " << message << std::endl;
+		chat->addSubscriptionHandler([](auto& subscription) {
+			std::cout << u8"[" << subscription.nickname << u8" " << subscription.month << u8" " << subscription.tierName << u8"!] " << subscription.message << std::endl;
 		});
 
 		chat->addHandler(chzzkpp::ChzzkChatEvent::NOTICE, [](auto& str) {
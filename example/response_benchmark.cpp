@@ -0,0 +1,218 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <cstdlib>
+#include <new>
+
+#include <chzzkpp/ChzzkClient.h>
+#include <chzzkpp/ChzzkUtils.h>
+#include <chzzkpp/ChzzkMockServer.h>
+#include <chzzkpp/Path.h>
+
+//decodes getTopViewerLives and searchLive responses served by ChzzkMockServer, and reports the time and the heap calls per response
+//before is the pipeline before the single pass: the body is validated and parsed separately, the content is copied out, and every element is copied into parse
+//streaming decodes the structs with ChzzkDecodeMode::STREAMING, without the json DOM
+//usage: response_benchmark [--lives=path] [--search=path] [--loops=n]
+//--lives and --search are captured response bodies, ex) curl "https://api.chzzk.naver.com/service/v1/lives?size=50" > lives.json
+//generated responses of 50 lives are used if not given
+
+#if defined(__GNUC__) && !defined(__clang__)
+//the replaced operators below are paired, but gcc warns when it sees free of a pointer from operator new
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+//heap calls of the whole process, counted only while countAllocations is set
+static std::atomic<bool> countAllocations(false);
+static std::atomic<size_t> allocations(0);
+
+void* operator new(std::size_t size)
+{
+	if (countAllocations.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+static const int LIVE_COUNT = 50;
+
+static std::string makeChannel(int index)
+{
+	return R"({"channelId":"c)" + std::to_string(index) + R"(0a1b2c3d4e5f60718293a4b5c6d7e8f9","channelName":"channel )" + std::to_string(index)
+		+ R"(","channelImageUrl":"https://nng-phinf.pstatic.net/MjAyNDAxMDFfMTAw/channel_)" + std::to_string(index) + R"(.png","verifiedMark":)" + (index % 3 ? "false" : "true")
+		+ R"(,"channelDescription":"description of the channel )" + std::to_string(index) + R"(","followerCount":)" + std::to_string(index * 1234) + R"(,"personalData":null})";
+}
+
+//fields of ChzzkLiveBase, with a few fields the structs don't have
+static std::string makeLiveFields(int index)
+{
+	return R"("liveId":)" + std::to_string(10000000 + index) + R"(,"liveTitle":"live title )" + std::to_string(index)
+		+ R"( \uBC29\uC1A1","liveImageUrl":"https://livecloud-thumb.akamaized.net/chzzk/livecloud/KR/stream/)" + std::to_string(index) + R"(/live/image_{type}.jpg","defaultThumbnailImageUrl":null,)"
+		+ R"("concurrentUserCount":)" + std::to_string(50000 / (index + 1)) + R"(,"accumulateCount":)" + std::to_string(100000 / (index + 1))
+		+ R"(,"openDate":"2024-01-01 12:00:00","adult":false,"tags":["game","talk","tag)" + std::to_string(index) + R"("],"categoryType":"GAME","liveCategory":"League_of_Legends",)"
+		+ R"("liveCategoryValue":"\uB9AC\uADF8 \uC624\uBE0C \uB808\uC804\uB4DC","chatChannelId":"N1)" + std::to_string(index) + R"(abc","watchPartyNo":null,"dropsCampaignNo":null,)"
+		+ R"("channelId":"c)" + std::to_string(index) + R"(0a1b2c3d4e5f60718293a4b5c6d7e8f9","blindType":null)";
+}
+
+static std::string makeTopViewerLives()
+{
+	std::string data;
+
+	for (int i = 0; i < LIVE_COUNT; i++)
+	{
+		if (i) data += ",";
+		data += "{" + makeLiveFields(i) + R"(,"channel":)" + makeChannel(i) + "}";
+	}
+
+	return R"({"code":200,"message":null,"content":{"size":50,"page":{"next":{"concurrentUserCount":1000,"liveId":10000049}},"data":[)" + data + "]}}";
+}
+
+static std::string makeSearchLive()
+{
+	//livePlaybackJson is a json string of the media of the live
+	std::string playback = R"({\"meta\":{\"videoId\":\"abcdef\",\"streamSeq\":1,\"liveId\":1,\"paidLive\":false,\"cdnInfo\":{\"cdnType\":\"GCDN\",\"zeroRating\":false}},)"
+		R"(\"media\":[{\"mediaId\":\"HLS\",\"protocol\":\"HLS\",\"path\":\"https://livecloud.pstatic.net/chzzk/lip2_kr/cflexnmss2u0007/abcdef/hls_playlist.m3u8\",)"
+		R"(\"encodingTrack\":[{\"encodingTrackId\":\"1080p\",\"videoBitRate\":8000000,\"audioBitRate\":192000,\"videoWidth\":1920,\"videoHeight\":1080,\"videoFrameRate\":\"60.0\"},)"
+		R"({\"encodingTrackId\":\"720p\",\"videoBitRate\":2500000,\"audioBitRate\":192000,\"videoWidth\":1280,\"videoHeight\":720,\"videoFrameRate\":\"30.0\"}]}]})";
+
+	std::string data;
+
+	for (int i = 0; i < LIVE_COUNT; i++)
+	{
+		if (i) data += ",";
+		data += R"({"live":{)" + makeLiveFields(i) + R"(,"livePlaybackJson":")" + playback + R"("},"channel":)" + makeChannel(i) + "}";
+	}
+
+	return R"({"code":200,"message":null,"content":{"size":50,"page":{"next":{"offset":50}},"data":[)" + data + "]}}";
+}
+
+static std::string readFile(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream stream;
+	stream << file.rdbuf();
+
+	return stream.str();
+}
+
+//the pipeline before the single pass
+static chzzkpp::ChzzkTopViewerResult decodeTopViewerLivesBefore(const std::string& body)
+{
+	chzzkpp::ChzzkTopViewerResult result;
+	if (!nlohmann::json::accept(body)) return result;
+
+	nlohmann::json json = nlohmann::json::parse(body);
+	nlohmann::json content = json["content"];
+
+	for (auto& element : content["data"])
+	{
+		nlohmann::json copy = element;
+		result.lives.push_back(chzzkpp::parse<chzzkpp::ChzzkLiveBase>(copy));
+	}
+
+	return result;
+}
+
+static chzzkpp::ChzzkLiveResult decodeSearchLiveBefore(const std::string& body)
+{
+	chzzkpp::ChzzkLiveResult result;
+	if (!nlohmann::json::accept(body)) return result;
+
+	nlohmann::json json = nlohmann::json::parse(body);
+	nlohmann::json content = json["content"];
+
+	for (auto& element : content["data"])
+	{
+		nlohmann::json live = element["live"];
+		nlohmann::json channel = element["channel"];
+
+		chzzkpp::ChzzkLive parsed = chzzkpp::parse<chzzkpp::ChzzkLive>(live);
+		parsed.channelInfo = chzzkpp::parse<chzzkpp::ChzzkChannelInfo>(channel);
+
+		result.lives.push_back(parsed);
+	}
+
+	return result;
+}
+
+//runs the request the times of loops, and prints the time and the heap calls per response
+//@request returns the number of decoded lives
+static void run(const std::string& name, size_t loops, const std::function<size_t()>& request)
+{
+	size_t lives = request(); //warms up the handles and the caches
+
+	allocations = 0;
+	countAllocations = true;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < loops; i++)
+		lives += request();
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	countAllocations = false;
+
+	std::cout << std::left << std::setw(28) << name << std::right << std::fixed
+		<< " lives " << std::setw(3) << lives / (loops + 1)
+		<< "  " << std::setprecision(1) << std::setw(8) << elapsed * 1e6 / loops << "us"
+		<< "  heap calls " << std::setprecision(0) << std::setw(6) << (double)allocations / loops << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	std::string livesPath, searchPath;
+	size_t loops = 1000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (arg.rfind("--lives=", 0) == 0) livesPath = arg.substr(8);
+		else if (arg.rfind("--search=", 0) == 0) searchPath = arg.substr(9);
+		else if (arg.rfind("--loops=", 0) == 0) loops = std::stoul(arg.substr(8));
+	}
+
+	std::string lives = livesPath.empty() ? makeTopViewerLives() : readFile(livesPath);
+	std::string search = searchPath.empty() ? makeSearchLive() : readFile(searchPath);
+
+	chzzkpp::ChzzkMockServer server;
+	server.setResponse(chzzkpp::CHZZK_API_PATH_PREFIX_TOP_VIEWER_LIVES, lives);
+	server.setResponse(chzzkpp::CHZZK_API_PATH_PREFIX_SEARCH_LIVE, search);
+
+	//every request goes to the server, so each response is decoded
+	chzzkpp::ChzzkCore core;
+	core.setTransport(&server);
+	core.setCacheCapacity(0);
+
+	chzzkpp::ChzzkClient client(&core);
+
+	chzzkpp::ChzzkClient streamingClient(&core);
+	streamingClient.setDecodeMode(chzzkpp::ChzzkDecodeMode::STREAMING);
+
+	std::cout << "getTopViewerLives " << lives.size() << " bytes, searchLive " << search.size() << " bytes, " << loops << " loops" << std::endl;
+
+	run("getTopViewerLives before", loops, [&]() { return decodeTopViewerLivesBefore(core.getTopViewerLives(LIVE_COUNT)).lives.size(); });
+	run("getTopViewerLives", loops, [&]() { return client.getTopViewerLives(LIVE_COUNT).lives.size(); });
+	run("getTopViewerLives streaming", loops, [&]() { return streamingClient.getTopViewerLives(LIVE_COUNT).lives.size(); });
+
+	run("searchLive before", loops, [&]() { return decodeSearchLiveBefore(core.searchLive("game", 0, LIVE_COUNT)).lives.size(); });
+	run("searchLive", loops, [&]() { return client.searchLive("game", 0, LIVE_COUNT).lives.size(); });
+	run("searchLive streaming", loops, [&]() { return streamingClient.searchLive("game", 0, LIVE_COUNT).lives.size(); });
+
+	return 0;
+}
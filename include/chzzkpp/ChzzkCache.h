@@ -0,0 +1,129 @@
+#pragma once
+#ifndef _CHZZK_CACHE_
+#define _CHZZK_CACHE_
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+
+namespace chzzkpp
+{
+	//api endpoints with their own cache ttl
+	enum class ChzzkEndpoint
+	{
+		OTHER,
+		CHANNEL,
+		LIVE_STATUS,
+		LIVE_DETAIL,
+		VIDEO,
+		TOP_VIEWER_LIVES,
+		USER,
+		ACCESS_TOKEN,
+		RECOMMENDATION_CHANNELS,
+		RECOMMENDATION_LIVES,
+		SEARCH,
+		MISSIONS,
+		CHAT_DONATION_SETTING,
+		VIDEO_DONATION_SETTING,
+		MISSION_DONATION_SETTING,
+		COUNT
+	};
+
+	struct ChzzkCacheStats
+	{
+		uint64_t hits;			//number of requests answered from the cache without network
+		uint64_t misses;		//number of requests sent to the server
+		uint64_t revalidated;	//number of misses answered by 304 Not Modified, reusing the cached response
+		uint64_t evictions;		//number of entries removed by the memory bound
+		size_t entries;			//number of cached responses
+		size_t bytes;			//approximate memory used by the cached responses
+	};
+
+	//cached response with the validators of the server
+	struct ChzzkCacheEntry
+	{
+		std::string response;
+		std::string etag;			//ETag header, sent as If-None-Match on revalidation
+		std::string lastModified;	//Last-Modified header, sent as If-Modified-Since on revalidation
+	};
+
+	//in-process LRU cache of api responses, bounded by the total size of the responses
+	//expired entries are kept until evicted, so they can be revalidated with their validators
+	//thread-safe
+	class ChzzkCache
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		enum class Lookup
+		{
+			NONE,	//not cached
+			FRESH,	//cached and not expired
+			STALE	//cached but expired. entry is filled to revalidate
+		};
+
+	private:
+		struct Node
+		{
+			std::string key;
+			ChzzkCacheEntry entry;
+			Clock::time_point expires;
+			size_t bytes;
+		};
+
+		std::list<Node> nodes;	//most recently used first
+		std::unordered_map<std::string, std::list<Node>::iterator> index;
+
+		std::mutex mutex;
+
+		size_t capacity;
+		size_t bytes;
+
+		int ttl[(size_t)ChzzkEndpoint::COUNT];
+
+		std::atomic<uint64_t> hits;
+		std::atomic<uint64_t> misses;
+		std::atomic<uint64_t> revalidated;
+		std::atomic<uint64_t> evictions;
+
+		void erase(std::list<Node>::iterator it);
+
+		//evicts the least recently used entries until the size fits. should be called with the lock
+		void shrink(size_t limit);
+
+	public:
+		//@capacity max total bytes of the cached responses. the cache is disabled if 0
+		ChzzkCache(size_t capacity = 0);
+
+		ChzzkCache(const ChzzkCache&) = delete;
+		ChzzkCache& operator=(const ChzzkCache&) = delete;
+
+		//finds the entry of the key, and copies it into entry if found
+		Lookup find(const std::string& key, ChzzkCacheEntry& entry);
+
+		//stores the response of the key, alive for ttl seconds
+		void store(const std::string& key, ChzzkCacheEntry&& entry, int ttl);
+
+		//extends the expiry of the entry after 304 Not Modified. returns false if the entry was evicted meanwhile
+		bool refresh(const std::string& key, int ttl, ChzzkCacheEntry& entry);
+
+		void clear();
+
+		//@capacity max total bytes of the cached responses. the cache is disabled if 0
+		void setCapacity(size_t capacity);
+
+		size_t getCapacity();
+
+		//@ttl seconds to keep the responses of the endpoint. responses are not cached if 0
+		void setTTL(ChzzkEndpoint endpoint, int ttl);
+
+		int getTTL(ChzzkEndpoint endpoint);
+
+		ChzzkCacheStats getStats();
+	};
+}
+
+#endif
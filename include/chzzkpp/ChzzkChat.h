@@ -9,13 +9,29 @@
 #endif
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
 #include <map>
+#include <array>
 #include <nlohmann/json.hpp>
 
 #include "ChzzkClient.h"
+#include "ChzzkChatTypes.h"
+#include "ChzzkChatView.h"
+#include "ChzzkTimer.h"
+#include "ChzzkWorker.h"
+#include "ChzzkPolling.h"
+#include "ChzzkChatHub.h"
+#include "ChzzkDispatcher.h"
+#include "ChzzkTransport.h"
+#include "ChzzkChatRecorder.h"
+#include "ChzzkLatency.h"
+#include "ChzzkHandlerList.h"
 
 namespace chzzkpp
 {
@@ -110,33 +126,80 @@ namespace chzzkpp
 		std::string chatChannelID;
 		std::string accessToken;
 		std::string channelID;
-		int pollTime;
+		int pollTime;			//milliseconds between chatChannelID polls. polling is disabled if 0
+		bool adaptivePolling;	//follows the polling period advertised in the live status, backing off on throttling and errors. pollTime is used if the server doesn't advertise it
+		ChzzkChatHub* hub;	//receives messages on the hub event loops if set, otherwise on a receiver thread of the chat
+
+		ChzzkDispatchMode dispatchMode;		//whether handlers are called on the receiver thread, or on the worker threads
+		size_t dispatchQueueSize;			//capacity of the dispatch queue with ChzzkDispatchMode::QUEUED
+		size_t dispatchWorkers;				//number of handler threads with ChzzkDispatchMode::QUEUED. handlers are called in order only if 1
+		ChzzkOverflowPolicy overflowPolicy;	//what to do when the dispatch queue is full. DROP_OLDEST never drops CONNECT, RECONNECT and DISCONNECT, and COALESCE only replaces NOTICE
+
+		bool shareConnection;	//shares dns cache and tls sessions with other connections through ChzzkShare, so reconnecting resumes the tls session
+
+		ChzzkWebSocketTransport* transport;	//opens the socket through the transport instead of libcurl if set, ex) ChzzkMockServer. hub is not used with a transport
+		ChzzkChatRecorder* recorder;		//records every received frame if set
+		bool trackLatency;					//measures the latency of the messages and the handlers for getLatencyStats. also recorded to the hub if set
 
 		const static int DEFAULT_POLL_TIME = 30 * 1000;
+		const static size_t DEFAULT_DISPATCH_QUEUE_SIZE = 4096;
 
-		ChzzkChatOptions() : chatChannelID(""), accessToken(""), channelID(""), pollTime(DEFAULT_POLL_TIME)
+		ChzzkChatOptions() : chatChannelID(""), accessToken(""), channelID(""), pollTime(DEFAULT_POLL_TIME), adaptivePolling(true), hub(nullptr),
+			dispatchMode(ChzzkDispatchMode::INLINE), dispatchQueueSize(DEFAULT_DISPATCH_QUEUE_SIZE), dispatchWorkers(1), overflowPolicy(ChzzkOverflowPolicy::BLOCK),
+			shareConnection(true), transport(nullptr), recorder(nullptr), trackLatency(false)
 		{
 		}
 	};
 
+	//message queued with ChzzkDispatchMode::QUEUED
+	struct ChzzkDispatchItem
+	{
+		ChzzkChatEvent type;
+		std::string message;					//argument of string handlers, if view is null
+		std::unique_ptr<ChzzkChatView> view;	//view of chat messages
+		ChzzkLatencyTracker::Clock::time_point received;	//when the frame was received, with ChzzkChatOptions::trackLatency
+	};
+
 
 	//TODO: not sure about multithread safety
 	class ChzzkChat
 	{
 #if _USE_CURL
 		CURL* curl;
+		std::atomic<curl_socket_t> activeSocket;
 		std::thread receiverThread;
-		std::mutex receiverMutex;
+		std::mutex socketMutex;	//guards the handle. it can't be used by the receiver and the senders at once
+
+		//frames are received into a reusable buffer, and passed to onMessage without copying
+		std::vector<char> receiveBuffer;
+		size_t receiveSize;		//bytes used in receiveBuffer
+		size_t frameStart;		//offset of the frame being received
+		std::vector<std::pair<size_t, size_t>> receivedFrames;	//offset and length of the frames received on a wakeup
+
+		//minimum free space of receiveBuffer on each read
+		static const size_t RECEIVE_CHUNK_SIZE = 4096;
+
+		//max milliseconds to block waiting for the socket, before checking the connection state again
+		static constexpr int RECEIVE_WAIT_TIME = 500;
 		
 		//message receive loop for libcurl
 		//if you are implementing with other websocket libraries, you would not have to implement this function if the library supports async callback or is already multi-threaded
 		void _receive();
+
+		//receives every frame available on the socket without blocking, and handles them
+		//returns the number of received frames
+		size_t _drain();
+
+		//makes a websocket handle and connects it to ws_path
+		//@handle the new handle if connected, otherwise null
+		CURLcode _open(CURL*& handle);
+
+		friend class ChzzkChatHub;
 #endif
 
 		//// library specific functions
 		////
 
-		void _reopen();
 		void _connect();
 		void _close();
 		void _send(const std::string& message);
@@ -144,15 +207,37 @@ namespace chzzkpp
 		////
 		////
 
+		//socket opened by option.transport
+		std::unique_ptr<ChzzkWebSocket> socket;
+
+		//opens the socket with option.transport, handling the messages on the thread of the transport
+		std::unique_ptr<ChzzkWebSocket> openSocket();
+
+		//queues a reconnect for the socket lost by the transport
+		void onSocketError(const std::string& error);
+
 
 		ChzzkClient* client;
 		ChzzkChatOptions option;
 		int timeout;
+		std::atomic<long long> connectTime;	//microseconds taken by the last connect
 		std::string sid;
 		std::string uid;
 
-		//is there good alternative container type for this?
-		std::map<ChzzkChatEvent, std::map<size_t, std::function<void(const std::string&)>>> handlers;
+		static const size_t EVENT_COUNT = (size_t)ChzzkChatEvent::EVENT + 1;
+
+		//handlers indexed by ChzzkChatEvent. they are called from snapshots, so the receiver never waits for adding or removing handlers
+		std::array<ChzzkHandlerList<const std::string&>, EVENT_COUNT> handlers;
+		std::array<ChzzkHandlerList<const ChzzkChatView&>, EVENT_COUNT> viewHandlers;
+		ChzzkHandlerList<const ChzzkChatMessage&> chatHandlers;
+		ChzzkHandlerList<const ChzzkDonationMessage&> donationHandlers;
+		ChzzkHandlerList<const ChzzkSubscriptionMessage&> subscriptionHandlers;
+		std::array<ChzzkHandlerList<const std::shared_ptr<const std::string>&>, EVENT_COUNT> sharedHandlers;
+		ChzzkHandlerList<const ChzzkSharedChatMessage&> sharedChatHandlers;
+		ChzzkHandlerList<const ChzzkSharedDonationMessage&> sharedDonationHandlers;
+		ChzzkHandlerList<const ChzzkSharedSubscriptionMessage&> sharedSubscriptionHandlers;
+		std::mutex handlerMutex;	//only serializes adding and removing handlers
+		std::atomic<size_t> nextHandlerID;
 
 		static const int PING_TIME = 20 * 1000;
 
@@ -161,20 +246,70 @@ namespace chzzkpp
 
 		std::string ws_path;
 		nlohmann::json _default;
-		bool reconnecting;
+		std::mutex sessionMutex;	//guards sid, uid and _default, which the senders read while the worker reconnects
+		std::atomic<bool> reconnecting;
+
+		//ping and chatChannelID polling run on the shared timer, instead of threads per chat
+		ChzzkTimer* timer;
+		std::atomic<size_t> pollTimerID;
+		std::atomic<size_t> pingTimerID;
+		ChzzkPollSchedule pollSchedule;	//used only by the queued poll after polling starts
+
+		//polls and reconnects block on requests, so the timer only queues them on the shared worker
+		ChzzkWorker* worker;
+		std::atomic<bool> pollQueued;	//whether a poll is queued or running on the worker
+
+		//tasks of this chat on the worker, waited for before destruction
+		std::mutex taskMutex;
+		std::condition_variable taskFinished;
+		size_t pendingTasks;
 
-		bool isPolling;
-		std::thread chatChannelIDThread;
+		//serializes connecting, closing and reconnecting, which can happen on user threads and the worker at once
+		//never locked by the timer, the receiver or the hub loops
+		std::mutex stateMutex;
 
-		bool isPinging;
-		std::thread pingTimerThread;
+		//runs the task on the worker
+		void post(const std::function<void()>& task);
+		void waitTasks();
+
+		//called by the poll timer. a poll is not queued again until the last one finishes
+		void queuePoll();
+
+		//connects with stateMutex locked
+		void connectChat();
+
+		//stops the ping, and the polling unless reconnecting. socketMutex should not be locked
+		void stopTimers();
 
-		nlohmann::json parseChat(const nlohmann::json& json, bool isRecent = false);
 		void onOpen();
-		void onMessage(const std::string& message);
+		//@record whether to write the frame to option.recorder
+		void onMessage(std::string_view message, bool record = true);
+
+		//pool of the chats read from the frames, and the simdjson parser. defined in ChzzkChat.cpp
+		struct FastParser;
+		std::unique_ptr<FastParser> fastParser;
+
+		//handles chat frames (CHAT, RECENT_CHAT, DONATION) without json DOM, reading only the fields of the views into the pool
+		//uses simdjson on-demand parser with _USE_SIMDJSON, or nlohmann::json sax parser
+		//returns false without side effects for other frames or unexpected json, which are handled by onMessage
+		bool onMessageFast(std::string_view message);
+
+		//calls the handlers with the chats read by onMessageFast
+		void callFast(bool isRecent);
 		void onClose();
 
+		//closes and connects again with stateMutex locked. reports DISCONNECT if connecting fails
 		void reconnect();
+
+		//incremented on each connect, so a queued reconnect is dropped if the chat was closed or reconnected meanwhile
+		std::atomic<uint64_t> connectionID;
+
+		//gives up after the socket is lost this many times in a row before the chat connects
+		static const int MAX_REOPEN_ATTEMPTS = 3;
+		std::atomic<int> reopenAttempts;
+
+		//reconnects on the worker after the socket is lost. the receiver and the hub loops never reconnect themselves
+		void queueReconnect();
 		void updateChatChannelID();
 		void startPolling();
 		void stopPolling();
@@ -182,7 +317,33 @@ namespace chzzkpp
 		void startPing();
 		void stopPing();
 
-		void call(ChzzkChatEvent type, const std::string& message);
+		//handlers are called through the dispatcher with ChzzkDispatchMode::QUEUED
+		std::unique_ptr<ChzzkDispatcher<ChzzkDispatchItem>> dispatcher;
+
+		//calls handlers now, or queues the message, depending on dispatch mode
+		void dispatch(ChzzkChatEvent type, const std::string& message);
+
+		//makes the view with args of ChzzkChatView constructor
+		template <typename... Args>
+		void dispatchChat(ChzzkChatEvent type, Args&&... args);
+
+		//made with ChzzkChatOptions::trackLatency
+		std::unique_ptr<ChzzkLatencyTracker> latency;
+
+		//when the frame being handled on the receiver was received
+		ChzzkLatencyTracker::Clock::time_point receivedAt;
+		unsigned long long receivedTime;	//UNIX timestamp milliseconds
+
+		//records the latency to the tracker of the chat and the hub. latency should not be null
+		void measureServer(const ChzzkChatView& view);
+		void measureHandlers(ChzzkChatEvent type, ChzzkLatencyTracker::Clock::time_point received, ChzzkLatencyTracker::Clock::time_point start);
+
+		//@received when the frame of the message was received. used to measure the latency
+		void call(ChzzkChatEvent type, const std::string& message, ChzzkLatencyTracker::Clock::time_point received);
+
+		//calls view handlers with the view, string handlers with the dumped json, and typed handlers with the struct made from the view
+		//nested json in the message is parsed only if some handler needs it. the json and the struct are made once for every handler
+		void callChat(ChzzkChatEvent type, const ChzzkChatView& view, ChzzkLatencyTracker::Clock::time_point received);
 
 	public:
 		//@timeout connection timeout seconds. never times out if value is 0
@@ -197,14 +358,62 @@ namespace chzzkpp
 		int getConnectionTimeout() const;
 
 		size_t addHandler(ChzzkChatEvent type, const std::function<void(const std::string&)>& func);
+
+		//adds a handler receiving the lazy view of the message. nested json is parsed only when accessed
+		//available for NOTICE, CHAT, DONATION, SUBSCRIPTION, SYSTEM_MESSAGE. remove it with removeHandler(type, id)
+		size_t addViewHandler(ChzzkChatEvent type, const std::function<void(const ChzzkChatView&)>& func);
+
+		//adds a handler receiving parsed struct. same as ChzzkChatEvent::CHAT handler, but no json parsing is needed
+		//remove it with removeHandler(ChzzkChatEvent::CHAT, id)
+		size_t addChatHandler(const std::function<void(const ChzzkChatMessage&)>& func);
+
+		//adds a handler receiving parsed struct. same as ChzzkChatEvent::DONATION handler, but no json parsing is needed
+		//remove it with removeHandler(ChzzkChatEvent::DONATION, id)
+		size_t addDonationHandler(const std::function<void(const ChzzkDonationMessage&)>& func);
+
+		//adds a handler receiving parsed struct. same as ChzzkChatEvent::SUBSCRIPTION handler, but no json parsing is needed
+		//remove it with removeHandler(ChzzkChatEvent::SUBSCRIPTION, id)
+		size_t addSubscriptionHandler(const std::function<void(const ChzzkSubscriptionMessage&)>& func);
+
+		//adds a handler receiving the message as an immutable shared string. same as addHandler, but the string can be kept or passed to other threads without copying
+		//the string is allocated once and shared by every shared handler of the message. remove it with removeHandler(type, id)
+		size_t addSharedHandler(ChzzkChatEvent type, const std::function<void(const std::shared_ptr<const std::string>&)>& func);
+
+		//adds a handler receiving the parsed struct and the json of the message together, shared by every shared handler of the message
+		//keep the pointer to use the message later or on other threads. remove it with removeHandler(ChzzkChatEvent::CHAT, id)
+		size_t addSharedChatHandler(const std::function<void(const ChzzkSharedChatMessage&)>& func);
+
+		//remove it with removeHandler(ChzzkChatEvent::DONATION, id)
+		size_t addSharedDonationHandler(const std::function<void(const ChzzkSharedDonationMessage&)>& func);
+
+		//remove it with removeHandler(ChzzkChatEvent::SUBSCRIPTION, id)
+		size_t addSharedSubscriptionHandler(const std::function<void(const ChzzkSharedSubscriptionMessage&)>& func);
+
+		//a call of the handler already running on another thread may finish after this returns
 		void removeHandler(ChzzkChatEvent type, size_t id);
 		void removeHandlers(ChzzkChatEvent type);
 		void removeAllHandlers();
 
+		//handles the frame as if it was received from the socket, calling the handlers. ex) frames replayed by ChzzkChatReplayer
+		//the frame is not recorded. throws if the chat is connected, since the frames of the receiver share the parser state
+		//feed and connect should not be called at once
+		void feed(std::string_view message);
+
 		void requestRecentChat(int size = 50);
 		//TODO: sendChat NOT tested yet!!
 		void sendChat(const std::string& message, const std::map<std::string, std::string>& emojis = {});
 
+		//queue depth and counters of the dispatch queue. all zero with ChzzkDispatchMode::INLINE
+		ChzzkDispatchStats getDispatchStats() const;
+
+		//latency of the messages through receiving, dispatching and the handlers. empty without ChzzkChatOptions::trackLatency
+		ChzzkLatencyStats getLatencyStats() const;
+
+		void resetLatencyStats();
+
+		//microseconds taken by the last connect or reconnect of the socket, including dns lookup and tls handshake
+		long long getLastConnectTime() const;
+
 		ChzzkChatOptions& getCurrentChatOptions();
 
 		const ChzzkChatOptions& getCurrentChatOptions() const;
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef _CHZZK_CHAT_HUB_
+#define _CHZZK_CHAT_HUB_
+
+#include "Config.h"
+#include "ChzzkLatency.h"
+
+#if _USE_CURL
+#include <curl/curl.h>
+#endif
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace chzzkpp
+{
+	class ChzzkChat;
+
+	//metrics of one event loop in the hub
+	struct ChzzkChatHubMetrics
+	{
+		size_t connections;		//number of chats attached to the loop
+		uint64_t wakeups;		//number of times the loop woke up from waiting sockets
+		uint64_t readyEvents;	//number of readable sockets over all wakeups
+		uint64_t frames;		//number of received websocket frames
+	};
+
+	//receives messages of many chats with a small fixed number of event loop threads, instead of a receiver thread per chat
+	//set ChzzkChatOptions::hub to use it. ping and polling of the chats already run on the shared ChzzkTimer
+	//close every chat attached to the hub before destroying the hub
+	class ChzzkChatHub
+	{
+		struct Loop
+		{
+			std::thread thread;
+			std::mutex mutex;
+			std::condition_variable finished;
+
+			ChzzkChat* current;	//chat being received on the loop thread
+
+#if _USE_CURL
+			//socket of each chat in the waiting set. CURL_SOCKET_BAD after the socket is lost, until the chat detaches
+			std::unordered_map<ChzzkChat*, curl_socket_t> chats;
+
+#ifdef __linux__
+			int poller;			//epoll instance. sockets are added and removed only when chats change
+			int wakeup;			//eventfd waking up the loop
+#else
+			CURLM* multi;		//only used for waiting sockets and waking up the loop
+			std::vector<curl_waitfd> fds;		//waiting set, rebuilt from chats only after they change
+			std::vector<ChzzkChat*> owners;
+			std::atomic<bool> changed;
+#endif
+#endif
+
+			std::atomic<uint64_t> wakeups;
+			std::atomic<uint64_t> readyEvents;
+			std::atomic<uint64_t> frames;
+		};
+
+		std::vector<std::unique_ptr<Loop>> loops;
+		std::atomic<bool> running;
+
+		//latency of the attached chats which track it
+		ChzzkLatencyTracker latency;
+
+		//max milliseconds to block waiting for sockets, if there is no change in chats
+		static const int WAIT_TIME = 1000;
+
+		//max ready sockets handled for one wakeup
+		static const int MAX_EVENTS = 64;
+
+#if _USE_CURL
+		void run(Loop& loop);
+
+		//adds and removes the socket in the waiting set of the loop. the loop mutex should be locked
+		void watch(Loop& loop, ChzzkChat* chat, curl_socket_t socket);
+		void unwatch(Loop& loop, ChzzkChat* chat, curl_socket_t socket);
+
+		void wake(Loop& loop);
+
+		//waits for the sockets of the loop, and returns false on error
+		bool wait(Loop& loop, std::vector<ChzzkChat*>& ready);
+#endif
+
+		friend class ChzzkChat;
+
+#if _USE_CURL
+		void attach(ChzzkChat* chat);
+#endif
+		void detach(ChzzkChat* chat);
+
+	public:
+		//@threadCount number of event loop threads
+		ChzzkChatHub(size_t threadCount = 1);
+		~ChzzkChatHub();
+
+		ChzzkChatHub(const ChzzkChatHub&) = delete;
+		ChzzkChatHub& operator=(const ChzzkChatHub&) = delete;
+
+		size_t getLoopCount() const;
+
+		ChzzkChatHubMetrics getMetrics(size_t loop) const;
+
+		//metrics of every loop
+		std::vector<ChzzkChatHubMetrics> getMetrics() const;
+
+		//latency of the messages of every chat with ChzzkChatOptions::trackLatency on the hub
+		ChzzkLatencyStats getLatencyStats() const;
+
+		void resetLatencyStats();
+	};
+}
+
+#endif
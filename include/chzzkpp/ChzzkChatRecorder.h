@@ -0,0 +1,145 @@
+#pragma once
+#ifndef _CHZZK_CHAT_RECORDER_
+#define _CHZZK_CHAT_RECORDER_
+
+#include "Config.h"
+#include "ChzzkTimer.h"
+#include "ChzzkWorker.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace chzzkpp
+{
+	class ChzzkChat;
+
+	struct ChzzkRecorderOptions
+	{
+		size_t segmentSize;	//bytes of a segment file before the next segment is started
+		size_t blockSize;	//bytes of frames buffered and written together
+		int flushTime;		//milliseconds until buffered frames are written. only written when the block is full if 0
+		bool compress;		//compresses the blocks with zlib. needs _USE_ZLIB
+
+		const static size_t DEFAULT_SEGMENT_SIZE = 64 * 1024 * 1024;
+		const static size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+		const static int DEFAULT_FLUSH_TIME = 1000;
+
+		ChzzkRecorderOptions() : segmentSize(DEFAULT_SEGMENT_SIZE), blockSize(DEFAULT_BLOCK_SIZE), flushTime(DEFAULT_FLUSH_TIME), compress(false)
+		{
+		}
+	};
+
+	//append-only log of raw chat frames with the receive time. set ChzzkChatOptions::recorder to record a chat
+	//the log is split into segment files named path.000000, path.000001, ... and new segments never overwrite the old ones
+	//segment: "CHZZKLOG" and u32 version, followed by blocks
+	//block: u32 stored size, u32 raw size, u32 flags (1 if compressed), and the stored bytes
+	//frame in a raw block: u64 receive time (microseconds since epoch), u32 length, and the frame
+	//every integer is little endian. a block cut by a crash is ignored by the replayer
+	//thread-safe. many chats can share a recorder
+	class ChzzkChatRecorder
+	{
+		std::string path;
+		ChzzkRecorderOptions options;
+
+		//the file is written on the worker, so the receive threads only append to the block
+		std::ofstream file;
+		size_t segmentIndex;	//index of the next segment to open
+		size_t segmentBytes;	//bytes written to the open segment
+		std::string compressed;
+		std::mutex fileMutex;	//guards the file and the segment
+
+		std::string block;				//frames not sealed yet
+		std::deque<std::string> pending;	//sealed blocks waiting to be written, in order
+		std::string spare;				//buffer of the last written block, reused by the next block
+		std::mutex mutex;				//guards the blocks
+
+		ChzzkTimer* timer;
+		size_t flushTimerID;
+
+		ChzzkWorker* worker;
+		bool writing;					//whether a write task is queued on the worker. guarded by mutex
+		std::condition_variable written;
+
+		std::atomic<uint64_t> frames;
+		std::atomic<uint64_t> writtenBytes;
+
+		//moves the block to pending. mutex should be locked
+		void sealBlock();
+
+		//writes the pending blocks on the worker. mutex should be locked
+		void queueWrite();
+
+		//writes the pending blocks in order. a block stays pending until it is written
+		void writePending();
+
+		//throws if the file failed. fileMutex should be locked
+		void writeBlock(const std::string& raw);
+
+		void openSegment();
+
+	public:
+		//@path path of the log. segments are written next to it with the index as the extension
+		ChzzkChatRecorder(const std::string& path, ChzzkRecorderOptions options = ChzzkRecorderOptions());
+
+		//writes the buffered frames, waiting for the worker
+		~ChzzkChatRecorder();
+
+		ChzzkChatRecorder(const ChzzkChatRecorder&) = delete;
+		ChzzkChatRecorder& operator=(const ChzzkChatRecorder&) = delete;
+
+		//records the frame received now
+		void write(std::string_view frame);
+
+		//@time microseconds since epoch when the frame was received
+		void write(std::string_view frame, uint64_t time);
+
+		//writes the buffered frames to the file on the calling thread
+		void flush();
+
+		//number of recorded frames
+		uint64_t getFrameCount() const;
+
+		//bytes written to the segments, after compression
+		uint64_t getWrittenBytes() const;
+
+		//path of the segment. ex) chat.log.000001
+		static std::string getSegmentPath(const std::string& path, size_t index);
+	};
+
+	//reads the segments of ChzzkChatRecorder with memory mapping, and replays the frames in order
+	class ChzzkChatReplayer
+	{
+		std::vector<std::string> segments;
+		std::atomic<bool> stopped;
+
+	public:
+		//finds the segments of the log, from path.000000 until a missing index
+		ChzzkChatReplayer(const std::string& path);
+
+		ChzzkChatReplayer(const ChzzkChatReplayer&) = delete;
+		ChzzkChatReplayer& operator=(const ChzzkChatReplayer&) = delete;
+
+		const std::vector<std::string>& getSegments() const;
+
+		//calls the callback with each frame and its receive time, on the calling thread
+		//frames are valid only during the callback. returns the number of replayed frames
+		//@speed 1 replays at the recorded pace, 2 twice as fast. as fast as possible if 0
+		size_t replay(const std::function<void(uint64_t time, std::string_view frame)>& callback, double speed = 0);
+
+		//handles the frames with ChzzkChat::feed, calling the handlers of the chat. the chat should not be connected
+		size_t replay(ChzzkChat& chat, double speed = 0);
+
+		//stops the running replay after the current frame. called from another thread or the callback
+		void stop();
+	};
+}
+
+#endif
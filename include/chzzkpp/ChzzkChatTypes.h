@@ -0,0 +1,128 @@
+#pragma once
+#ifndef _CHZZK_CHAT_TYPES_
+#define _CHZZK_CHAT_TYPES_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+
+#include "ChzzkFields.h"
+
+namespace chzzkpp
+{
+	//parsed chzzk chat message structures
+
+	//profile of the user who sent the message
+	struct ChzzkChatProfile
+	{
+		bool available;					//whether profile is available. false when data missing, ex) anonymous donation
+		std::string userIDHash;			//user id hash
+		std::string nickname;			//user nickname
+		std::string profileImageURL;	//url of the user profile image
+		std::string userRoleCode;		//user role. ex) common_user, streamer, streaming_chat_manager
+		std::string badgeImageURL;		//url of the user badge image. empty if the user has no badge
+		std::string titleName;			//user title name. ex) manager. empty if the user has no title
+		std::string titleColor;			//user title color
+		bool verified;					//whether the user is verified
+		int subscriptionMonth;			//accumulated subscription months on the channel. 0 if the user is not subscribing
+		int subscriptionTier;			//subscription tier on the channel. 0 if the user is not subscribing
+	};
+
+	//chat message. delivered with ChzzkChatEvent::CHAT
+	struct ChzzkChatMessage
+	{
+		ChzzkChatProfile profile;					//profile of the user
+		std::string message;						//message content
+		unsigned long long time;					//message time as UNIX timestamp milliseconds
+		int memberCount;							//the number of users in the chat. 0 if not sent
+		bool hidden;								//whether the message is hidden
+		bool isRecent;								//whether the message is from the recent chat request
+		std::string osType;							//os type of the sender. ex) PC, AOS, IOS
+		std::map<std::string, std::string> emojis;	//emoji id and image url used in the message
+	};
+
+	//donation message. delivered with ChzzkChatEvent::DONATION
+	struct ChzzkDonationMessage : public ChzzkChatMessage
+	{
+		bool isAnonymous;				//whether the donator is anonymous
+		std::string nickname;			//nickname of the donator. empty if anonymous
+		std::string payType;			//pay type. ex) CURRENCY
+		int payAmount;					//pay amount
+		std::string donationType;		//donation type. check out ChzzkDonationType
+		std::string missionDonationID;	//mission donation id, if donation type is about mission
+		std::string missionText;		//mission text, if donation type is about mission
+	};
+
+	//subscription message. delivered with ChzzkChatEvent::SUBSCRIPTION
+	struct ChzzkSubscriptionMessage : public ChzzkChatMessage
+	{
+		std::string nickname;	//nickname of the subscriber
+		int month;				//subscription months
+		std::string tierName;	//subscription tier name
+		int tierNo;				//subscription tier number
+	};
+
+	//parsed message and its json, made once and shared by every shared handler of the message
+	//immutable, so it can be kept or passed to other threads without copying
+	template <typename T>
+	struct ChzzkSharedMessage
+	{
+		T message;			//parsed struct
+		std::string raw;	//json of the message. same as the argument of string handlers
+							//serialized again from the parsed message, so the key order and escapes can differ from the frame
+	};
+
+	typedef std::shared_ptr<const ChzzkSharedMessage<ChzzkChatMessage>> ChzzkSharedChatMessage;
+	typedef std::shared_ptr<const ChzzkSharedMessage<ChzzkDonationMessage>> ChzzkSharedDonationMessage;
+	typedef std::shared_ptr<const ChzzkSharedMessage<ChzzkSubscriptionMessage>> ChzzkSharedSubscriptionMessage;
+
+	//field tables of the structs, used by the decoders and the serializer
+
+	template <>
+	struct ChzzkFields<ChzzkChatProfile>
+	{
+		//fields in the badge object
+		static constexpr ChzzkField badgeFields[] = {
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::badgeImageURL>("imageUrl")
+		};
+
+		static constexpr ChzzkFieldTable badgeTable = chzzk_table(badgeFields);
+
+		//fields in the title object
+		static constexpr ChzzkField titleFields[] = {
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::titleName>("name"),
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::titleColor>("color")
+		};
+
+		static constexpr ChzzkFieldTable titleTable = chzzk_table(titleFields);
+
+		//fields in the subscription object of streamingProperty
+		static constexpr ChzzkField subscriptionFields[] = {
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::subscriptionMonth>("accumulativeMonth"),
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::subscriptionTier>("tier")
+		};
+
+		static constexpr ChzzkFieldTable subscriptionTable = chzzk_table(subscriptionFields);
+
+		static constexpr ChzzkField streamingPropertyFields[] = {
+			chzzk_inline_field("subscription", subscriptionTable)
+		};
+
+		static constexpr ChzzkFieldTable streamingPropertyTable = chzzk_table(streamingPropertyFields);
+
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::userIDHash>("userIdHash"),
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::nickname>("nickname"),
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::profileImageURL>("profileImageUrl"),
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::userRoleCode>("userRoleCode"),
+			chzzk_field<ChzzkChatProfile, &ChzzkChatProfile::verified>("verifiedMark"),
+			chzzk_inline_field("badge", badgeTable),
+			chzzk_inline_field("title", titleTable),
+			chzzk_inline_field("streamingProperty", streamingPropertyTable)
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table<ChzzkChatProfile, &ChzzkChatProfile::available>(fields);
+	};
+}
+#endif
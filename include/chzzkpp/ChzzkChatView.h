@@ -0,0 +1,95 @@
+#pragma once
+#ifndef _CHZZK_CHAT_VIEW_
+#define _CHZZK_CHAT_VIEW_
+
+#include <string>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+namespace chzzkpp
+{
+	//lazy view of a chat message
+	//keeps nested json (profile, extras, chat profiles in extras params) as raw strings, and parses each of them only when accessed for the first time
+	//parsed results are cached. accessors are safe to call from multiple threads
+	class ChzzkChatView
+	{
+		std::string _message;
+		unsigned long long _time;
+		int _memberCount;
+		bool _hidden;
+		bool _isRecent;
+
+		std::string _rawProfile;
+		std::string _rawExtras;
+
+		mutable std::once_flag profileFlag;
+		mutable std::once_flag extrasFlag;
+		mutable std::once_flag registerChatProfileFlag;
+		mutable std::once_flag targetChatProfileFlag;
+
+		mutable nlohmann::json _profile;
+		mutable nlohmann::json _extras;
+		mutable nlohmann::json _registerChatProfile;
+		mutable nlohmann::json _targetChatProfile;
+
+		const nlohmann::json& paramsProfile(std::once_flag& flag, nlohmann::json& dest, const char* key) const;
+
+		//moves the strings given to the constructor back, so their buffers can be reused for the next message
+		//the view is left empty
+		void release(std::string& message, std::string& rawProfile, std::string& rawExtras);
+
+		friend class ChzzkChat;
+
+	public:
+		ChzzkChatView();
+
+		//takes the message out of a chat json in the frame. nested json strings are moved, not parsed
+		ChzzkChatView(nlohmann::json& json, bool isRecent = false);
+
+		//takes the fields already read from a chat json. used by the fast parsers of chat frames
+		ChzzkChatView(std::string&& message, std::string&& rawProfile, std::string&& rawExtras, unsigned long long time, int memberCount, bool hidden, bool isRecent = false);
+
+		ChzzkChatView(const ChzzkChatView&) = delete;
+		ChzzkChatView& operator=(const ChzzkChatView&) = delete;
+
+		const std::string& message() const;
+
+		//message time as UNIX timestamp milliseconds
+		unsigned long long time() const;
+
+		//the number of users in the chat. 0 if not sent
+		int memberCount() const;
+
+		bool hidden() const;
+
+		//whether the message is from the recent chat request
+		bool isRecent() const;
+
+		//raw json strings. no parsing is needed
+		const std::string& rawProfile() const;
+		const std::string& rawExtras() const;
+
+		//parsed profile json. null if the message has no profile
+		const nlohmann::json& profile() const;
+
+		//parsed extras json. null if the message has no extras
+		const nlohmann::json& extras() const;
+
+		//parsed registerChatProfileJson in extras params. null if not exists
+		const nlohmann::json& registerChatProfile() const;
+
+		//parsed targetChatProfileJson in extras params. null if not exists
+		const nlohmann::json& targetChatProfile() const;
+
+		//profile nickname. empty if the message has no profile
+		std::string nickname() const;
+
+		//extras payAmount. 0 if not exists
+		int payAmount() const;
+
+		//makes the json which string handlers receive. parses every nested json
+		nlohmann::json toJson() const;
+	};
+}
+
+#endif
@@ -8,18 +8,64 @@
 
 #include <nlohmann/json.hpp>
 
+#include <future>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+
 namespace chzzkpp
 {
+	//how api responses are decoded
+	enum class ChzzkDecodeMode
+	{
+		DOM,		//parses the response into nlohmann::json, and reads the structs from it. default
+		STREAMING	//fills the structs straight from the json tokens with the field tables. used by list endpoints. uses simdjson with _USE_SIMDJSON
+	};
+
 	//parse and process api raw json data from core
 	class ChzzkClient
 	{
 		ChzzkCore* core;
+		ChzzkDecodeMode decodeMode;
+
+		std::vector<std::future<void>> batches;	//running batch requests with futures
+		std::mutex batchMutex;
+
+		std::unordered_map<std::string, std::shared_ptr<void>> flights;	//shared futures of the running requests by key
+		std::mutex flightMutex;
+		std::atomic<uint64_t> coalesced;
 
+		//throws if the data is not json or the code is not 200
 		nlohmann::json getContent(const std::string& data);
 
+		//decodes the content of the response with the table, without building a json DOM
+		template <typename T>
+		T streamContent(const std::string& data, const ChzzkFieldTable& table);
+
+		template <typename T>
+		void requestBatch(const std::vector<std::string>& paths, const std::function<void(size_t, std::future<T>)>& callback, size_t maxInFlight);
+
+		template <typename T>
+		std::vector<std::future<T>> requestBatchAsync(const std::vector<std::string>& paths, size_t maxInFlight);
+
+		//single-flight. if a request of the same key is running, waits for it and shares its result instead of calling func
+		//key should begin with the method name, since it decides the type of the shared result
+		//requests of different auth are never shared, like the response cache of ChzzkCore
+		template <typename T, typename F>
+		T singleFlight(const std::string& name, F&& func);
+
 	public:
 		ChzzkClient(ChzzkCore* core);
 
+		//waits for the running batch requests
+		~ChzzkClient();
+
+		//concurrent calls of the same single item getter with the same arguments share one request and its parsed result
+		//(getChannel, getLiveStatus, getLiveDetail, getVideo, getUserData, getAccessToken, and donation settings)
+
 		ChzzkChannel getChannel(const std::string& channelID);
 
 		ChzzkLiveStatus getLiveStatus(const std::string& channelID);
@@ -28,6 +74,22 @@ namespace chzzkpp
 
 		ChzzkVideo getVideo(int videoNo);
 
+		//batch requests run concurrently, keeping at most maxInFlight requests at once
+		//future versions return immediately. each future has the result, or the exception thrown while getting it
+		//callback versions block until every request is done. callback is called in the order of completion, with the index of the channel id
+
+		std::vector<std::future<ChzzkChannel>> getChannelBatch(const std::vector<std::string>& channelIDs, size_t maxInFlight = ChzzkCore::DEFAULT_BATCH_CONCURRENCY);
+
+		void getChannelBatch(const std::vector<std::string>& channelIDs, const std::function<void(size_t, std::future<ChzzkChannel>)>& callback, size_t maxInFlight = ChzzkCore::DEFAULT_BATCH_CONCURRENCY);
+
+		std::vector<std::future<ChzzkLiveStatus>> getLiveStatusBatch(const std::vector<std::string>& channelIDs, size_t maxInFlight = ChzzkCore::DEFAULT_BATCH_CONCURRENCY);
+
+		void getLiveStatusBatch(const std::vector<std::string>& channelIDs, const std::function<void(size_t, std::future<ChzzkLiveStatus>)>& callback, size_t maxInFlight = ChzzkCore::DEFAULT_BATCH_CONCURRENCY);
+
+		std::vector<std::future<ChzzkLiveDetail>> getLiveDetailBatch(const std::vector<std::string>& channelIDs, size_t maxInFlight = ChzzkCore::DEFAULT_BATCH_CONCURRENCY);
+
+		void getLiveDetailBatch(const std::vector<std::string>& channelIDs, const std::function<void(size_t, std::future<ChzzkLiveDetail>)>& callback, size_t maxInFlight = ChzzkCore::DEFAULT_BATCH_CONCURRENCY);
+
 		//gets live list in viewers count order
 		ChzzkTopViewerResult getTopViewerLives(int size = 30);
 
@@ -64,7 +126,15 @@ namespace chzzkpp
 		ChzzkMissionDonationSetting getMissionDonationSetting(const std::string& channelID);
 
 
+		//@mode decode mode of list endpoints (getTopViewerLives, getRecommendationLives, searchChannel, searchLive, searchVideo, getMissions)
+		void setDecodeMode(ChzzkDecodeMode mode);
+
+		ChzzkDecodeMode getDecodeMode() const;
+
 		ChzzkCore* getCore();
+
+		//number of requests which shared the result of the same running request, instead of sending their own
+		uint64_t getCoalescedCount() const;
 	};
 }
 #endif
\ No newline at end of file
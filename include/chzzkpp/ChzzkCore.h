@@ -4,8 +4,15 @@
 #define _CHZZK_CORE_
 
 #include "Config.h"
+#include "ChzzkCache.h"
+#include "ChzzkRateLimit.h"
+#include "ChzzkTransport.h"
 
 #include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
 
 #if _USE_CURL
 #include <curl/curl.h>
@@ -19,27 +26,96 @@ namespace chzzkpp
 	size_t curl_write_string_callback(void* contents, size_t size, size_t nmemb, std::string* s);
 #endif
 	
+	//called when each request in a batch is done
+	//@index index of the path in the batch
+	//@response raw response, or the error string if failed
+	//@failed whether the request failed without a response, after the retries
+	typedef std::function<void(size_t index, std::string& response, bool failed)> ChzzkBatchCallback;
+
+	struct ChzzkCorePoolStats
+	{
+		uint64_t hits;		//number of requests which reused an idle handle
+		uint64_t misses;	//number of requests which created a new handle
+		size_t idle;		//number of idle handles in the pool
+	};
+
 	//core on Chzzk APi using libcurl
 	//initializes curl and gets raw string data from api
+	//requests are thread-safe. each request takes a handle from the pool, so connections are kept alive between requests
 	class ChzzkCore
 	{
 #if _USE_CURL
-		CURL* curl;
+		std::vector<CURL*> idleHandles;
+		std::mutex poolMutex;
+
+		CURL* createHandle();
+		CURL* acquireHandle();
+		void releaseHandle(CURL* handle);
+
+		//sets the request options of the handle. returns the header list, which should be freed after the request
+		//sends the conditional headers with the validators of the cached entry if given
+		curl_slist* prepareHandle(CURL* handle, const std::string& path, std::string* response, const ChzzkCacheEntry* validator = nullptr);
+		void finishHandle(CURL* handle, curl_slist* slist);
+
+		//performs a single attempt of the request on a pooled handle
+		//collects the validators of the response only if validators is true
+		void performHandle(const std::string& path, const ChzzkCacheEntry* validator, bool validators, ChzzkHttpResponse& response);
+
+		//performs the request with libcurl or the transport, waiting for the rate limit and retrying with the retry policy
+		//fills the validators of the response into received and the status code if given
+		//throws if the last attempt failed without a response
+		std::string perform(const std::string& path, const ChzzkCacheEntry* validator = nullptr, ChzzkCacheEntry* received = nullptr, long* status = nullptr);
+
+		//requestBatch through the transport. transports block, so requests run on up to maxInFlight threads
+		void requestBatchTransport(const std::vector<std::string>& paths, const ChzzkBatchCallback& callback, size_t maxInFlight);
 #endif
 
-		bool _hasAuth;
-		int timeout;
+		//header lines of the request, with the auth cookies and the conditional headers of the validator
+		std::vector<std::string> makeHeaders(const ChzzkCacheEntry* validator);
+
+		std::atomic<ChzzkHttpTransport*> transport;
+
+		std::atomic<size_t> poolSize;
+		std::atomic<bool> shareConnection;
+		std::atomic<uint64_t> poolHits;
+		std::atomic<uint64_t> poolMisses;
+
+		std::atomic<bool> _hasAuth;
+		std::atomic<int> timeout;
 
 		std::pair<std::string, std::string> authKeys;
+		std::string authIdentity;	//hash of authKeys, so cached responses of different users are not mixed
+		std::mutex authMutex;
+
+		ChzzkCache cache;
+
+		ChzzkRateLimiter limiter;
+		ChzzkRetryPolicy retryPolicy;
+		std::mutex retryMutex;
+		std::atomic<uint64_t> retried;
+		std::atomic<uint64_t> failed;
 
 	public:
+		const static size_t DEFAULT_POOL_SIZE = 8;
+		const static size_t DEFAULT_BATCH_CONCURRENCY = 32;
 
 		//@timeout respond timeout seconds. never times out if value is 0
-		ChzzkCore(int timeout = 0);
+		//@poolSize max number of idle handles kept for reuse
+		ChzzkCore(int timeout = 0, size_t poolSize = DEFAULT_POOL_SIZE);
 		~ChzzkCore();
 
+		//returns the response even if the status is not 200. throws if the request failed without a response, after the retries
 		std::string request(const std::string& path);
 
+		//requests through the response cache, keeping the response for the ttl of the endpoint
+		//expired responses are revalidated with If-None-Match and If-Modified-Since when the server gave the validators
+		//same as request(path) if the cache is disabled or the ttl of the endpoint is 0
+		std::string request(const std::string& path, ChzzkEndpoint endpoint);
+
+		//requests every path concurrently with curl multi, keeping at most maxInFlight requests at once
+		//blocks until every request is done. callback is called on the calling thread in the order of completion
+		void requestBatch(const std::vector<std::string>& paths, const ChzzkBatchCallback& callback, size_t maxInFlight = DEFAULT_BATCH_CONCURRENCY);
+
 		//you can set NID_AUTH and NID_SESSION here.
 		//you can get these from NID_AUT and NID_SES cookies from Application > Cookies > https://chzzk.naver.com, after you logged in
 		void setAuth(const std::string& auth, const std::string& session);
@@ -51,6 +127,55 @@ namespace chzzkpp
 
 		int getTimeout() const;
 
+		//@poolSize max number of idle handles kept for reuse. handles over the size are cleaned up when released
+		void setPoolSize(size_t poolSize);
+
+		size_t getPoolSize() const;
+
+		ChzzkCorePoolStats getPoolStats();
+
+		//whether handles share dns cache and tls sessions with chats through ChzzkShare. true by default
+		//idle handles are cleaned up, so the setting applies to the new handles
+		void setShareConnection(bool share);
+
+		bool isSharingConnection() const;
+
+		//@bytes max total bytes of the cached responses. the cache is disabled if 0, which is default
+		void setCacheCapacity(size_t bytes);
+
+		size_t getCacheCapacity();
+
+		//@ttl seconds to keep the responses of the endpoint. responses are not cached if 0
+		//channels and videos are kept for 60 seconds, and donation settings for 300 seconds by default
+		void setCacheTTL(ChzzkEndpoint endpoint, int ttl);
+
+		int getCacheTTL(ChzzkEndpoint endpoint);
+
+		void clearCache();
+
+		ChzzkCacheStats getCacheStats();
+
+		//limits the requests of every host without its own limit with token buckets. unlimited by default
+		//@rate requests per second for each host. unlimited if 0
+		//@burst max requests sent at once after idle
+		void setRateLimit(double rate, int burst);
+
+		//limits the requests of the host. ex) api.chzzk.naver.com
+		void setRateLimit(const std::string& host, double rate, int burst);
+
+		//requests are retried on 429, 5xx and transient curl errors. 2 retries by default
+		void setRetryPolicy(const ChzzkRetryPolicy& policy);
+
+		ChzzkRetryPolicy getRetryPolicy();
+
+		ChzzkRateStats getRateStats();
+
+		//sends the requests through the transport instead of libcurl, ex) ChzzkMockServer. libcurl is used again if null
+		//the transport should live longer than the core
+		void setTransport(ChzzkHttpTransport* transport);
+
+		ChzzkHttpTransport* getTransport() const;
+
 		std::string getChannel(const std::string& channelID);
 
 		std::string getLiveStatus(const std::string& channelID);
@@ -93,6 +218,9 @@ namespace chzzkpp
 		std::string getMissionDonationSetting(const std::string& channelID);
 
 		bool hasAuth() const;
+
+		//hash of the auth keys. empty without auth. results shared between requests should be keyed with it
+		std::string getAuthIdentity();
 	};
 }
 
@@ -0,0 +1,407 @@
+#pragma once
+#ifndef _CHZZK_DISPATCHER_
+#define _CHZZK_DISPATCHER_
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <chrono>
+
+#if _DEBUG
+#include <iostream>
+#endif
+
+namespace chzzkpp
+{
+	//how chat handlers are called
+	enum class ChzzkDispatchMode
+	{
+		INLINE,	//handlers are called on the receiver thread
+		QUEUED	//messages are queued, and handlers are called on the worker threads
+	};
+
+	//what to do when the dispatch queue is full
+	enum class ChzzkOverflowPolicy
+	{
+		DROP_OLDEST,	//drops the oldest queued message. messages which can't be dropped are kept in order
+		BLOCK,			//blocks the receiver until there is space in the queue
+		COALESCE		//keeps only the latest message with the same key until there is space in the queue. messages with unique keys all wait in order
+	};
+
+	struct ChzzkDispatchStats
+	{
+		size_t queueDepth;		//number of messages waiting in the queue
+		size_t capacity;		//queue capacity
+		uint64_t dispatched;	//number of handled messages
+		uint64_t dropped;		//number of messages dropped by DROP_OLDEST
+		uint64_t coalesced;		//number of messages replaced by newer one by COALESCE
+		uint64_t blocked;		//number of times the receiver blocked by BLOCK
+		uint64_t failed;		//number of messages whose handler threw
+	};
+
+	//lock-free bounded multi-producer multi-consumer ring buffer
+	//reference: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+	template <typename T>
+	class ChzzkRingBuffer
+	{
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			T data;
+		};
+
+		std::unique_ptr<Cell[]> cells;
+		size_t mask;
+
+		alignas(64) std::atomic<size_t> head;	//next position to push
+		alignas(64) std::atomic<size_t> tail;	//next position to pop
+
+	public:
+		//capacity is rounded up to the power of 2
+		explicit ChzzkRingBuffer(size_t capacity) : head(0), tail(0)
+		{
+			size_t size = 2;
+			while (size < capacity) size <<= 1;
+
+			cells.reset(new Cell[size]);
+			mask = size - 1;
+
+			for (size_t i = 0; i < size; i++)
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		ChzzkRingBuffer(const ChzzkRingBuffer&) = delete;
+		ChzzkRingBuffer& operator=(const ChzzkRingBuffer&) = delete;
+
+		//returns false if full
+		bool push(T&& value)
+		{
+			Cell* cell;
+			size_t pos = head.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				cell = &cells[pos & mask];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+				if (diff == 0)
+				{
+					if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+				}
+				else if (diff < 0) return false;
+				else pos = head.load(std::memory_order_relaxed);
+			}
+
+			cell->data = std::move(value);
+			cell->sequence.store(pos + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		//returns false if empty
+		bool pop(T& value)
+		{
+			Cell* cell;
+			size_t pos = tail.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				cell = &cells[pos & mask];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+				if (diff == 0)
+				{
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+				}
+				else if (diff < 0) return false;
+				else pos = tail.load(std::memory_order_relaxed);
+			}
+
+			value = std::move(cell->data);
+			cell->sequence.store(pos + mask + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		//approximate number of items
+		size_t size() const
+		{
+			size_t h = head.load(std::memory_order_acquire);
+			size_t t = tail.load(std::memory_order_acquire);
+
+			return h > t ? h - t : 0;
+		}
+
+		size_t capacity() const
+		{
+			return mask + 1;
+		}
+	};
+
+	//calls handler with queued items on a worker pool
+	//with more than one worker, items can be handled out of order
+	template <typename T>
+	class ChzzkDispatcher
+	{
+		ChzzkRingBuffer<T> ring;
+		ChzzkOverflowPolicy policy;
+
+		std::function<void(T&)> handler;
+		std::function<size_t(const T&)> coalesceKey;	//items with the same key replace each other with COALESCE
+		std::function<bool(const T&)> droppable;		//whether DROP_OLDEST can drop the item
+
+		std::vector<std::thread> workers;
+		std::atomic<bool> running;
+
+		std::mutex mutex;
+		std::condition_variable notEmpty;
+		std::condition_variable notFull;
+		std::atomic<size_t> sleepingWorkers;
+		std::atomic<size_t> blockedProducers;
+
+		std::vector<std::pair<size_t, T>> overflow;	//coalesced items waiting for space. guarded by mutex
+		std::atomic<size_t> overflowSize;
+
+		std::deque<T> kept;	//oldest items which DROP_OLDEST couldn't drop, handled before the ring. guarded by mutex
+		std::atomic<size_t> keptSize;
+
+		std::atomic<uint64_t> dispatched;
+		std::atomic<uint64_t> dropped;
+		std::atomic<uint64_t> coalesced;
+		std::atomic<uint64_t> blocked;
+		std::atomic<uint64_t> failed;
+
+		//max milliseconds for sleeping threads to check the state again
+		static constexpr int WAIT_TIME = 100;
+
+		void wakeWorker()
+		{
+			if (sleepingWorkers)
+			{
+				std::lock_guard<std::mutex> guard(mutex);
+				notEmpty.notify_one();
+			}
+		}
+
+		//moves coalesced items into the ring, as many as possible
+		bool flushOverflow()
+		{
+			if (!overflowSize) return false;
+
+			std::lock_guard<std::mutex> guard(mutex);
+
+			size_t moved = 0;
+
+			while (moved < overflow.size() && ring.push(std::move(overflow[moved].second)))
+				moved++;
+
+			overflow.erase(overflow.begin(), overflow.begin() + moved);
+			overflowSize = overflow.size();
+
+			return moved > 0;
+		}
+
+		void coalesce(T&& item)
+		{
+			{
+				std::lock_guard<std::mutex> guard(mutex);
+
+				size_t key = coalesceKey(item);
+				bool replaced = false;
+
+				if (key != UNIQUE_KEY)
+				{
+					for (auto& p : overflow)
+					{
+						if (p.first == key)
+						{
+							p.second = std::move(item);
+							replaced = true;
+							break;
+						}
+					}
+				}
+
+				if (replaced) coalesced++;
+				else overflow.emplace_back(key, std::move(item));
+
+				overflowSize = overflow.size();
+			}
+
+			wakeWorker();
+		}
+
+		bool popKept(T& item)
+		{
+			if (!keptSize) return false;
+
+			std::lock_guard<std::mutex> guard(mutex);
+			if (kept.empty()) return false;
+
+			item = std::move(kept.front());
+			kept.pop_front();
+			keptSize = kept.size();
+
+			return true;
+		}
+
+		void work()
+		{
+			while (true)
+			{
+				T item;
+
+				if (popKept(item) || ring.pop(item))
+				{
+					flushOverflow();
+
+					if (blockedProducers)
+					{
+						std::lock_guard<std::mutex> guard(mutex);
+						notFull.notify_all();
+					}
+
+					try
+					{
+						handler(item);
+					}
+					catch (std::exception& e)
+					{
+						failed++;
+#if _DEBUG
+						std::cerr << "Error occured handling the dispatched message: " << e.what() << std::endl;
+#endif
+					}
+
+					dispatched++;
+					continue;
+				}
+
+				if (flushOverflow()) continue;
+				if (!running) break;
+
+				std::unique_lock<std::mutex> lock(mutex);
+
+				sleepingWorkers++;
+				notEmpty.wait_for(lock, std::chrono::milliseconds(WAIT_TIME), [&]() { return !running || ring.size() || overflowSize || keptSize; });
+				sleepingWorkers--;
+			}
+		}
+
+	public:
+		//coalesce key of items never replaced by COALESCE
+		static constexpr size_t UNIQUE_KEY = (size_t)-1;
+
+		//@capacity queue capacity, rounded up to the power of 2
+		//@workerCount number of worker threads. handlers are called in order if 1
+		//@coalesceKey key of item used by COALESCE. UNIQUE_KEY if the item should not be replaced
+		//@droppable whether DROP_OLDEST can drop the item
+		ChzzkDispatcher(size_t capacity, size_t workerCount, ChzzkOverflowPolicy policy, const std::function<void(T&)>& handler, const std::function<size_t(const T&)>& coalesceKey,
+			const std::function<bool(const T&)>& droppable)
+			: ring(capacity), policy(policy), handler(handler), coalesceKey(coalesceKey), droppable(droppable), running(true), sleepingWorkers(0), blockedProducers(0), overflowSize(0), keptSize(0),
+			dispatched(0), dropped(0), coalesced(0), blocked(0), failed(0)
+		{
+			if (!workerCount) workerCount = 1;
+
+			for (size_t i = 0; i < workerCount; i++)
+				workers.emplace_back(&ChzzkDispatcher::work, this);
+		}
+
+		//handles every queued item, and stops the workers
+		~ChzzkDispatcher()
+		{
+			{
+				std::lock_guard<std::mutex> guard(mutex);
+				running = false;
+			}
+
+			notEmpty.notify_all();
+			notFull.notify_all();
+
+			for (auto& worker : workers)
+				if (worker.joinable()) worker.join();
+		}
+
+		ChzzkDispatcher(const ChzzkDispatcher&) = delete;
+		ChzzkDispatcher& operator=(const ChzzkDispatcher&) = delete;
+
+		void push(T&& item)
+		{
+			//keep the order with coalesced items
+			if (policy == ChzzkOverflowPolicy::COALESCE && overflowSize)
+			{
+				coalesce(std::move(item));
+				return;
+			}
+
+			bool waited = false;
+
+			while (!ring.push(std::move(item)))
+			{
+				if (policy == ChzzkOverflowPolicy::DROP_OLDEST)
+				{
+					T oldest;
+
+					if (ring.pop(oldest))
+					{
+						if (droppable(oldest)) dropped++;
+						else
+						{
+							std::lock_guard<std::mutex> guard(mutex);
+
+							kept.push_back(std::move(oldest));
+							keptSize = kept.size();
+						}
+					}
+				}
+				else if (policy == ChzzkOverflowPolicy::COALESCE)
+				{
+					coalesce(std::move(item));
+					return;
+				}
+				else
+				{
+					if (!waited) blocked++;
+					waited = true;
+
+					blockedProducers++;
+
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						notFull.wait_for(lock, std::chrono::milliseconds(WAIT_TIME), [&]() { return !running || ring.size() < ring.capacity(); });
+					}
+
+					blockedProducers--;
+
+					if (!running) return;
+				}
+			}
+
+			wakeWorker();
+		}
+
+		ChzzkDispatchStats getStats() const
+		{
+			ChzzkDispatchStats stats;
+
+			stats.queueDepth = ring.size() + overflowSize + keptSize;
+			stats.capacity = ring.capacity();
+			stats.dispatched = dispatched;
+			stats.dropped = dropped;
+			stats.coalesced = coalesced;
+			stats.blocked = blocked;
+			stats.failed = failed;
+
+			return stats;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,229 @@
+#pragma once
+#ifndef _CHZZK_FIELDS_
+#define _CHZZK_FIELDS_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace chzzkpp
+{
+	//compile-time field tables of the api structs
+	//each table maps json keys to struct members, so decoders can fill the structs and serializers can make the json without hand-written code per type
+
+	//32bit FNV-1a hash of field keys
+	constexpr uint32_t field_hash(const char* key, size_t length)
+	{
+		uint32_t hash = 2166136261u;
+
+		for (size_t i = 0; i < length; i++)
+		{
+			hash ^= (uint8_t)key[i];
+			hash *= 16777619u;
+		}
+
+		return hash;
+	}
+
+	constexpr size_t field_length(const char* key)
+	{
+		size_t length = 0;
+		while (key[length]) length++;
+
+		return length;
+	}
+
+	constexpr uint32_t field_hash(const char* key)
+	{
+		return field_hash(key, field_length(key));
+	}
+
+	enum class ChzzkFieldType
+	{
+		BOOL,			//bool
+		INT,			//int
+		STRING,			//std::string
+		STRING_LIST,	//std::vector<std::string>
+		RAW,			//std::string with the json value dumped
+		OBJECT,			//struct described by another table
+		NESTED,			//struct described by another table, from a json string containing the object. ex) livePollingStatusJson of ChzzkLiveStatus
+		INLINE,			//json object whose fields belong to the struct itself. ex) user of ChzzkMissionInfo
+		OBJECT_LIST		//std::vector of struct described by another table
+	};
+
+	struct ChzzkFieldTable;
+
+	struct ChzzkField
+	{
+		const char* key;
+		size_t length;				//length of key
+		uint32_t hash;				//field_hash of key
+		ChzzkFieldType type;
+		void* (*member)(void*);		//address of the member in the struct. the struct itself for INLINE
+		const ChzzkFieldTable* table;	//table of the nested struct for OBJECT, NESTED, INLINE and OBJECT_LIST
+		void* (*append)(void*);		//appends an element to the list, and returns its address for OBJECT_LIST
+		void* (*element)(void*, size_t);	//address of the element at the index of the list, nullptr if out of range for OBJECT_LIST
+	};
+
+	struct ChzzkFieldTable
+	{
+		const ChzzkField* fields;
+		size_t size;
+		bool* (*available)(void*);		//flag set when the json object has any key. nullptr if the struct has no flag
+		const ChzzkFieldTable* base;	//table of the base struct. nullptr if none
+		void* (*toBase)(void*);			//converts the struct address to its base struct address
+
+		//calls func(field, object) for every field of the key, including fields of base tables
+		//more than one field can have the same key
+		template <typename F>
+		void find(const char* key, size_t length, uint32_t hash, void* object, F&& func) const
+		{
+			for (const ChzzkFieldTable* table = this; table; table = table->base)
+			{
+				for (size_t i = 0; i < table->size; i++)
+				{
+					const ChzzkField& field = table->fields[i];
+
+					if (field.hash == hash && field.length == length && std::char_traits<char>::compare(field.key, key, length) == 0)
+						func(field, object);
+				}
+
+				if (table->toBase) object = table->toBase(object);
+			}
+		}
+	};
+
+	//field table of T. specialized for each struct in ChzzkTypes.h
+	template <typename T>
+	struct ChzzkFields;
+
+	namespace fields
+	{
+		template <typename M>
+		struct member_type;
+
+		template <typename C, typename V>
+		struct member_type<V C::*>
+		{
+			using type = V;
+		};
+
+		template <typename V>
+		constexpr ChzzkFieldType value_type();
+
+		template <>
+		constexpr ChzzkFieldType value_type<bool>() { return ChzzkFieldType::BOOL; }
+
+		template <>
+		constexpr ChzzkFieldType value_type<int>() { return ChzzkFieldType::INT; }
+
+		template <>
+		constexpr ChzzkFieldType value_type<std::string>() { return ChzzkFieldType::STRING; }
+
+		template <>
+		constexpr ChzzkFieldType value_type<std::vector<std::string>>() { return ChzzkFieldType::STRING_LIST; }
+
+		template <typename T, auto member>
+		void* address(void* object)
+		{
+			return &(static_cast<T*>(object)->*member);
+		}
+
+		inline void* self(void* object)
+		{
+			return object;
+		}
+
+		template <typename T, auto member>
+		void* append(void* object)
+		{
+			auto& list = static_cast<T*>(object)->*member;
+			list.emplace_back();
+
+			return &list.back();
+		}
+
+		template <typename T, auto member>
+		void* element(void* object, size_t index)
+		{
+			auto& list = static_cast<T*>(object)->*member;
+			return index < list.size() ? &list[index] : nullptr;
+		}
+
+		template <typename T, auto member>
+		bool* flag(void* object)
+		{
+			return &(static_cast<T*>(object)->*member);
+		}
+
+		template <typename T, typename Base>
+		void* base(void* object)
+		{
+			return static_cast<Base*>(static_cast<T*>(object));
+		}
+	}
+
+	//field of bool, int, std::string or std::vector<std::string> member
+	template <typename T, auto member>
+	constexpr ChzzkField chzzk_field(const char* key)
+	{
+		return { key, field_length(key), field_hash(key), fields::value_type<typename fields::member_type<decltype(member)>::type>(), &fields::address<T, member>, nullptr, nullptr, nullptr };
+	}
+
+	//std::string member with the json value dumped
+	template <typename T, auto member>
+	constexpr ChzzkField chzzk_raw_field(const char* key)
+	{
+		return { key, field_length(key), field_hash(key), ChzzkFieldType::RAW, &fields::address<T, member>, nullptr, nullptr, nullptr };
+	}
+
+	//struct member described by the table
+	template <typename T, auto member>
+	constexpr ChzzkField chzzk_object_field(const char* key, const ChzzkFieldTable& table)
+	{
+		return { key, field_length(key), field_hash(key), ChzzkFieldType::OBJECT, &fields::address<T, member>, &table, nullptr, nullptr };
+	}
+
+	//struct member described by the table, encoded as a json string. a json object is also accepted
+	template <typename T, auto member>
+	constexpr ChzzkField chzzk_nested_field(const char* key, const ChzzkFieldTable& table)
+	{
+		return { key, field_length(key), field_hash(key), ChzzkFieldType::NESTED, &fields::address<T, member>, &table, nullptr, nullptr };
+	}
+
+	//json object whose keys are described by the table, on the members of the struct itself
+	constexpr ChzzkField chzzk_inline_field(const char* key, const ChzzkFieldTable& table)
+	{
+		return { key, field_length(key), field_hash(key), ChzzkFieldType::INLINE, &fields::self, &table, nullptr, nullptr };
+	}
+
+	//std::vector member of structs described by the table
+	template <typename T, auto member>
+	constexpr ChzzkField chzzk_list_field(const char* key, const ChzzkFieldTable& table)
+	{
+		return { key, field_length(key), field_hash(key), ChzzkFieldType::OBJECT_LIST, &fields::address<T, member>, &table, &fields::append<T, member>, &fields::element<T, member> };
+	}
+
+	template <size_t N>
+	constexpr ChzzkFieldTable chzzk_table(const ChzzkField(&list)[N])
+	{
+		return { list, N, nullptr, nullptr, nullptr };
+	}
+
+	//table with the flag set when the json object has any key. ex) available of ChzzkChannelPersonalData
+	template <typename T, auto available, size_t N>
+	constexpr ChzzkFieldTable chzzk_table(const ChzzkField(&list)[N])
+	{
+		return { list, N, &fields::flag<T, available>, nullptr, nullptr };
+	}
+
+	//table of the struct derived from Base. fields of the base table are also looked up
+	template <typename T, typename Base, size_t N>
+	constexpr ChzzkFieldTable chzzk_derived_table(const ChzzkField(&list)[N], const ChzzkFieldTable& base)
+	{
+		return { list, N, nullptr, &base, &fields::base<T, Base> };
+	}
+}
+
+#endif
@@ -0,0 +1,158 @@
+#pragma once
+#ifndef _CHZZK_HANDLER_LIST_
+#define _CHZZK_HANDLER_LIST_
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+
+namespace chzzkpp
+{
+	//copy-on-write list of handlers
+	//a call takes a snapshot with one atomic increment and one atomic load, so calls are wait-free and never wait for the writers
+	//writers copy the list and publish the new one. they should be serialized by the owner of the list
+	//replaced lists are freed by a later writer which sees no snapshot alive, so they pile up while calls never stop
+	//a handler removed while a call is running may still be called by that call
+	template <typename... Args>
+	class ChzzkHandlerList
+	{
+	public:
+		using Handler = std::function<void(Args...)>;
+		using List = std::vector<std::pair<size_t, Handler>>;
+
+		//keeps the lists of the owner alive until destroyed
+		class Snapshot
+		{
+			const ChzzkHandlerList* owner;
+			const List* list;
+
+		public:
+			explicit Snapshot(const ChzzkHandlerList& owner) : owner(&owner)
+			{
+				//counted before the load, so a writer which sees no reader has already published the list loaded here
+				owner.readers.fetch_add(1);
+				list = owner.list.load();
+			}
+
+			Snapshot(Snapshot&& other) : owner(other.owner), list(other.list)
+			{
+				other.owner = nullptr;
+			}
+
+			~Snapshot()
+			{
+				if (owner) owner->readers.fetch_sub(1, std::memory_order_release);
+			}
+
+			Snapshot(const Snapshot&) = delete;
+			Snapshot& operator=(const Snapshot&) = delete;
+
+			//false if empty
+			explicit operator bool() const
+			{
+				return list != nullptr;
+			}
+
+			const List& operator*() const
+			{
+				return *list;
+			}
+
+			const List* operator->() const
+			{
+				return list;
+			}
+		};
+
+	private:
+		//null if empty
+		std::atomic<const List*> list;
+
+		//number of snapshots alive
+		mutable std::atomic<size_t> readers;
+
+		//replaced lists which snapshots may still read. only used by the writers
+		std::vector<std::unique_ptr<const List>> retired;
+
+		void publish(std::unique_ptr<List> updated)
+		{
+			const List* old = list.exchange(updated.release());
+			if (old) retired.emplace_back(old);
+
+			//snapshots taken from now on see the new list
+			if (!retired.empty() && readers.load() == 0) retired.clear();
+		}
+
+	public:
+		ChzzkHandlerList() : list(nullptr), readers(0)
+		{
+		}
+
+		//no call should be running
+		~ChzzkHandlerList()
+		{
+			delete list.load();
+		}
+
+		ChzzkHandlerList(const ChzzkHandlerList&) = delete;
+		ChzzkHandlerList& operator=(const ChzzkHandlerList&) = delete;
+
+		//current handlers. the snapshot stays valid while the list changes
+		Snapshot snapshot() const
+		{
+			return Snapshot(*this);
+		}
+
+		bool empty() const
+		{
+			return !list.load(std::memory_order_acquire);
+		}
+
+		void add(size_t id, const Handler& handler)
+		{
+			//only the writers free the lists, so the current one can be read without a snapshot
+			const List* current = list.load();
+			auto updated = current ? std::make_unique<List>(*current) : std::make_unique<List>();
+
+			updated->emplace_back(id, handler);
+			publish(std::move(updated));
+		}
+
+		//returns false if there is no handler with the id
+		bool remove(size_t id)
+		{
+			const List* current = list.load();
+			if (!current) return false;
+
+			auto updated = std::make_unique<List>();
+			updated->reserve(current->size());
+
+			for (auto& p : *current)
+				if (p.first != id) updated->push_back(p);
+
+			if (updated->size() == current->size()) return false;
+
+			publish(updated->empty() ? nullptr : std::move(updated));
+			return true;
+		}
+
+		void clear()
+		{
+			publish(nullptr);
+		}
+
+		//calls every handler in the order they were added
+		template <typename... CallArgs>
+		void call(CallArgs&&... args) const
+		{
+			Snapshot current(*this);
+			if (!current) return;
+
+			for (auto& p : *current)
+				p.second(args...);
+		}
+	};
+}
+
+#endif
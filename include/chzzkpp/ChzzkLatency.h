@@ -0,0 +1,117 @@
+#pragma once
+#ifndef _CHZZK_LATENCY_
+#define _CHZZK_LATENCY_
+
+#include <vector>
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace chzzkpp
+{
+	enum class ChzzkChatEvent;
+
+	//copy of ChzzkHistogram at a moment
+	struct ChzzkHistogramSnapshot
+	{
+		uint64_t count;
+		uint64_t min;		//microseconds. 0 if empty
+		uint64_t max;
+		double mean;
+		std::vector<uint64_t> buckets;	//counts of the buckets of ChzzkHistogram
+
+		ChzzkHistogramSnapshot() : count(0), min(0), max(0), mean(0)
+		{
+		}
+
+		//microseconds under which the percent of the values are. ex) percentile(99) for p99
+		//rounded up to the bucket, so the error is at most about 3%
+		uint64_t percentile(double percent) const;
+	};
+
+	//histogram of microseconds with log-linear buckets, like HdrHistogram
+	//each power of 2 is split into 32 buckets. values over about 19 hours are counted in the last bucket
+	//recording is lock-free, so it can be called from many threads
+	class ChzzkHistogram
+	{
+	public:
+		static constexpr int SUB_BUCKET_BITS = 5;
+		static constexpr int MAX_VALUE_BITS = 36;
+
+		static constexpr size_t SUB_BUCKET_COUNT = (size_t)1 << SUB_BUCKET_BITS;
+		static constexpr size_t BUCKET_COUNT = 2 * SUB_BUCKET_COUNT + (MAX_VALUE_BITS - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT;
+
+	private:
+		std::atomic<uint64_t> buckets[BUCKET_COUNT];
+		std::atomic<uint64_t> sum;
+		std::atomic<uint64_t> min;
+		std::atomic<uint64_t> max;
+
+	public:
+		ChzzkHistogram();
+
+		ChzzkHistogram(const ChzzkHistogram&) = delete;
+		ChzzkHistogram& operator=(const ChzzkHistogram&) = delete;
+
+		void record(uint64_t micros);
+
+		ChzzkHistogramSnapshot snapshot() const;
+
+		void reset();
+
+		static size_t bucketIndex(uint64_t micros);
+
+		//largest value counted in the bucket
+		static uint64_t bucketUpperBound(size_t index);
+	};
+
+	//latency of the chat messages through each stage
+	struct ChzzkLatencyStats
+	{
+		ChzzkHistogramSnapshot server;		//msgTime of the server to receive. includes the clock difference with the server. recent chats are not counted
+		ChzzkHistogramSnapshot dispatch;	//receive to the start of the handlers, including parsing and the dispatch queue
+		ChzzkHistogramSnapshot total;		//receive to the end of the handlers
+		std::map<ChzzkChatEvent, ChzzkHistogramSnapshot> handlers;	//execution time of the handlers of each event
+	};
+
+	//histograms of the stages of the messages of a chat, or every chat of a hub
+	class ChzzkLatencyTracker
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		//max number of chat events
+		static const size_t MAX_EVENTS = 16;
+
+	private:
+		ChzzkHistogram server;
+		ChzzkHistogram dispatch;
+		ChzzkHistogram total;
+
+		//made when the event is handled for the first time
+		std::atomic<ChzzkHistogram*> handlers[MAX_EVENTS];
+
+	public:
+		ChzzkLatencyTracker();
+		~ChzzkLatencyTracker();
+
+		ChzzkLatencyTracker(const ChzzkLatencyTracker&) = delete;
+		ChzzkLatencyTracker& operator=(const ChzzkLatencyTracker&) = delete;
+
+		//@messageTime msgTime of the message, as UNIX timestamp milliseconds. not recorded if 0
+		//@receiveTime UNIX timestamp milliseconds when the frame was received
+		void recordServer(unsigned long long messageTime, unsigned long long receiveTime);
+
+		//@received when the frame was received
+		//@start when the handlers started
+		//@end when the handlers finished
+		void recordHandlers(ChzzkChatEvent type, Clock::time_point received, Clock::time_point start, Clock::time_point end);
+
+		ChzzkLatencyStats getStats() const;
+
+		void reset();
+	};
+}
+
+#endif
@@ -0,0 +1,151 @@
+#pragma once
+#ifndef _CHZZK_LIVE_WATCHER_
+#define _CHZZK_LIVE_WATCHER_
+
+#include "ChzzkClient.h"
+#include "ChzzkPolling.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+namespace chzzkpp
+{
+	enum class ChzzkLiveEvent
+	{
+		OPEN,			//live started
+		CLOSE,			//live ended
+		TITLE,			//live title changed
+		CATEGORY,		//categoryType or liveCategory changed
+		VIEWERS,		//concurrent viewers changed by ChzzkLiveWatcherOptions::viewerDelta or more since the last VIEWERS event
+		CHAT_CHANNEL	//chatChannelID changed
+	};
+
+	//change of a channel passed to the handlers
+	struct ChzzkLiveChange
+	{
+		ChzzkLiveEvent type;
+		const std::string& channelID;
+		const ChzzkLiveStatus& previous;	//status of the last poll
+		const ChzzkLiveStatus& current;
+	};
+
+	struct ChzzkLiveWatcherOptions
+	{
+		int pollTime;			//milliseconds between polls of a channel, if the server doesn't advertise callPeriodMilliSecond
+		size_t maxInFlight;		//max number of concurrent requests of a batch
+		int batchWindow;		//polls due within this milliseconds are sent together in a batch. should be much shorter than pollTime
+		int viewerDelta;		//min change of concurrent viewers for VIEWERS event. no VIEWERS event if 0
+
+		const static int DEFAULT_POLL_TIME = 30 * 1000;
+		const static int DEFAULT_BATCH_WINDOW = 250;
+
+		ChzzkLiveWatcherOptions() : pollTime(DEFAULT_POLL_TIME), maxInFlight(ChzzkCore::DEFAULT_BATCH_CONCURRENCY), batchWindow(DEFAULT_BATCH_WINDOW), viewerDelta(0)
+		{
+		}
+	};
+
+	//watches the live status of many channels, and calls handlers only when something changes
+	//channels are polled in batches by a single scheduler thread, each at the interval decided by ChzzkPollSchedule
+	//the first status of a channel is stored without events. handlers are called on the scheduler thread
+	class ChzzkLiveWatcher
+	{
+		using Clock = std::chrono::steady_clock;
+
+		struct Entry
+		{
+			std::string channelID;
+			ChzzkLiveStatus status;		//status of the last successful poll
+			bool initialized;			//whether status has been polled
+			bool polling;				//whether the channel is in the running batch
+			int reportedViewers;		//concurrent viewers of the last VIEWERS event
+			ChzzkPollSchedule schedule;
+			Clock::time_point deadline;	//when the channel should be polled next
+		};
+
+		ChzzkClient* client;
+		ChzzkLiveWatcherOptions options;
+
+		//channels are kept in a contiguous table, and removed by swapping with the last one
+		std::vector<Entry> entries;
+		std::unordered_map<std::string, size_t> index;
+		std::mutex mutex;
+		std::condition_variable wakeup;
+
+		std::map<ChzzkLiveEvent, std::map<size_t, std::function<void(const ChzzkLiveChange&)>>> handlers;
+		std::shared_mutex handlerMutex;
+		size_t nextHandlerID;
+
+		std::thread thread;
+		bool running;
+
+		std::atomic<uint64_t> polls;
+		std::atomic<uint64_t> failures;
+		std::atomic<uint64_t> events;
+		std::atomic<uint64_t> handlerFailures;
+
+		//max milliseconds to wait, if there is no channel
+		static constexpr int WAIT_TIME = 1000;
+
+		void run();
+
+		//stores the polled status, and calls handlers with the changes
+		void update(const std::string& channelID, const ChzzkLiveStatus& status);
+		void fail(const std::string& channelID);
+
+		void call(ChzzkLiveEvent type, const std::string& channelID, const ChzzkLiveStatus& previous, const ChzzkLiveStatus& current);
+
+	public:
+		//@client client used to poll. it should live longer than the watcher
+		ChzzkLiveWatcher(ChzzkClient* client, ChzzkLiveWatcherOptions options = ChzzkLiveWatcherOptions());
+
+		//stops the scheduler thread, waiting for the running batch
+		~ChzzkLiveWatcher();
+
+		ChzzkLiveWatcher(const ChzzkLiveWatcher&) = delete;
+		ChzzkLiveWatcher& operator=(const ChzzkLiveWatcher&) = delete;
+
+		//starts watching the channel. it is polled in the next batch
+		void addChannel(const std::string& channelID);
+
+		void removeChannel(const std::string& channelID);
+
+		bool hasChannel(const std::string& channelID);
+
+		std::vector<std::string> getChannels();
+
+		size_t size();
+
+		//copies the last polled status of the channel. returns false if the channel is not watched or not polled yet
+		bool getStatus(const std::string& channelID, ChzzkLiveStatus& status);
+
+		//returns the id of the handler
+		size_t addHandler(ChzzkLiveEvent type, const std::function<void(const ChzzkLiveChange&)>& func);
+
+		void removeHandler(ChzzkLiveEvent type, size_t id);
+
+		void removeHandlers(ChzzkLiveEvent type);
+
+		//number of polled statuses
+		uint64_t getPollCount() const;
+
+		//number of failed polls
+		uint64_t getFailureCount() const;
+
+		//number of change events
+		uint64_t getEventCount() const;
+
+		//number of handler calls which threw
+		uint64_t getHandlerFailureCount() const;
+	};
+}
+
+#endif
@@ -0,0 +1,98 @@
+#pragma once
+#ifndef _CHZZK_MOCK_SERVER_
+#define _CHZZK_MOCK_SERVER_
+
+#include "ChzzkTransport.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace chzzkpp
+{
+	//in-process chzzk server for tests and benchmarks without the network
+	//serves canned api responses to ChzzkCore, and replays chat frames to ChzzkChat at a fixed rate
+	//set it with ChzzkCore::setTransport and ChzzkChatOptions::transport. it should live longer than them. thread-safe
+	class ChzzkMockServer : public ChzzkHttpTransport, public ChzzkWebSocketTransport
+	{
+		struct Response
+		{
+			long status;
+			std::string body;
+		};
+
+		std::unordered_map<std::string, Response> responses;
+		std::shared_mutex responseMutex;
+
+		//connections take a snapshot of the frames when the chat connects
+		std::shared_ptr<const std::vector<std::string>> frames;
+		std::mutex frameMutex;
+
+		std::atomic<int> replayRate;
+		std::atomic<int> replayLoops;
+
+		std::atomic<uint64_t> requests;
+		std::atomic<uint64_t> sentFrames;
+		std::atomic<uint64_t> receivedFrames;
+		std::atomic<uint64_t> connections;
+
+		class Socket;
+
+	public:
+		//replays the frames as fast as the chat handles them by default
+		ChzzkMockServer();
+
+		ChzzkMockServer(const ChzzkMockServer&) = delete;
+		ChzzkMockServer& operator=(const ChzzkMockServer&) = delete;
+
+		//serves the body for the url. urls with a query are also matched without the query, if not set
+		//ex) setResponse(CHZZK_API_PATH_PREFIX_LIVE_STATUS + channelID + CHZZK_API_PATH_SUFFIX_LIVE_STATUS, json)
+		void setResponse(const std::string& url, const std::string& body, long status = 200);
+
+		void removeResponse(const std::string& url);
+
+		void clearResponses();
+
+		//adds a frame replayed to the chats after CONNECTED, ex) a recorded CHAT frame
+		void addFrame(const std::string& frame);
+
+		//adds the frames of the file, one for each line. returns the number of added frames
+		size_t loadFrames(const std::string& path);
+
+		void clearFrames();
+
+		//@rate frames per second replayed to each chat. as fast as possible if 0
+		//applies to the chats connected later
+		void setReplayRate(int rate);
+
+		int getReplayRate() const;
+
+		//@loops times to replay every frame to each chat. replayed until closed if 0. 1 by default
+		void setReplayLoops(int loops);
+
+		int getReplayLoops() const;
+
+		void perform(const ChzzkHttpRequest& request, ChzzkHttpResponse& response) override;
+
+		std::unique_ptr<ChzzkWebSocket> open(const std::string& url, int timeout, const ChzzkSocketMessageCallback& onMessage, const ChzzkSocketErrorCallback& onError) override;
+
+		//number of served http requests
+		uint64_t getRequestCount() const;
+
+		//number of frames sent to the chats, including replies
+		uint64_t getSentFrameCount() const;
+
+		//number of frames received from the chats
+		uint64_t getReceivedFrameCount() const;
+
+		//number of opened sockets
+		uint64_t getConnectionCount() const;
+	};
+}
+
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef _CHZZK_POLLING_
+#define _CHZZK_POLLING_
+
+#include "ChzzkTypes.h"
+
+namespace chzzkpp
+{
+	//decides the polling intervals of a channel from its live status
+	//follows callPeriodMilliSecond advertised by the server, and backs off exponentially while trafficThrottling is set or polls fail
+	//intervals are jittered, so polls of many channels started at once spread out over time
+	//not thread-safe
+	class ChzzkPollSchedule
+	{
+		int defaultInterval;
+		int minInterval;
+		int maxInterval;
+
+		int period;		//interval without backoff, from the last successful poll
+		int backoff;	//number of consecutive throttled or failed polls
+
+		int clamp(long long interval) const;
+
+	public:
+		const static int MIN_INTERVAL = 1000;
+		const static int MAX_INTERVAL = 5 * 60 * 1000;
+
+		//intervals are jittered by JITTER_PERCENT of the interval, both ways
+		const static int JITTER_PERCENT = 10;
+
+		//@defaultInterval milliseconds between polls, if the server doesn't advertise callPeriodMilliSecond
+		//@minInterval, maxInterval bounds of the intervals before the jitter
+		ChzzkPollSchedule(int defaultInterval = 30 * 1000, int minInterval = MIN_INTERVAL, int maxInterval = MAX_INTERVAL);
+
+		//delay of the first poll, spread over the default interval
+		int first() const;
+
+		//interval after a successful poll
+		int next(const ChzzkLivePollingStatus& status);
+
+		//interval after a failed poll
+		int fail();
+
+		//resets the backoff and the advertised period
+		void reset();
+
+		int getBackoff() const;
+
+		//interval with the random jitter
+		static int jitter(int interval);
+	};
+}
+
+#endif
@@ -0,0 +1,106 @@
+#pragma once
+#ifndef _CHZZK_RATE_LIMIT_
+#define _CHZZK_RATE_LIMIT_
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+namespace chzzkpp
+{
+	//how failed requests are retried
+	//requests are retried on 429, 5xx and transient curl errors, waiting with exponential backoff and full jitter
+	struct ChzzkRetryPolicy
+	{
+		int maxRetries;		//retries after the first attempt. no retry if 0
+		int baseDelay;		//max milliseconds before the first retry. doubled for each retry
+		int maxDelay;		//max milliseconds before a retry, including Retry-After of the server
+
+		const static int DEFAULT_MAX_RETRIES = 2;
+		const static int DEFAULT_BASE_DELAY = 200;
+		const static int DEFAULT_MAX_DELAY = 10 * 1000;
+
+		ChzzkRetryPolicy() : maxRetries(DEFAULT_MAX_RETRIES), baseDelay(DEFAULT_BASE_DELAY), maxDelay(DEFAULT_MAX_DELAY)
+		{
+		}
+
+		//milliseconds to wait before the retry after the attempt, from 0 to the backoff of the attempt
+		//@retryAfter seconds of Retry-After header of the server. the delay is at least that long, up to maxDelay
+		int delay(int attempt, long long retryAfter = 0) const;
+
+		//whether the response should be retried by the http status code
+		static bool retryable(long status);
+	};
+
+	struct ChzzkRateStats
+	{
+		uint64_t throttled;		//number of requests delayed by the rate limit
+		uint64_t throttledTime;	//total milliseconds of the delays by the rate limit
+		uint64_t retried;		//number of retries
+		uint64_t failed;		//number of requests which still failed after the retries
+	};
+
+	//token bucket rate limit of the requests for each host
+	//each host has its own bucket, filled at the rate up to the burst
+	//thread-safe
+	class ChzzkRateLimiter
+	{
+		using Clock = std::chrono::steady_clock;
+
+		struct Limit
+		{
+			double rate;	//tokens per second. unlimited if 0
+			int burst;		//max tokens
+		};
+
+		struct Bucket
+		{
+			Limit limit;
+			double tokens;	//negative while requests are waiting for the tokens
+			Clock::time_point last;
+		};
+
+		Limit defaultLimit;
+		std::unordered_map<std::string, Limit> limits;	//limits of specific hosts
+		std::unordered_map<std::string, Bucket> buckets;
+		std::mutex mutex;
+
+		std::atomic<uint64_t> throttled;
+		std::atomic<uint64_t> throttledTime;
+
+		Limit findLimit(const std::string& host) const;
+
+	public:
+		//unlimited by default
+		ChzzkRateLimiter();
+
+		ChzzkRateLimiter(const ChzzkRateLimiter&) = delete;
+		ChzzkRateLimiter& operator=(const ChzzkRateLimiter&) = delete;
+
+		//sets the limit of every host without its own limit
+		//@rate requests per second. unlimited if 0
+		//@burst max requests sent at once after idle
+		void setLimit(double rate, int burst);
+
+		//sets the limit of the host
+		void setLimit(const std::string& host, double rate, int burst);
+
+		//takes a token of the host, and returns milliseconds to wait until the token is available
+		//the token is reserved, so the request should be sent after the wait
+		int reserve(const std::string& host);
+
+		//takes a token of the host, blocking until it is available
+		void acquire(const std::string& host);
+
+		uint64_t getThrottled() const;
+
+		uint64_t getThrottledTime() const;
+
+		//host of the url. ex) api.chzzk.naver.com of https://api.chzzk.naver.com/service/v1/channels
+		static std::string host(const std::string& url);
+	};
+}
+
+#endif
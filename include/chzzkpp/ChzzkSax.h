@@ -0,0 +1,24 @@
+#pragma once
+#ifndef _CHZZK_SAX_
+#define _CHZZK_SAX_
+
+#include <string>
+#include "Config.h"
+#include "ChzzkFields.h"
+
+namespace chzzkpp
+{
+	//decodes json into the struct described by the table, straight from the token stream without building a json DOM
+	//fields missing in the json are left as they are, and null values reset the fields. unknown keys are skipped
+	//returns false if the json is invalid
+	//uses simdjson on-demand parser if _USE_SIMDJSON is set, and nlohmann::json sax parser otherwise. values of unknown keys may not be fully validated with simdjson
+	bool parse_stream(const std::string& data, const ChzzkFieldTable& table, void* object);
+
+	template <typename T>
+	bool parse_stream(const std::string& data, T& object)
+	{
+		return parse_stream(data, ChzzkFields<T>::table, &object);
+	}
+}
+
+#endif
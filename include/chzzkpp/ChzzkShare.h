@@ -0,0 +1,46 @@
+#pragma once
+#ifndef _CHZZK_SHARE_
+#define _CHZZK_SHARE_
+
+#include "Config.h"
+
+#if _USE_CURL
+#include <curl/curl.h>
+#endif
+
+#include <mutex>
+
+namespace chzzkpp
+{
+	//process-wide curl share object. handles using it share dns cache and tls sessions
+	//so reconnecting to the same host skips the dns lookup and resumes the tls session instead of a full handshake
+	//connection cache is not shared, since libcurl doesn't support sharing connections between concurrent threads
+	class ChzzkShare
+	{
+#if _USE_CURL
+		CURLSH* share;
+
+		std::mutex mutexes[CURL_LOCK_DATA_LAST];
+
+		static void lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+		static void unlock(CURL* handle, curl_lock_data data, void* userptr);
+#endif
+
+	public:
+		ChzzkShare();
+		~ChzzkShare();
+
+		ChzzkShare(const ChzzkShare&) = delete;
+		ChzzkShare& operator=(const ChzzkShare&) = delete;
+
+		//process-wide share object used by ChzzkCore and ChzzkChat
+		static ChzzkShare& shared();
+
+#if _USE_CURL
+		//makes the handle use the share object. the handle should be cleaned up before the share object is destroyed
+		void apply(CURL* handle);
+#endif
+	};
+}
+
+#endif
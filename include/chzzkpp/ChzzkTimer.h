@@ -0,0 +1,94 @@
+#pragma once
+#ifndef _CHZZK_TIMER_
+#define _CHZZK_TIMER_
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace chzzkpp
+{
+	//timer service running many timers on a single thread
+	//timers are kept in a min-heap. pushing a deadline later (rearm) only updates the timer, and the heap is fixed up lazily when the old deadline is reached
+	class ChzzkTimer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		using Callback = std::function<void()>;
+
+	private:
+		struct Timer
+		{
+			Callback callback;
+			int interval;
+			bool repeat;
+			Clock::time_point deadline;		//when the timer should fire
+			Clock::time_point scheduled;	//earliest time of the timer in the heap
+		};
+
+		struct Entry
+		{
+			Clock::time_point time;
+			size_t id;
+
+			bool operator>(const Entry& other) const
+			{
+				return time > other.time;
+			}
+		};
+
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+		std::unordered_map<size_t, std::shared_ptr<Timer>> timers;
+
+		std::mutex mutex;
+		std::condition_variable wakeup;
+		std::condition_variable finished;
+
+		std::thread thread;
+		std::thread::id threadID;
+		bool running;
+		size_t nextID;
+		size_t runningID;
+
+		void run();
+		void schedule(size_t id, Timer& timer, Clock::time_point deadline);
+
+	public:
+		ChzzkTimer();
+		~ChzzkTimer();
+
+		ChzzkTimer(const ChzzkTimer&) = delete;
+		ChzzkTimer& operator=(const ChzzkTimer&) = delete;
+
+		//process-wide timer shared by every chat
+		static ChzzkTimer& shared();
+
+		//adds a timer and returns its id. ids are never 0
+		//@interval milliseconds until the callback is called
+		//@repeat whether to call the callback again every interval milliseconds
+		size_t add(int interval, const Callback& callback, bool repeat = false);
+
+		//sets the deadline of the timer to interval milliseconds from now
+		//does nothing if the timer doesn't exist
+		void rearm(size_t id);
+
+		//sets the interval of the timer and rearms it
+		void rearm(size_t id, int interval);
+
+		//removes the timer. if the callback is running on another thread, waits until it finishes
+		void remove(size_t id);
+
+		bool exists(size_t id);
+
+		size_t size();
+	};
+}
+
+#endif
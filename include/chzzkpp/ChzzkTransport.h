@@ -0,0 +1,79 @@
+#pragma once
+#ifndef _CHZZK_TRANSPORT_
+#define _CHZZK_TRANSPORT_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace chzzkpp
+{
+	struct ChzzkHttpRequest
+	{
+		std::string url;
+		std::vector<std::string> headers;	//header lines like "Cookie: NID_AUT=...", including the conditional headers of the cache
+		int timeout;						//respond timeout seconds. never times out if 0
+	};
+
+	struct ChzzkHttpResponse
+	{
+		long status;			//http status code. 0 if failed
+		std::string body;		//raw response, or error string if failed
+		std::string etag;
+		std::string lastModified;
+		long long retryAfter;	//seconds of Retry-After header. 0 if not given
+		bool failed;			//whether the request failed without a response
+		bool transient;			//whether the failure is temporary, so the request may succeed if retried
+
+		ChzzkHttpResponse() : status(0), retryAfter(0), failed(false), transient(false)
+		{
+		}
+	};
+
+	//sends the requests of ChzzkCore instead of libcurl
+	//perform is called from several threads at once
+	class ChzzkHttpTransport
+	{
+	public:
+		virtual ~ChzzkHttpTransport() = default;
+
+		//performs the request, blocking until the response is received
+		virtual void perform(const ChzzkHttpRequest& request, ChzzkHttpResponse& response) = 0;
+	};
+
+	//called with each text frame of the socket
+	typedef std::function<void(std::string_view message)> ChzzkSocketMessageCallback;
+
+	//called when the socket is lost
+	typedef std::function<void(const std::string& error)> ChzzkSocketErrorCallback;
+
+	//websocket opened by ChzzkWebSocketTransport
+	class ChzzkWebSocket
+	{
+	public:
+		virtual ~ChzzkWebSocket() = default;
+
+		//sends a text frame. called from several threads, including the callbacks
+		virtual void send(const std::string& message) = 0;
+
+		//closes the socket. no callback is called after this returns
+		//the socket may be closed and destroyed in its own callbacks
+		virtual void close() = 0;
+	};
+
+	//opens the chat sockets of ChzzkChat instead of libcurl
+	class ChzzkWebSocketTransport
+	{
+	public:
+		virtual ~ChzzkWebSocketTransport() = default;
+
+		//opens the socket, blocking until connected. throws std::exception if failed
+		//callbacks are called one at a time, on a thread of the transport
+		//@timeout connection timeout seconds. never times out if 0
+		virtual std::unique_ptr<ChzzkWebSocket> open(const std::string& url, int timeout, const ChzzkSocketMessageCallback& onMessage, const ChzzkSocketErrorCallback& onError) = 0;
+	};
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 
+#include "ChzzkFields.h"
+
 namespace chzzkpp
 {
 	class invalid_status_exception : public std::exception
@@ -343,5 +345,401 @@ namespace chzzkpp
 		int failCheeringRate;			//pay amount rate when mission failed
 		int coolTime;					//mission cool time
 	};
+
+	//field tables of the structs, used by the decoders and the serializer
+
+	template <>
+	struct ChzzkFields<ChzzkUserData>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkUserData, &ChzzkUserData::hasProfile>("hasProfile"),
+			chzzk_field<ChzzkUserData, &ChzzkUserData::userIDHash>("userIdHash"),
+			chzzk_field<ChzzkUserData, &ChzzkUserData::nickname>("nickname"),
+			chzzk_field<ChzzkUserData, &ChzzkUserData::profileImageUrl>("profileImageUrl"),
+			chzzk_field<ChzzkUserData, &ChzzkUserData::penalties>("penalties"),
+			chzzk_field<ChzzkUserData, &ChzzkUserData::officialNotiAgree>("officialNotiAgree"),
+			chzzk_field<ChzzkUserData, &ChzzkUserData::officialNotiAgreeUpdatedDate>("officialNotiAgreeUpdateDate"),
+			chzzk_field<ChzzkUserData, &ChzzkUserData::verified>("verifiedMask"),
+			chzzk_field<ChzzkUserData, &ChzzkUserData::loggedIn>("loggedIn")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkAccessTokenTemporaryRestrict>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkAccessTokenTemporaryRestrict, &ChzzkAccessTokenTemporaryRestrict::createdTime>("createdTime"),
+			chzzk_field<ChzzkAccessTokenTemporaryRestrict, &ChzzkAccessTokenTemporaryRestrict::duration>("duration"),
+			chzzk_field<ChzzkAccessTokenTemporaryRestrict, &ChzzkAccessTokenTemporaryRestrict::temporaryRestrict>("temporaryRestrict"),
+			chzzk_field<ChzzkAccessTokenTemporaryRestrict, &ChzzkAccessTokenTemporaryRestrict::times>("times")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkAccessToken>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkAccessToken, &ChzzkAccessToken::accessToken>("accessToken"),
+			chzzk_field<ChzzkAccessToken, &ChzzkAccessToken::extraToken>("extraToken"),
+			chzzk_field<ChzzkAccessToken, &ChzzkAccessToken::realNameAuth>("realNameAuth"),
+			chzzk_object_field<ChzzkAccessToken, &ChzzkAccessToken::temporaryRestrict>("temporaryRestrict", ChzzkFields<ChzzkAccessTokenTemporaryRestrict>::table)
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkChannelFollowingInfo>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkChannelFollowingInfo, &ChzzkChannelFollowingInfo::following>("following"),
+			chzzk_field<ChzzkChannelFollowingInfo, &ChzzkChannelFollowingInfo::notification>("notification"),
+			chzzk_field<ChzzkChannelFollowingInfo, &ChzzkChannelFollowingInfo::followDate>("followDate")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table<ChzzkChannelFollowingInfo, &ChzzkChannelFollowingInfo::available>(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkChannelPersonalData>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_object_field<ChzzkChannelPersonalData, &ChzzkChannelPersonalData::followInfo>("following", ChzzkFields<ChzzkChannelFollowingInfo>::table),
+			chzzk_field<ChzzkChannelPersonalData, &ChzzkChannelPersonalData::privateUserBlock>("privateUserBlock")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table<ChzzkChannelPersonalData, &ChzzkChannelPersonalData::available>(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkSubscriptionPaymentAvailability>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkSubscriptionPaymentAvailability, &ChzzkSubscriptionPaymentAvailability::iapAvailability>("iapAvailability"),
+			chzzk_field<ChzzkSubscriptionPaymentAvailability, &ChzzkSubscriptionPaymentAvailability::iabAvailability>("iabAvailability")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkChannelInfo>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkChannelInfo, &ChzzkChannelInfo::ID>("channelId"),
+			chzzk_field<ChzzkChannelInfo, &ChzzkChannelInfo::name>("channelName"),
+			chzzk_field<ChzzkChannelInfo, &ChzzkChannelInfo::imageURL>("channelImageUrl"),
+			chzzk_field<ChzzkChannelInfo, &ChzzkChannelInfo::verified>("verifiedMask"),
+			chzzk_field<ChzzkChannelInfo, &ChzzkChannelInfo::description>("channelDescription"),
+			chzzk_field<ChzzkChannelInfo, &ChzzkChannelInfo::followerCount>("followerCount"),
+			chzzk_object_field<ChzzkChannelInfo, &ChzzkChannelInfo::personalData>("personalData", ChzzkFields<ChzzkChannelPersonalData>::table)
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkChannel>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkChannel, &ChzzkChannel::type>("channelType"),
+			chzzk_field<ChzzkChannel, &ChzzkChannel::openLive>("openLive"),
+			chzzk_field<ChzzkChannel, &ChzzkChannel::subscriptionAvailability>("subscriptionAvailability"),
+			//typo of the api
+			chzzk_object_field<ChzzkChannel, &ChzzkChannel::subscriptionPaymentAvailability>("sucbscriptionPaymentAvailability", ChzzkFields<ChzzkSubscriptionPaymentAvailability>::table),
+			chzzk_field<ChzzkChannel, &ChzzkChannel::adMonetizationAvailability>("adMonetizationAvailability")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_derived_table<ChzzkChannel, ChzzkChannelInfo>(fields, ChzzkFields<ChzzkChannelInfo>::table);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkLivePollingStatus>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkLivePollingStatus, &ChzzkLivePollingStatus::status>("status"),
+			chzzk_field<ChzzkLivePollingStatus, &ChzzkLivePollingStatus::isPublishing>("isPublishing"),
+			chzzk_field<ChzzkLivePollingStatus, &ChzzkLivePollingStatus::playableStatus>("playableStatus"),
+			chzzk_field<ChzzkLivePollingStatus, &ChzzkLivePollingStatus::trafficThrottling>("trafficThrottling"),
+			chzzk_field<ChzzkLivePollingStatus, &ChzzkLivePollingStatus::callPeriodMilliSecond>("callPeriodMilliSecond")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkLiveStatus>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::title>("liveTitle"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::status>("status"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::concurrentUserCount>("concurrentUserCount"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::accumulatedUserCount>("accumulateCount"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::paidPromotion>("paidPromotion"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::adult>("adult"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::krOnlyViewing>("krOnlyViewing"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::clipActive>("clipActive"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::chatChannelID>("chatChannelId"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::tags>("tags"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::categoryType>("categoryType"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::liveCategory>("liveCategory"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::liveCategoryValue>("liveCategoryValue"),
+			chzzk_nested_field<ChzzkLiveStatus, &ChzzkLiveStatus::livePollingStatus>("livePollingStatusJson", ChzzkFields<ChzzkLivePollingStatus>::table),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::faultStatus>("faultStatus"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::userAdultStatus>("userAdultStatus"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::blindType>("blindType"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::chatActive>("chatActive"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::chatAvailableGroup>("chatAvailableGroup"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::chatAvailableCondition>("chatAvailableCondition"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::minFollowerMinute>("minFollowerMinute"),
+			chzzk_field<ChzzkLiveStatus, &ChzzkLiveStatus::chatDonationRankingExposure>("chatDonationRankingExposure")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkLiveBase>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::ID>("liveId"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::title>("liveTitle"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::imageURL>("liveImageUrl"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::defaultThumbnailImageURL>("defaultThumbnailImageUrl"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::concurrentUserCount>("concurrentUserCount"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::accumulatedUserCount>("accumulateCount"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::openDate>("openDate"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::adult>("adult"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::tags>("tags"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::categoryType>("categoryType"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::liveCategory>("liveCategory"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::liveCategoryValue>("liveCategoryValue"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::channelID>("channelId"),
+			chzzk_field<ChzzkLiveBase, &ChzzkLiveBase::blindType>("blindType"),
+			chzzk_object_field<ChzzkLiveBase, &ChzzkLiveBase::channelInfo>("channel", ChzzkFields<ChzzkChannelInfo>::table)
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkLive>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkLive, &ChzzkLive::chatChannelID>("chatChannelId"),
+			chzzk_field<ChzzkLive, &ChzzkLive::livePlayback>("livePlaybackJson")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_derived_table<ChzzkLive, ChzzkLiveBase>(fields, ChzzkFields<ChzzkLiveBase>::table);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkLiveDetail>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::status>("status"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::closeDate>("closeDate"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::clipActive>("clipActive"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::chatActive>("chatActive"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::chatAvailableGroup>("chatAvailableGroup"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::chatAvailableCondition>("chatAvailableCondition"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::minFollowerMinute>("minFollowerMinute"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::p2pQuality>("p2pQuality"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::userAdultStatus>("userAdultStatus"),
+			chzzk_field<ChzzkLiveDetail, &ChzzkLiveDetail::chatDonationRankingExposure>("chatDonationRankingExposure"),
+			chzzk_raw_field<ChzzkLiveDetail, &ChzzkLiveDetail::adParameter>("adParameter")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_derived_table<ChzzkLiveDetail, ChzzkLive>(fields, ChzzkFields<ChzzkLive>::table);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkVideoInfo>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::videoNo>("videoNo"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::ID>("videoId"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::title>("videoTitle"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::type>("videoType"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::publishDate>("publishDate"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::thumbnailImageURL>("thumbnailImageUrl"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::duration>("duration"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::readCount>("readCount"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::channelID>("channelId"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::publishDateAt>("publishDateAt"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::adult>("adult"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::categoryType>("categoryType"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::videoCategory>("videoCategory"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::videoCategoryValue>("videoCategoryValue"),
+			chzzk_field<ChzzkVideoInfo, &ChzzkVideoInfo::blindType>("blindType")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkVideo>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_object_field<ChzzkVideo, &ChzzkVideo::channelInfo>("channel", ChzzkFields<ChzzkChannelInfo>::table),
+			chzzk_field<ChzzkVideo, &ChzzkVideo::exposure>("exposure"),
+			chzzk_field<ChzzkVideo, &ChzzkVideo::clipActive>("clipActive"),
+			chzzk_field<ChzzkVideo, &ChzzkVideo::inKey>("inKey"),
+			chzzk_field<ChzzkVideo, &ChzzkVideo::liveOpenDate>("liveOpenDate"),
+			chzzk_field<ChzzkVideo, &ChzzkVideo::vodStatus>("vodStatus"),
+			chzzk_raw_field<ChzzkVideo, &ChzzkVideo::prevVideo>("prevVideo"),
+			chzzk_raw_field<ChzzkVideo, &ChzzkVideo::nextVideo>("nextVideo"),
+			chzzk_field<ChzzkVideo, &ChzzkVideo::userAdultStatus>("userAdultStatus"),
+			chzzk_raw_field<ChzzkVideo, &ChzzkVideo::adParameter>("adParameter")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_derived_table<ChzzkVideo, ChzzkVideoInfo>(fields, ChzzkFields<ChzzkVideoInfo>::table);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkRecommendChannel>
+	{
+		//fields in the channel object
+		static constexpr ChzzkField channelFields[] = {
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::name>("channelName"),
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::imageURL>("channelImageUrl"),
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::verified>("verifiedMask")
+		};
+
+		static constexpr ChzzkFieldTable channelTable = chzzk_table(channelFields);
+
+		//fields in the streamer object
+		static constexpr ChzzkField streamerFields[] = {
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::openLive>("openLive")
+		};
+
+		static constexpr ChzzkFieldTable streamerTable = chzzk_table(streamerFields);
+
+		//fields in the liveInfo object
+		static constexpr ChzzkField liveInfoFields[] = {
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::title>("liveTitle"),
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::concurrentUserCount>("concurrentUserCount"),
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::liveCategoryValue>("liveCategoryValue")
+		};
+
+		static constexpr ChzzkFieldTable liveInfoTable = chzzk_table(liveInfoFields);
+
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::ID>("channelId"),
+			chzzk_inline_field("channel", channelTable),
+			chzzk_inline_field("streamer", streamerTable),
+			chzzk_inline_field("liveInfo", liveInfoTable),
+			chzzk_field<ChzzkRecommendChannel, &ChzzkRecommendChannel::contentLineage>("contentLineage")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkRecommendPartnerChannel>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::ID>("channelId"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::imageURL>("channelImageUrl"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::originalName>("originalNickname"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::name>("channelName"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::verified>("verifiedMask"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::openLive>("openLive"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::isNewStreamer>("newStreamer"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::title>("liveTitle"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::concurrentUserCount>("concurrentUserCount"),
+			chzzk_field<ChzzkRecommendPartnerChannel, &ChzzkRecommendPartnerChannel::liveCategoryValue>("liveCategoryValue")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkMissionInfo>
+	{
+		//fields in the user object
+		static constexpr ChzzkField userFields[] = {
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::userIdHash>("userIdHash"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::userNickname>("nickname"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::userProfileImageURL>("profileImageUrl"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::userVerified>("verifiedMask")
+		};
+
+		static constexpr ChzzkFieldTable userTable = chzzk_table(userFields);
+
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::ID>("missionDonationId"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::missionText>("missionText"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::channelID>("channelId"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::type>("missionType"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::amount>("amount"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::failCheeringRate>("failCheeringRate"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::status>("status"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::success>("success"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::durationTime>("missionDurationTime"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::startTime>("missionStartTime"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::endTime>("missionEndTime"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::createdTime>("createdTime"),
+			chzzk_inline_field("user", userTable),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::anonymous>("anonymous"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::totalAmount>("totalAmount"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::missionType>("missionType"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::participationCount>("participationCount"),
+			chzzk_field<ChzzkMissionInfo, &ChzzkMissionInfo::relatedMissionID>("relatedMissionDonationId")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkDonationSetting>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkDonationSetting, &ChzzkDonationSetting::active>("donationActive"),
+			chzzk_field<ChzzkDonationSetting, &ChzzkDonationSetting::minCurrencyPayAmount>("minCurrencyPayAmount")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_table(fields);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkChatDonationSetting>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkChatDonationSetting, &ChzzkChatDonationSetting::exposureDonationAmount>("exposureDonationAmount")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_derived_table<ChzzkChatDonationSetting, ChzzkDonationSetting>(fields, ChzzkFields<ChzzkDonationSetting>::table);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkVideoDonationSetting>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkVideoDonationSetting, &ChzzkVideoDonationSetting::payAmountPerSecond>("payAmountPerSecond"),
+			chzzk_field<ChzzkVideoDonationSetting, &ChzzkVideoDonationSetting::maxDurationLength>("maxDurationLength"),
+			chzzk_field<ChzzkVideoDonationSetting, &ChzzkVideoDonationSetting::isYoutubeAllowed>("isYoutubeVideoAllow"),
+			chzzk_field<ChzzkVideoDonationSetting, &ChzzkVideoDonationSetting::isChzzkClipAllowed>("isChzzkClipAllow"),
+			chzzk_field<ChzzkVideoDonationSetting, &ChzzkVideoDonationSetting::isAllowedForSubscribers>("isAllowForSubscriber")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_derived_table<ChzzkVideoDonationSetting, ChzzkDonationSetting>(fields, ChzzkFields<ChzzkDonationSetting>::table);
+	};
+
+	template <>
+	struct ChzzkFields<ChzzkMissionDonationSetting>
+	{
+		static constexpr ChzzkField fields[] = {
+			chzzk_field<ChzzkMissionDonationSetting, &ChzzkMissionDonationSetting::maxCurrencyPayAmount>("maxCurrencyPayAmount"),
+			chzzk_field<ChzzkMissionDonationSetting, &ChzzkMissionDonationSetting::failCheeringRate>("failCheeringRate"),
+			chzzk_field<ChzzkMissionDonationSetting, &ChzzkMissionDonationSetting::coolTime>("cooltime")
+		};
+
+		static constexpr ChzzkFieldTable table = chzzk_derived_table<ChzzkMissionDonationSetting, ChzzkDonationSetting>(fields, ChzzkFields<ChzzkDonationSetting>::table);
+	};
 }
 #endif
\ No newline at end of file
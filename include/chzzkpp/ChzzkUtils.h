@@ -6,21 +6,35 @@
 #include <sstream>
 #include <nlohmann/json.hpp>
 #include "ChzzkTypes.h"
+#include "ChzzkChatTypes.h"
 
 namespace chzzkpp
 {
+	class ChzzkChatView;
+
 	std::string convertUTF8(const std::string& str);
 
 	std::string encodeURL(const std::string& str);
 
 	//sets dest with json[key] if exists and not null, otherwise with default value
 	template <typename T>
-	void json_safe_get(T& dest, const nlohmann::json& json, const std::string& key)
+	void json_safe_get(T& dest, const nlohmann::json& json, const char* key)
 	{
-		if (json.find(key) != json.end() && !json[key].is_null()) dest = json[key];
+		auto it = json.find(key);
+
+		if (it != json.end() && !it->is_null()) it->get_to(dest);
 		else dest = T();
 	}
 
+	//returns json[key] if exists, otherwise null json. safe to use with const json
+	inline const nlohmann::json& json_safe_child(const nlohmann::json& json, const char* key)
+	{
+		static const nlohmann::json null_json;
+
+		auto it = json.find(key);
+		return it != json.end() ? *it : null_json;
+	}
+
 	template <typename T>
 	T json_safe_get(const nlohmann::json& json)
 	{
@@ -38,11 +52,52 @@ namespace chzzkpp
 		return ret;
 	}
 
+	//decodes the json object into the struct described by the table, in a single pass over the keys of the json
+	//fields missing in the json are left as they are, and null values reset the fields. values of other types than the fields are ignored
+	void parse_table(const nlohmann::json& json, const ChzzkFieldTable& table, void* object);
+
+	//parse_table with the json object encoded in the string. ignored if the string is not a json object
+	void parse_nested(const std::string& text, const ChzzkFieldTable& table, void* object);
+
+	//makes the json object of the struct described by the table. RAW fields are parsed back into json values
+	nlohmann::json dump_table(const ChzzkFieldTable& table, const void* object);
+
+	//parses the struct with its field table in ChzzkTypes.h or ChzzkChatTypes.h
+	template <typename T>
+	T parse(const nlohmann::json& json)
+	{
+		T object = T();
+		parse_table(json, ChzzkFields<T>::table, &object);
+
+		return object;
+	}
+
+	//makes the json of the struct with its field table, which parse<T> reads back
+	template <typename T>
+	nlohmann::json serialize(const T& object)
+	{
+		return dump_table(ChzzkFields<T>::table, &object);
+	}
+
+	//nlohmann::json conversions of the structs with field tables. ex) nlohmann::json json = channel; auto live = json.get<ChzzkLive>();
+	template <typename T, typename = decltype(ChzzkFields<T>::table)>
+	void to_json(nlohmann::json& json, const T& object)
+	{
+		json = serialize(object);
+	}
+
+	template <typename T, typename = decltype(ChzzkFields<T>::table)>
+	void from_json(const nlohmann::json& json, T& object)
+	{
+		object = parse<T>(json);
+	}
+
+	//parses chat message structs from the lazy view. nested json is parsed only if the struct needs it
 	template <typename T>
-	T parse(nlohmann::json json);
+	T parse_view(const ChzzkChatView& view);
 
 	template <typename T>
-	T parse_raw(std::string raw_data)
+	T parse_raw(const std::string& raw_data)
 	{
 		nlohmann::json json = nlohmann::json::parse(raw_data);
 		return parse<T>(json);
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef _CHZZK_WORKER_
+#define _CHZZK_WORKER_
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+
+namespace chzzkpp
+{
+	//threads running blocking work handed off by the timer and the event loops, ex) polling and reconnecting chats
+	//so a slow request never delays the timers or the messages of other chats
+	class ChzzkWorker
+	{
+	public:
+		using Task = std::function<void()>;
+
+	private:
+		std::deque<Task> tasks;
+
+		std::mutex mutex;
+		std::condition_variable wakeup;
+
+		std::vector<std::thread> threads;
+		bool running;
+
+		void run();
+
+	public:
+		const static size_t DEFAULT_THREAD_COUNT = 4;
+
+		//@threadCount number of threads. tasks are run in the order they are posted, but may overlap with more than one thread
+		ChzzkWorker(size_t threadCount = DEFAULT_THREAD_COUNT);
+
+		//runs the tasks left in the queue before returning
+		~ChzzkWorker();
+
+		ChzzkWorker(const ChzzkWorker&) = delete;
+		ChzzkWorker& operator=(const ChzzkWorker&) = delete;
+
+		//process-wide worker shared by every chat
+		static ChzzkWorker& shared();
+
+		void post(const Task& task);
+
+		//number of tasks waiting for a thread
+		size_t size();
+	};
+}
+
+#endif
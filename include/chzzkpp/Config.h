@@ -6,6 +6,16 @@
 #define _USE_CURL 1
 #endif
 
+//decodes api responses with the field tables and chat frames with simdjson on-demand parser. needs simdjson to be linked
+#ifndef _USE_SIMDJSON
+#define _USE_SIMDJSON 0
+#endif
+
+//compresses the chat logs of ChzzkChatRecorder with zlib. needs zlib to be linked
+#ifndef _USE_ZLIB
+#define _USE_ZLIB 0
+#endif
+
 namespace chzzkpp
 {
 	namespace config
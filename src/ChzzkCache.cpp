@@ -0,0 +1,153 @@
+#include <chzzkpp/ChzzkCache.h>
+
+namespace chzzkpp
+{
+	ChzzkCache::ChzzkCache(size_t capacity) : capacity(capacity), bytes(0), hits(0), misses(0), revalidated(0), evictions(0)
+	{
+		for (auto& seconds : ttl)
+			seconds = 0;
+
+		//data which rarely changes
+		ttl[(size_t)ChzzkEndpoint::CHANNEL] = 60;
+		ttl[(size_t)ChzzkEndpoint::VIDEO] = 60;
+		ttl[(size_t)ChzzkEndpoint::CHAT_DONATION_SETTING] = 300;
+		ttl[(size_t)ChzzkEndpoint::VIDEO_DONATION_SETTING] = 300;
+		ttl[(size_t)ChzzkEndpoint::MISSION_DONATION_SETTING] = 300;
+	}
+
+	void ChzzkCache::erase(std::list<Node>::iterator it)
+	{
+		bytes -= it->bytes;
+
+		index.erase(it->key);
+		nodes.erase(it);
+	}
+
+	void ChzzkCache::shrink(size_t limit)
+	{
+		while (bytes > limit && !nodes.empty())
+		{
+			erase(std::prev(nodes.end()));
+			evictions++;
+		}
+	}
+
+	ChzzkCache::Lookup ChzzkCache::find(const std::string& key, ChzzkCacheEntry& entry)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		auto it = index.find(key);
+
+		if (it == index.end())
+		{
+			misses++;
+			return Lookup::NONE;
+		}
+
+		nodes.splice(nodes.begin(), nodes, it->second);
+		entry = it->second->entry;
+
+		if (Clock::now() < it->second->expires)
+		{
+			hits++;
+			return Lookup::FRESH;
+		}
+
+		misses++;
+		return Lookup::STALE;
+	}
+
+	void ChzzkCache::store(const std::string& key, ChzzkCacheEntry&& entry, int ttl)
+	{
+		if (ttl <= 0) return;
+
+		size_t size = sizeof(Node) + key.size() + entry.response.size() + entry.etag.size() + entry.lastModified.size();
+
+		std::lock_guard<std::mutex> guard(mutex);
+
+		//response bigger than the cache itself is not stored
+		if (size > capacity) return;
+
+		auto it = index.find(key);
+		if (it != index.end()) erase(it->second);
+
+		shrink(capacity - size);
+
+		nodes.push_front({ key, std::move(entry), Clock::now() + std::chrono::seconds(ttl), size });
+		index[key] = nodes.begin();
+
+		bytes += size;
+	}
+
+	bool ChzzkCache::refresh(const std::string& key, int ttl, ChzzkCacheEntry& entry)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		auto it = index.find(key);
+		if (it == index.end()) return false;
+
+		it->second->expires = Clock::now() + std::chrono::seconds(ttl);
+		entry = it->second->entry;
+
+		revalidated++;
+		return true;
+	}
+
+	void ChzzkCache::clear()
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		nodes.clear();
+		index.clear();
+		bytes = 0;
+	}
+
+	void ChzzkCache::setCapacity(size_t capacity)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		this->capacity = capacity;
+		shrink(capacity);
+	}
+
+	size_t ChzzkCache::getCapacity()
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return capacity;
+	}
+
+	void ChzzkCache::setTTL(ChzzkEndpoint endpoint, int ttl)
+	{
+		if (endpoint >= ChzzkEndpoint::COUNT) return;
+
+		std::lock_guard<std::mutex> guard(mutex);
+		this->ttl[(size_t)endpoint] = ttl;
+	}
+
+	int ChzzkCache::getTTL(ChzzkEndpoint endpoint)
+	{
+		if (endpoint >= ChzzkEndpoint::COUNT) return 0;
+
+		std::lock_guard<std::mutex> guard(mutex);
+		return ttl[(size_t)endpoint];
+	}
+
+	ChzzkCacheStats ChzzkCache::getStats()
+	{
+		ChzzkCacheStats stats;
+
+		stats.hits = hits;
+		stats.misses = misses;
+		stats.revalidated = revalidated;
+		stats.evictions = evictions;
+
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+
+			stats.entries = nodes.size();
+			stats.bytes = bytes;
+		}
+
+		return stats;
+	}
+}
@@ -1,55 +1,152 @@
 #include <chzzkpp/ChzzkChat.h>
 #include <chzzkpp/Path.h>
 #include <chzzkpp/ChzzkUtils.h>
+#include <chzzkpp/ChzzkShare.h>
 
 #if _DEBUG
 #include <iostream>
 #endif
 
+#include <cstring>
+
+#if _USE_SIMDJSON
+#include <simdjson.h>
+#endif
+
+#if _USE_CURL && !defined(_WIN32)
+#include <poll.h>
+#endif
+
 namespace chzzkpp
 {
 	///////////////////////////
 	///////////////////////////
 	//// libcurl implementation
 
-	ChzzkChat::ChzzkChat(ChzzkClient* client, ChzzkChatOptions option, int timeout) : client(client), option(option), sid(""), uid(""), connected(false), reconnecting(false), isPolling(false), isPinging(false), timeout(timeout)
+	ChzzkChat::ChzzkChat(ChzzkClient* client, ChzzkChatOptions option, int timeout) : client(client), option(option), timeout(timeout), sid(""), uid(""), connected(false), chat_connected(false), reconnecting(false),
+		timer(&ChzzkTimer::shared()), pollTimerID(0), pingTimerID(0), worker(&ChzzkWorker::shared()), pollQueued(false), pendingTasks(0), connectionID(0), reopenAttempts(0)
 	{
 		curl = nullptr;
+		activeSocket = CURL_SOCKET_BAD;
+		connectTime = 0;
+		receiveSize = 0;
+		frameStart = 0;
+		receivedTime = 0;
+		nextHandlerID = 0;
+
+		if (option.trackLatency) latency = std::make_unique<ChzzkLatencyTracker>();
+
+		if (option.dispatchMode == ChzzkDispatchMode::QUEUED)
+		{
+			dispatcher = std::make_unique<ChzzkDispatcher<ChzzkDispatchItem>>(option.dispatchQueueSize, option.dispatchWorkers, option.overflowPolicy,
+				[this](ChzzkDispatchItem& item) {
+					if (item.view) callChat(item.type, *item.view, item.received);
+					else call(item.type, item.message, item.received);
+				},
+				//only the notice is a state, where the latest one is enough. every chat, donation and blind is its own message
+				[](const ChzzkDispatchItem& item) { return item.type == ChzzkChatEvent::NOTICE ? (size_t)item.type : ChzzkDispatcher<ChzzkDispatchItem>::UNIQUE_KEY; },
+				//the connection events are never dropped, so the handlers always see the connection state
+				[](const ChzzkDispatchItem& item) { return item.type != ChzzkChatEvent::CONNECT && item.type != ChzzkChatEvent::RECONNECT && item.type != ChzzkChatEvent::DISCONNECT; });
+		}
+
+		fastParser = std::make_unique<FastParser>();
 	}
 
 	ChzzkChat::~ChzzkChat()
 	{
-		if (connected) _close();
+		{
+			std::lock_guard<std::mutex> guard(stateMutex);
+
+			reconnecting = false;
+			if (connected) _close();
+		}
+
+		stopPolling();
+		stopPing();
+
+		//a queued poll could still be running
+		waitTasks();
+
+		//handles the rest of the queue before removing handlers
+		dispatcher.reset();
 		removeAllHandlers();
 	}
 
+	//blocks until the socket is readable or timeoutMs passes
+	//returns false if timed out
+	static bool waitSocket(curl_socket_t socket, int timeoutMs)
+	{
+#ifdef _WIN32
+		WSAPOLLFD fd = {};
+		fd.fd = socket;
+		fd.events = POLLRDNORM;
+
+		return WSAPoll(&fd, 1, timeoutMs) != 0;
+#else
+		pollfd fd = {};
+		fd.fd = socket;
+		fd.events = POLLIN;
+
+		return poll(&fd, 1, timeoutMs) != 0;
+#endif
+	}
+
 	void ChzzkChat::_receive()
+	{
+		while (connected)
+		{
+			curl_socket_t socket = activeSocket;
+
+			//the socket is lost. the reconnect on the worker starts a new receiver
+			if (socket == CURL_SOCKET_BAD) break;
+
+			//wait for the socket without holding the lock. timeout is only for checking the connection state
+
+			if (waitSocket(socket, RECEIVE_WAIT_TIME)) _drain();
+		}
+	}
+
+	size_t ChzzkChat::_drain()
 	{
 		size_t len;
 		const struct curl_ws_frame* meta;
-		std::string message;
+		bool failed = false;
+
+		receivedFrames.clear();
 
-				while (connected)
 		{
+			std::lock_guard<std::mutex> guard(socketMutex);
+			if (!connected || !curl) return 0;
+
+			//drain every frame available on this wakeup
+			while (true)
 			{
-				std::lock_guard<std::mutex> guard(receiverMutex);
-				if (!connected) break;
+				if (receiveBuffer.size() - receiveSize < RECEIVE_CHUNK_SIZE)
+					receiveBuffer.resize(receiveSize + RECEIVE_CHUNK_SIZE);
 
-				char buffer[256];
-				CURLcode res = curl_ws_recv(curl, buffer, 255, &len, &meta);
+				CURLcode res = curl_ws_recv(curl, receiveBuffer.data() + receiveSize, receiveBuffer.size() - receiveSize, &len, &meta);
 
 				if (res == CURLE_OK)
 				{
-					buffer[len] = 0;
-					message += buffer;
+					receiveSize += len;
 
-					if (!meta->bytesleft)
+					if (meta->bytesleft)
 					{
-						onMessage(message.data());
-						message.clear();
+						//grow once to fit the rest of the frame
+						if (receiveBuffer.size() < receiveSize + (size_t)meta->bytesleft)
+							receiveBuffer.resize(receiveSize + (size_t)meta->bytesleft);
+					}
+					else if (!(meta->flags & CURLWS_CONT))
+					{
+						if (meta->flags & CURLWS_CLOSE) receiveSize = frameStart; //not a message
+						else receivedFrames.emplace_back(frameStart, receiveSize - frameStart);
+
+						frameStart = receiveSize;
 					}
 				}
-				else if (res != CURLE_AGAIN)
+				else if (res == CURLE_AGAIN)
+					break;
+				else
 				{
 					static const std::string ERR_MSG = "Error occured receiving message: ";
 
@@ -58,106 +155,198 @@ namespace chzzkpp
 					std::cerr << "Trying to reopen the chat socket..." << std::endl;
 #endif
 
-					message.clear();
-					_reopen();
+					receiveSize = frameStart; //drop the partial frame
+
+					//stops waiting for the broken socket. the handle is replaced by the reconnect on the worker
+					activeSocket = CURL_SOCKET_BAD;
+					failed = true;
+					break;
 				}
 			}
+		}
+
+		if (failed) queueReconnect();
 
-			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		//handlers are called outside of the receiver lock
+		for (auto& frame : receivedFrames)
+			onMessage(std::string_view(receiveBuffer.data() + frame.first, frame.second));
+
+		//move the partial frame to the front for the next wakeup
+		if (frameStart)
+		{
+			std::memmove(receiveBuffer.data(), receiveBuffer.data() + frameStart, receiveSize - frameStart);
+			receiveSize -= frameStart;
+			frameStart = 0;
 		}
+
+		return receivedFrames.size();
 	}
 
-	void ChzzkChat::_reopen()
+	//updates the socket which the receiver waits for
+	static curl_socket_t getActiveSocket(CURL* curl)
 	{
-		size_t sent;
-		curl_ws_send(curl, "", 0, &sent, 0, CURLWS_CLOSE);
+		curl_socket_t socket = CURL_SOCKET_BAD;
+		curl_easy_getinfo(curl, CURLINFO_ACTIVESOCKET, &socket);
 
-		onClose();
+		return socket;
+	}
 
-		curl = curl_easy_init();
+	CURLcode ChzzkChat::_open(CURL*& handle)
+	{
+		//initialize the curl
+		handle = curl_easy_init();
 
-		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+		curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+		curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
 
-		curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 2L);
+		curl_easy_setopt(handle, CURLOPT_CONNECT_ONLY, 2L);
 
-		curl_easy_setopt(curl, CURLOPT_URL, ws_path.c_str());
-		curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, timeout);
+		curl_easy_setopt(handle, CURLOPT_URL, ws_path.c_str());
+		curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, timeout);
 
-		CURLcode res = curl_easy_perform(curl);
+		if (option.shareConnection) ChzzkShare::shared().apply(handle);
 
-		if (res != CURLE_OK)
-			throw std::exception(curl_easy_strerror(res));
-		else
-		{
-			connected = true;
-
-			nlohmann::json body = {
-					{"accTkn", option.accessToken},
-					{"auth", uid.empty() ? "READ" : "SEND"},
-					{"devType", 2001},
-					{"uid", uid}
-			};
+		CURLcode res = curl_easy_perform(handle);
 
-			nlohmann::json json = {
-				{"bdy", body },
-				{"cmd", ChatCommand::CONNECT},
-				{"tid", 1}
-			};
-
-			json.update(_default);
+		curl_off_t time = 0;
+		curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME_T, &time);
+		connectTime = time;
 
-			_send(json.dump());
+		if (res != CURLE_OK)
+		{
+			curl_easy_cleanup(handle);
+			handle = nullptr;
 		}
+
+		return res;
 	}
 
 	void ChzzkChat::_connect()
 	{
-		std::lock_guard<std::mutex> guard(receiverMutex);
-
-		//initialize the curl
-		curl = curl_easy_init();
-
-		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+		if (option.transport)
+		{
+			auto opened = openSocket();
 
-		curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 2L);
+			{
+				std::lock_guard<std::mutex> guard(socketMutex);
+				socket = std::move(opened);
+			}
 
-		curl_easy_setopt(curl, CURLOPT_URL, ws_path.c_str());
-		curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, timeout);
+			onOpen();
+			return;
+		}
 
-		CURLcode res = curl_easy_perform(curl);
+		//connects without the lock, since nothing else uses the new handle yet
+		CURL* handle;
+		CURLcode res = _open(handle);
 
 		if (res != CURLE_OK)
 			throw std::exception(curl_easy_strerror(res));
-		else
-			onOpen();
+
+		{
+			std::lock_guard<std::mutex> guard(socketMutex);
+
+			curl = handle;
+			activeSocket = getActiveSocket(curl);
+			receiveSize = 0;
+			frameStart = 0;
+		}
+
+		onOpen();
 	}
 
 	void ChzzkChat::_close()
 	{
+		if (option.transport)
 		{
-			std::lock_guard<std::mutex> guard(receiverMutex);
-			size_t sent;
-			curl_ws_send(curl, "", 0, &sent, 0, CURLWS_CLOSE);
+			std::unique_ptr<ChzzkWebSocket> closing;
+
+			{
+				std::lock_guard<std::mutex> guard(socketMutex);
+				closing = std::move(socket);
+			}
 
 			onClose();
+
+			//no message is handled after the socket is closed. closed outside the lock, since it waits for the thread of the transport
+			if (closing) closing->close();
+
+			stopTimers();
+			return;
+		}
+
+		CURL* closing;
+
+		{
+			std::lock_guard<std::mutex> guard(socketMutex);
+
+			closing = curl;
+			curl = nullptr;
+			activeSocket = CURL_SOCKET_BAD;
+
+			size_t sent;
+			if (closing) curl_ws_send(closing, "", 0, &sent, 0, CURLWS_CLOSE);
 		}
 
+		//handlers of DISCONNECT can send, so they are called outside the lock
+		onClose();
+
+		if (option.hub) option.hub->detach(this);
 		if (receiverThread.joinable()) receiverThread.join();
 
-		curl_easy_cleanup(curl);
-		curl = nullptr;
+		//receiver could have rearmed the ping while closing
+		stopTimers();
+
+		//nothing uses the handle after the receiver stopped
+		if (closing) curl_easy_cleanup(closing);
+		receiveSize = 0;
+		frameStart = 0;
 	}
 
 	void ChzzkChat::_send(const std::string& message)
 	{
+		//the timer, the receiver and user threads send at once, and a curl handle can't be used by two threads together
+		std::lock_guard<std::mutex> guard(socketMutex);
+
+		if (option.transport)
+		{
+			if (socket) socket->send(message);
+			return;
+		}
+
+		if (!curl) return; //closed
+
 		size_t len = message.size();
 		size_t sent;
 
 		curl_ws_send(curl, message.c_str(), len, &sent, 0, CURLWS_TEXT);
 	}
 
+	std::unique_ptr<ChzzkWebSocket> ChzzkChat::openSocket()
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		auto opened = option.transport->open(ws_path, timeout,
+			[this](std::string_view message) { onMessage(message); },
+			[this](const std::string& error) { onSocketError(error); });
+
+		connectTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+		return opened;
+	}
+
+	void ChzzkChat::onSocketError([[maybe_unused]] const std::string& error)
+	{
+		if (!connected) return;
+
+#if _DEBUG
+		std::cerr << "Error occured receiving message: " << error << std::endl;
+		std::cerr << "Trying to reopen the chat socket..." << std::endl;
+#endif
+
+		queueReconnect();
+	}
+
 	///////////////////////////
 	///////////////////////////
 	//// private common methods
@@ -165,6 +354,7 @@ namespace chzzkpp
 	void ChzzkChat::onOpen()
 	{
 		connected = true;
+		connectionID++;
 
 		nlohmann::json body = {
 				{"accTkn", option.accessToken},
@@ -183,192 +373,949 @@ namespace chzzkpp
 		_send(json.dump());
 
 #if _USE_CURL
-		receiverThread = std::thread(std::bind(&ChzzkChat::_receive, this));
+		//transports handle the messages on their own threads
+		if (!option.transport)
+		{
+			if (option.hub) option.hub->attach(this);
+			else receiverThread = std::thread(std::bind(&ChzzkChat::_receive, this));
+		}
 #endif
 
 		if (!reconnecting) startPolling();
 
 	}
 
+	//timers are stopped by the caller after releasing socketMutex, since removing a timer waits for its callback
 	void ChzzkChat::onClose()
 	{
 		if (!reconnecting)
 		{
-			call(ChzzkChatEvent::DISCONNECT, option.chatChannelID);
-
-			stopPolling();
+			dispatch(ChzzkChatEvent::DISCONNECT, option.chatChannelID);
 			option.chatChannelID = "";
 		}
 
-		stopPing();
-		sid = "";
+		{
+			std::lock_guard<std::mutex> guard(sessionMutex);
+			sid = "";
+			uid = "";
+		}
 
 		option.accessToken = "";
-		uid = "";
 		
 		chat_connected = false;
 		connected = false;
 	}
 
+	void ChzzkChat::stopTimers()
+	{
+		stopPing();
+		if (!reconnecting) stopPolling();
+	}
+
+	void ChzzkChat::post(const std::function<void()>& task)
+	{
+		{
+			std::lock_guard<std::mutex> guard(taskMutex);
+			pendingTasks++;
+		}
+
+		worker->post([this, task]() {
+			try
+			{
+				task();
+			}
+			catch (std::exception& e)
+			{
+#if _DEBUG
+				std::cerr << "Error occured on chat task: " << e.what() << std::endl;
+#endif
+			}
+
+			//notified under the lock, so the chat is not destroyed before this returns
+			std::lock_guard<std::mutex> guard(taskMutex);
+			pendingTasks--;
+			taskFinished.notify_all();
+		});
+	}
+
+	void ChzzkChat::waitTasks()
+	{
+		std::unique_lock<std::mutex> lock(taskMutex);
+		taskFinished.wait(lock, [&]() { return pendingTasks == 0; });
+	}
+
+	void ChzzkChat::queuePoll()
+	{
+		if (pollQueued.exchange(true)) return;
+
+		post([this]() {
+			updateChatChannelID();
+			pollQueued = false;
+		});
+	}
+
+	void ChzzkChat::queueReconnect()
+	{
+		uint64_t current = connectionID;
+
+		post([this, current]() {
+			std::lock_guard<std::mutex> guard(stateMutex);
+
+			//closed or reconnected meanwhile
+			if (connectionID != current) return;
+
+			//the server keeps dropping the socket. closes like close()
+			if (++reopenAttempts > MAX_REOPEN_ATTEMPTS)
+			{
+				reconnecting = false;
+				_close();
+				return;
+			}
+
+			reconnect();
+		});
+	}
+
 	void ChzzkChat::reconnect()
 	{
+		if (!connected) return; //closed meanwhile
+
 		reconnecting = true;
+		_close();
 
-		if (connected)
+		try
+		{
+			connectChat();
+		}
+		catch (std::exception& e)
 		{
-			close();
-			connect();
+#if _DEBUG
+			std::cerr << "Error occured while reconnecting the chat: " << e.what() << std::endl;
+#endif
+			//gives up like close()
+			reconnecting = false;
+
+			dispatch(ChzzkChatEvent::DISCONNECT, option.chatChannelID);
+			option.chatChannelID = "";
+
+			stopPolling();
 		}
 	}
 
+	//runs on the worker
 	void ChzzkChat::updateChatChannelID()
 	{
-		int pollCount = option.pollTime;
+		if (!chat_connected) return;
 
-		while (!chat_connected || !isPolling)
-			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		ChzzkLiveStatus status;
 
-		while (chat_connected && isPolling)
+		try
 		{
-			if (pollCount >= option.pollTime)
-			{
-				auto currentChatChannelID = client->getLiveStatus(option.channelID).chatChannelID;
+			status = client->getLiveStatus(option.channelID);
+		}
+		catch (std::exception& e)
+		{
+#if _DEBUG
+			std::cerr << "Error occured while polling chatChannelID: " << e.what() << std::endl;
+#endif
+			size_t id = pollTimerID;
+			if (id && option.adaptivePolling) timer->rearm(id, pollSchedule.fail());
 
-				if (!currentChatChannelID.empty() && currentChatChannelID != option.chatChannelID)
-				{
-					option.chatChannelID = currentChatChannelID;
+			return;
+		}
 
-					reconnect();
-				}
+		if (option.adaptivePolling)
+		{
+			size_t id = pollTimerID;
+			if (id) timer->rearm(id, pollSchedule.next(status.livePollingStatus));
+		}
 
-				pollCount = 0;
-			}
+		auto& currentChatChannelID = status.chatChannelID;
+		if (currentChatChannelID.empty()) return;
+
+		std::lock_guard<std::mutex> guard(stateMutex);
 
-			std::this_thread::sleep_for(std::chrono::milliseconds(10));
-			pollCount += 10;
+		if (connected && currentChatChannelID != option.chatChannelID)
+		{
+			option.chatChannelID = currentChatChannelID;
+
+			reconnect();
 		}
 	}
 
 	void ChzzkChat::startPolling()
 	{
-		if (!option.pollTime || isPolling) return;
+		if (!option.pollTime || pollTimerID) return;
+
+		if (!option.adaptivePolling)
+		{
+			pollTimerID = timer->add(option.pollTime, [this]() { queuePoll(); }, true);
+			return;
+		}
 
-		isPolling = true;
-		chatChannelIDThread = std::thread(&ChzzkChat::updateChatChannelID, this);
+		//the first poll is spread over the interval, so chats connected at once don't poll together
+		pollSchedule = ChzzkPollSchedule(option.pollTime);
+		pollTimerID = timer->add(pollSchedule.first(), [this]() { queuePoll(); }, true);
 	}
 
 	void ChzzkChat::stopPolling()
 	{
-		if (isPolling)
+		size_t id = pollTimerID.exchange(0);
+		if (id) timer->remove(id);
+	}
+
+	void ChzzkChat::sendPing()
+	{
+		if (!connected) return;
+
+		nlohmann::json json = {
+			{"cmd", ChatCommand::PING},
+			{"ver", 2}
+		};
+
+		_send(json.dump());
+	}
+
+	void ChzzkChat::startPing()
+	{
+		//rearming only moves the deadline, so this is cheap for every message
+		size_t id = pingTimerID;
+
+		if (id) timer->rearm(id);
+		else pingTimerID = timer->add(PING_TIME, [this]() { sendPing(); }, true);
+	}
+
+	void ChzzkChat::stopPing()
+	{
+		size_t id = pingTimerID.exchange(0);
+		if (id) timer->remove(id);
+	}
+
+	//fields of a chat json read by onMessageFast. keys of recent messages are kept apart, since the others take precedence like ChzzkChatView does
+	struct ChzzkFastChat
+	{
+		ChatType type = ChatType::NONE;
+		bool hasType = false;
+		bool empty = true;
+
+		std::string message, content;
+		std::string rawProfile, rawExtras;
+		std::string status, recentStatus;
+		bool hasMessage = false, hasStatus = false;
+
+		int memberCount = 0, recentMemberCount = 0;
+		unsigned long long time = 0, recentTime = 0;
+		bool hasMemberCount = false, hasTime = false;
+
+		//clears the fields for the next frame. strings keep their buffers
+		void reset()
 		{
-			isPolling = false;
-			if (chatChannelIDThread.joinable()) chatChannelIDThread.join();
+			type = ChatType::NONE;
+			hasType = false;
+			empty = true;
+
+			message.clear();
+			content.clear();
+			rawProfile.clear();
+			rawExtras.clear();
+			status.clear();
+			recentStatus.clear();
+			hasMessage = hasStatus = false;
+
+			memberCount = recentMemberCount = 0;
+			time = recentTime = 0;
+			hasMemberCount = hasTime = false;
 		}
+	};
+
+	struct ChzzkChat::FastParser
+	{
+#if _USE_SIMDJSON
+		simdjson::ondemand::parser parser;
+		std::string buffer;	//copy of the frame with simdjson padding
+#endif
+
+		//pool of the chats read from a frame, reset for each frame. the strings are given back after inline dispatch,
+		//so their buffers are reused by the next frames
+		std::vector<ChzzkFastChat> chats;
+		size_t chatCount = 0;	//chats used by the current frame
+
+		ChzzkFastChat notice;	//notice of the recent messages. empty if not given
+	};
+
+	//takes the next chat of the pool, adding one if every chat is used
+	static ChzzkFastChat& nextChat(std::vector<ChzzkFastChat>& chats, size_t& count)
+	{
+		if (count == chats.size()) chats.emplace_back();
+
+		ChzzkFastChat& chat = chats[count++];
+		chat.reset();
+
+		return chat;
 	}
 
-	void ChzzkChat::sendPing()
+#if _USE_SIMDJSON
+	//same as takeString of ChzzkChatView. non-string values are read as empty string
+	static simdjson::error_code readString(simdjson::ondemand::value& value, std::string& dest)
+	{
+		simdjson::ondemand::json_type type;
+		if (auto error = value.type().get(type)) return error;
+
+		dest.clear();
+		if (type != simdjson::ondemand::json_type::string) return simdjson::SUCCESS;
+
+		std::string_view str;
+		if (auto error = value.get_string().get(str)) return error;
+
+		dest.assign(str);
+		return simdjson::SUCCESS;
+	}
+
+	//same as json_safe_get of integers. other values than null and integers are errors, to be handled by nlohmann::json
+	template <typename T>
+	static simdjson::error_code readInteger(simdjson::ondemand::value& value, T& dest)
 	{
-		int pingCount = 0;
+		simdjson::ondemand::json_type type;
+		if (auto error = value.type().get(type)) return error;
 
-		while (connected && isPinging)
+		if (type == simdjson::ondemand::json_type::null)
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds(10));
-			pingCount += 10;
+			dest = T();
+			return simdjson::SUCCESS;
+		}
 
-			if (pingCount >= PING_TIME)
+		std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t> number;
+		if (auto error = value.get(number)) return error;
+
+		dest = (T)number;
+		return simdjson::SUCCESS;
+	}
+
+	static simdjson::error_code readChat(simdjson::ondemand::object object, ChzzkFastChat& chat)
+	{
+		for (auto entry : object)
+		{
+			simdjson::ondemand::field field;
+			std::string_view key;
+
+			if (auto error = std::move(entry).get(field)) return error;
+			if (auto error = field.unescaped_key().get(key)) return error;
+
+			chat.empty = false;
+
+			simdjson::ondemand::value& value = field.value();
+			simdjson::error_code error = simdjson::SUCCESS;
+
+			if (key == "msgTypeCode" || key == "messageTypeCode")
 			{
-				nlohmann::json json = {
-					{"cmd", ChatCommand::PING},
-					{"ver", 2}
-				};
+				//msgTypeCode takes precedence
+				if (chat.hasType && key == "messageTypeCode") continue;
+
+				int64_t type;
+				if ((error = value.get_int64().get(type))) return error;
+
+				chat.type = (ChatType)type;
+				chat.hasType = key == "msgTypeCode";
+			}
+			else if (key == "profile") error = readString(value, chat.rawProfile);
+			else if (key == "extras") error = readString(value, chat.rawExtras);
+			else if (key == "msg")
+			{
+				error = readString(value, chat.message);
+				chat.hasMessage = true;
+			}
+			else if (key == "content") error = readString(value, chat.content); //case of recent message
+			else if (key == "mbrCnt")
+			{
+				error = readInteger(value, chat.memberCount);
+				chat.hasMemberCount = true;
+			}
+			else if (key == "memberCount") error = readInteger(value, chat.recentMemberCount);
+			else if (key == "msgTime")
+			{
+				error = readInteger(value, chat.time);
+				chat.hasTime = true;
+			}
+			else if (key == "messageTime") error = readInteger(value, chat.recentTime);
+			else if (key == "msgStatusType")
+			{
+				error = readString(value, chat.status);
+				chat.hasStatus = true;
+			}
+			else if (key == "messageStatusType") error = readString(value, chat.recentStatus);
+
+			if (error) return error;
+		}
+
+		return simdjson::SUCCESS;
+	}
+
+	//reads the chat objects in the list. other values are skipped, since they have no type code
+	static simdjson::error_code readChats(simdjson::ondemand::array list, std::vector<ChzzkFastChat>& chats, size_t& count)
+	{
+		for (auto element : list)
+		{
+			simdjson::ondemand::value value;
+			simdjson::ondemand::json_type type;
+
+			if (auto error = std::move(element).get(value)) return error;
+			if (auto error = value.type().get(type)) return error;
+
+			if (type != simdjson::ondemand::json_type::object) continue;
+
+			simdjson::ondemand::object chat;
+			if (auto error = value.get_object().get(chat)) return error;
+
+			if (auto error = readChat(chat, nextChat(chats, count))) return error;
+		}
+
+		return simdjson::SUCCESS;
+	}
+
+	bool ChzzkChat::onMessageFast(std::string_view message)
+	{
+		FastParser& fast = *fastParser;
+
+		fast.buffer.reserve(message.size() + simdjson::SIMDJSON_PADDING);
+		fast.buffer.assign(message.data(), message.size());
+
+		simdjson::ondemand::document document;
+		if (fast.parser.iterate(simdjson::padded_string_view(fast.buffer.data(), fast.buffer.size(), fast.buffer.capacity())).get(document)) return false;
+
+		int64_t command;
+		if (document["cmd"].get_int64().get(command)) return false;
+
+		ChatCommand cmd = (ChatCommand)command;
+		if (cmd != ChatCommand::CHAT && cmd != ChatCommand::RECENT_CHAT && cmd != ChatCommand::DONATION) return false;
+
+		simdjson::ondemand::value body;
+		simdjson::ondemand::json_type bodyType;
+
+		if (document["bdy"].get(body)) return false;
+		if (body.type().get(bodyType)) return false;
+
+		fast.chatCount = 0;
+		fast.notice.reset();
+
+		simdjson::ondemand::array list;
+
+		if (bodyType == simdjson::ondemand::json_type::object)
+		{
+			//recent messages with notice. other objects are left to nlohmann::json
+			simdjson::ondemand::object object;
+			if (body.get_object().get(object)) return false;
+
+			bool hasList = false;
+
+			for (auto entry : object)
+			{
+				simdjson::ondemand::field field;
+				std::string_view key;
+
+				if (std::move(entry).get(field) || field.unescaped_key().get(key)) return false;
+
+				if (key == "messageList")
+				{
+					if (field.value().get_array().get(list)) return false;
+
+					//the list is consumed before the iterator moves on
+					if (readChats(list, fast.chats, fast.chatCount)) return false;
+
+					hasList = true;
+				}
+				else if (key == "notice")
+				{
+					simdjson::ondemand::json_type type;
+					if (field.value().type().get(type)) return false;
+
+					if (type == simdjson::ondemand::json_type::object)
+					{
+						simdjson::ondemand::object object;
+						if (field.value().get_object().get(object) || readChat(object, fast.notice)) return false;
+					}
+					else if (type != simdjson::ondemand::json_type::null) return false;
+				}
+			}
+
+			if (!hasList) return false;
+		}
+		else if (bodyType == simdjson::ondemand::json_type::array)
+		{
+			if (body.get_array().get(list) || readChats(list, fast.chats, fast.chatCount)) return false;
+		}
+		else return false;
+
+		//every frame is read. handlers are called from here
+		callFast(cmd == ChatCommand::RECENT_CHAT);
+		return true;
+	}
+#else
+	//sax handler reading chat frames into the pool of FastParser without building a json DOM. gives the same chats as the simdjson reader
+	//returns false from the events for other frames or unexpected json, which stops the parsing
+	class ChzzkChatSaxReader : public nlohmann::json::json_sax_t
+	{
+		enum class Context
+		{
+			FRAME,	//the frame object
+			BODY,	//bdy object of the recent messages
+			LIST,	//list of the chats
+			CHAT,	//chat object
+		};
+
+		enum class Key
+		{
+			NONE,
+
+			//keys of FRAME
+			CMD,
+			BDY,
+
+			//keys of BODY
+			MESSAGE_LIST,
+			NOTICE,
+
+			//keys of CHAT. RECENT_ ones are of the recent messages
+			TYPE,
+			RECENT_TYPE,
+			PROFILE,
+			EXTRAS,
+			MESSAGE,
+			CONTENT,
+			MEMBER_COUNT,
+			RECENT_MEMBER_COUNT,
+			TIME,
+			RECENT_TIME,
+			STATUS,
+			RECENT_STATUS,
+		};
+
+		enum class Scalar
+		{
+			NUL,
+			INTEGER,
+			STRING,
+			OTHER,
+		};
+
+		std::vector<ChzzkFastChat>& chats;
+		size_t& chatCount;
+		ChzzkFastChat& notice;
+
+		//values in a chat are skipped, so the contexts are never deeper than this
+		Context stack[4];
+		size_t depth;
+		size_t skipDepth;	//depth of the json value being skipped. 0 if not skipping
+
+		Key lastKey;		//last key of the current object
+		ChzzkFastChat* chat;
+
+		bool push(Context context)
+		{
+			stack[depth++] = context;
+			return true;
+		}
+
+		bool skip()
+		{
+			skipDepth = 1;
+			return true;
+		}
+
+		//null and other types are read as empty string, same as readString
+		static void setString(std::string& dest, const std::string* value)
+		{
+			if (value) dest.assign(*value);
+			else dest.clear();
+		}
+
+		//same as readInteger
+		template <typename T>
+		static bool setInteger(T& dest, Scalar type, int64_t value)
+		{
+			if (type == Scalar::NUL) dest = T();
+			else if (type == Scalar::INTEGER) dest = (T)value;
+			else return false;
+
+			return true;
+		}
+
+		bool readField(Key field, Scalar type, int64_t integer, const std::string* text)
+		{
+			switch (field)
+			{
+			case Key::TYPE:
+			case Key::RECENT_TYPE:
+				if (type != Scalar::INTEGER) return false;
+
+				chat->type = (ChatType)integer;
+				chat->hasType = field == Key::TYPE;
+				return true;
+
+			case Key::PROFILE: setString(chat->rawProfile, text); return true;
+			case Key::EXTRAS: setString(chat->rawExtras, text); return true;
+			case Key::MESSAGE: setString(chat->message, text); return true;
+			case Key::CONTENT: setString(chat->content, text); return true;
+			case Key::STATUS: setString(chat->status, text); return true;
+			case Key::RECENT_STATUS: setString(chat->recentStatus, text); return true;
+
+			case Key::MEMBER_COUNT: return setInteger(chat->memberCount, type, integer);
+			case Key::RECENT_MEMBER_COUNT: return setInteger(chat->recentMemberCount, type, integer);
+			case Key::TIME: return setInteger(chat->time, type, integer);
+			case Key::RECENT_TIME: return setInteger(chat->recentTime, type, integer);
+
+			default:
+				return true;
+			}
+		}
+
+		bool value(Scalar type, int64_t integer = 0, const std::string* text = nullptr)
+		{
+			if (skipDepth) return true;
+			if (!depth) return false;
+
+			Key current = lastKey;
+			lastKey = Key::NONE;
+
+			switch (stack[depth - 1])
+			{
+			case Context::FRAME:
+				if (current == Key::CMD)
+				{
+					if (type != Scalar::INTEGER) return false;
+
+					command = integer;
+
+					//other frames stop here if the command comes first
+					return isChatCommand(command);
+				}
+
+				return current != Key::BDY;
+
+			case Context::BODY:
+				if (current == Key::NOTICE) return type == Scalar::NUL;
+				return current != Key::MESSAGE_LIST;
+
+			case Context::LIST:
+				//other values than objects have no type code
+				return true;
+
+			case Context::CHAT:
+				return readField(current, type, integer, text);
+			}
+
+			return true;
+		}
+
+		bool open(bool object)
+		{
+			if (skipDepth)
+			{
+				skipDepth++;
+				return true;
+			}
+
+			Key current = lastKey;
+			lastKey = Key::NONE;
+
+			if (!depth) return object && push(Context::FRAME);
+
+			switch (stack[depth - 1])
+			{
+			case Context::FRAME:
+				if (current == Key::CMD) return false;
+				if (current != Key::BDY) return skip();
+
+				hasBody = true;
+				bodyObject = object;
+
+				return push(object ? Context::BODY : Context::LIST);
+
+			case Context::BODY:
+				if (current == Key::MESSAGE_LIST)
+				{
+					if (object) return false;
+
+					hasList = true;
+					return push(Context::LIST);
+				}
+
+				if (current == Key::NOTICE)
+				{
+					if (!object) return false;
+
+					chat = &notice;
+					return push(Context::CHAT);
+				}
+
+				return skip();
+
+			case Context::LIST:
+				if (!object) return skip();
+
+				chat = &nextChat(chats, chatCount);
+				return push(Context::CHAT);
+
+			case Context::CHAT:
+				//nested values of strings are read as empty string, and of integers are errors
+				return readField(current, Scalar::OTHER, 0, nullptr) && skip();
+			}
+
+			return true;
+		}
+
+		bool close()
+		{
+			if (skipDepth) skipDepth--;
+			else depth--;
+
+			return true;
+		}
+
+	public:
+		int64_t command;
+		bool hasBody;		//whether bdy is an object or an array
+		bool bodyObject;	//whether bdy is an object, which should have messageList
+		bool hasList;		//whether messageList is given
+
+		static bool isChatCommand(int64_t command)
+		{
+			ChatCommand cmd = (ChatCommand)command;
+			return cmd == ChatCommand::CHAT || cmd == ChatCommand::RECENT_CHAT || cmd == ChatCommand::DONATION;
+		}
+
+		ChzzkChatSaxReader(std::vector<ChzzkFastChat>& chats, size_t& chatCount, ChzzkFastChat& notice) : chats(chats), chatCount(chatCount), notice(notice),
+			depth(0), skipDepth(0), lastKey(Key::NONE), chat(nullptr), command(-1), hasBody(false), bodyObject(false), hasList(false)
+		{
+		}
+
+		bool null() override
+		{
+			return value(Scalar::NUL);
+		}
+
+		bool boolean(bool) override
+		{
+			return value(Scalar::OTHER);
+		}
+
+		bool number_integer(number_integer_t number) override
+		{
+			return value(Scalar::INTEGER, number);
+		}
+
+		bool number_unsigned(number_unsigned_t number) override
+		{
+			return value(Scalar::INTEGER, (int64_t)number);
+		}
+
+		bool number_float(number_float_t, const string_t&) override
+		{
+			return value(Scalar::OTHER);
+		}
+
+		bool string(string_t& text) override
+		{
+			return value(Scalar::STRING, 0, &text);
+		}
+
+		bool binary(binary_t&) override
+		{
+			return false;
+		}
+
+		bool start_object(std::size_t) override
+		{
+			return open(true);
+		}
+
+		bool key(string_t& name) override
+		{
+			if (skipDepth || !depth) return true;
+
+			lastKey = Key::NONE;
+
+			switch (stack[depth - 1])
+			{
+			case Context::FRAME:
+				if (name == "cmd") lastKey = Key::CMD;
+				else if (name == "bdy") lastKey = Key::BDY;
+				break;
+
+			case Context::BODY:
+				if (name == "messageList") lastKey = Key::MESSAGE_LIST;
+				else if (name == "notice") lastKey = Key::NOTICE;
+				break;
+
+			case Context::CHAT:
+				chat->empty = false;
+
+				if (name == "msgTypeCode") lastKey = Key::TYPE;
+				else if (name == "messageTypeCode") lastKey = chat->hasType ? Key::NONE : Key::RECENT_TYPE; //msgTypeCode takes precedence
+				else if (name == "profile") lastKey = Key::PROFILE;
+				else if (name == "extras") lastKey = Key::EXTRAS;
+				else if (name == "msg")
+				{
+					lastKey = Key::MESSAGE;
+					chat->hasMessage = true;
+				}
+				else if (name == "content") lastKey = Key::CONTENT; //case of recent message
+				else if (name == "mbrCnt")
+				{
+					lastKey = Key::MEMBER_COUNT;
+					chat->hasMemberCount = true;
+				}
+				else if (name == "memberCount") lastKey = Key::RECENT_MEMBER_COUNT;
+				else if (name == "msgTime")
+				{
+					lastKey = Key::TIME;
+					chat->hasTime = true;
+				}
+				else if (name == "messageTime") lastKey = Key::RECENT_TIME;
+				else if (name == "msgStatusType")
+				{
+					lastKey = Key::STATUS;
+					chat->hasStatus = true;
+				}
+				else if (name == "messageStatusType") lastKey = Key::RECENT_STATUS;
+				break;
+
+			case Context::LIST:
+				break;
+			}
+
+			return true;
+		}
 
-				_send(json.dump());
+		bool end_object() override
+		{
+			return close();
+		}
 
-				pingCount = 0;
-			}
+		bool start_array(std::size_t) override
+		{
+			return open(false);
+		}
 
+		bool end_array() override
+		{
+			return close();
 		}
-	}
 
-	void ChzzkChat::startPing()
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override
+		{
+			return false;
+		}
+	};
+
+	bool ChzzkChat::onMessageFast(std::string_view message)
 	{
-		if (isPinging) stopPing();
+		FastParser& fast = *fastParser;
 
-		isPinging = true;
-		pingTimerThread = std::thread(&ChzzkChat::sendPing, this);
-	}
+		fast.chatCount = 0;
+		fast.notice.reset();
 
-	void ChzzkChat::stopPing()
-	{
-		isPinging = false;
-		if (pingTimerThread.joinable()) pingTimerThread.join();
+		ChzzkChatSaxReader reader(fast.chats, fast.chatCount, fast.notice);
+
+		if (!nlohmann::json::sax_parse(message.begin(), message.end(), &reader)) return false;
+		if (!ChzzkChatSaxReader::isChatCommand(reader.command) || !reader.hasBody || (reader.bodyObject && !reader.hasList)) return false;
+
+		//every frame is read. handlers are called from here
+		callFast((ChatCommand)reader.command == ChatCommand::RECENT_CHAT);
+		return true;
 	}
+#endif
 
-	nlohmann::json ChzzkChat::parseChat(const nlohmann::json& json, bool isRecent)
+	void ChzzkChat::callFast(bool isRecent)
 	{
-		std::string _profile = json_safe_get<std::string>(json["profile"]);
-		std::string _extras = json_safe_get<std::string>(json["extras"]);
+		FastParser& fast = *fastParser;
 
-		auto profile = _profile.empty() ? nlohmann::json() : nlohmann::json::parse(_profile);
-		auto extras = _extras.empty() ? nlohmann::json() : nlohmann::json::parse(_extras);
+		auto view = [&](ChzzkChatEvent type, ChzzkFastChat& chat) {
+			std::string& message = chat.hasMessage ? chat.message : chat.content;
+			unsigned long long time = chat.hasTime ? chat.time : chat.recentTime;
+			int memberCount = chat.hasMemberCount ? chat.memberCount : chat.recentMemberCount;
+			bool hidden = (chat.hasStatus ? chat.status : chat.recentStatus) == "HIDDEN";
 
-		auto params = extras.is_null() ? nlohmann::json() : extras["params"];
-		std::string registerChatProfileJson = params.is_null() ? "" : params["registerChatProfileJson"];
-		std::string targetChatProfileJson = params.is_null() ? "" : params["targetChatProfileJson"];
+			if (dispatcher)
+			{
+				dispatchChat(type, std::move(message), std::move(chat.rawProfile), std::move(chat.rawExtras), time, memberCount, hidden, isRecent);
+				return;
+			}
 
-		if (!registerChatProfileJson.empty() && !targetChatProfileJson.empty())
-		{
-			params["registerChatProfile"] = nlohmann::json::parse(registerChatProfileJson);
-			params["targetChatProfile"] = nlohmann::json::parse(targetChatProfileJson);
+			ChzzkChatView chatView(std::move(message), std::move(chat.rawProfile), std::move(chat.rawExtras), time, memberCount, hidden, isRecent);
 
-			params.erase("registerChatProfileJson");
-			params.erase("targetChatProfileJson");
+			if (latency) measureServer(chatView);
 
-			extras["params"] = params;
-		}
+			callChat(type, chatView, receivedAt);
 
-		std::string message = "";
-		if (json.find("msg") != json.end()) message = json["msg"];
-		else if (json.find("content") != json.end()) message = json["content"]; //case of recent message
+			//the strings go back to the pool for the next frame
+			chatView.release(message, chat.rawProfile, chat.rawExtras);
+		};
 
-		int memberCount = 0;
-		if (json.find("mbrCnt") != json.end()) memberCount = json["mbrCnt"];
-		else if (json.find("memberCount") != json.end()) memberCount = json["memberCount"]; //case of recent message
+		if (!fast.notice.empty) view(ChzzkChatEvent::NOTICE, fast.notice);
 
-		unsigned long long time = 0;
-		if (json.find("msgTime") != json.end()) time = json["msgTime"];
-		else if (json.find("messageTime") != json.end()) time = json["messageTime"]; //case of recent message
+		for (size_t i = 0; i < fast.chatCount; i++)
+		{
+			ChzzkFastChat& chat = fast.chats[i];
 
-		std::string messageStatusType = "";
-		if (json.find("msgStatusType") != json.end()) messageStatusType = json["msgStatusType"];
-		else if (json.find("messageStatusType") != json.end()) messageStatusType = json["messageStatusType"]; //case of recent message
+			switch (chat.type)
+			{
+			case ChatType::TEXT:
+				view(ChzzkChatEvent::CHAT, chat);
+				break;
 
-		bool hidden = (messageStatusType == "HIDDEN");
+			case ChatType::DONATION:
+				view(ChzzkChatEvent::DONATION, chat);
+				break;
 
-		nlohmann::json parsed = {
-			{"profile", profile},
-			{"extras", extras},
-			{"hidden", hidden},
-			{"message", message},
-			{"time", time},
-			{"isRecent", isRecent}
-		};
+			case ChatType::SUBSCRIPTION:
+				view(ChzzkChatEvent::SUBSCRIPTION, chat);
+				break;
 
-		if (memberCount) parsed["memberCount"] = memberCount;
+			case ChatType::SYSTEM_MESSAGE:
+				view(ChzzkChatEvent::SYSTEM_MESSAGE, chat);
+				break;
 
-		return parsed;
-		return extras;
+			default:
+				break;
+			}
+		}
 	}
 
-	void ChzzkChat::onMessage(const std::string& message)
+	void ChzzkChat::onMessage(std::string_view message, bool record)
 	{
 		if (message.empty()) return;
 
+		if (record && option.recorder)
+		{
+			try
+			{
+				option.recorder->write(message);
+			}
+			catch (std::exception& e)
+			{
+#if _DEBUG
+				std::cerr << e.what() << std::endl;
+#endif
+			}
+		}
+
+		if (latency)
+		{
+			receivedAt = ChzzkLatencyTracker::Clock::now();
+			receivedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		}
+
+		if (onMessageFast(message))
+		{
+			startPing();
+			return;
+		}
+
 		nlohmann::json json;
 
 		try
 		{
-			json = nlohmann::json::parse(message);
+			json = nlohmann::json::parse(message.begin(), message.end());
 		}
 		catch (std::exception& e)
 		{
@@ -378,23 +1325,27 @@ namespace chzzkpp
 			return;
 		}
 
-		auto body = json["bdy"];
+		auto& body = json["bdy"];
 		ChatCommand cmd = json["cmd"];
 
 		switch (cmd)
 		{
 		case ChatCommand::CONNECTED:
-			sid = body["sid"];
+			{
+				std::lock_guard<std::mutex> guard(sessionMutex);
+				sid = body["sid"];
+			}
 
 			if (reconnecting)
 			{
-				call(ChzzkChatEvent::RECONNECT, option.chatChannelID);
+				dispatch(ChzzkChatEvent::RECONNECT, option.chatChannelID);
 				reconnecting = false;
 			}
 			else
-				call(ChzzkChatEvent::CONNECT, "");
+				dispatch(ChzzkChatEvent::CONNECT, "");
 
 			chat_connected = true;
+			reopenAttempts = 0;
 			break;
 
 		case ChatCommand::PING:
@@ -414,43 +1365,39 @@ namespace chzzkpp
 			{
 				bool isRecent = (cmd == ChatCommand::RECENT_CHAT);
 
-				auto _notice = body.find("notice") != body.end() ? body["notice"] : nlohmann::json();
+				auto _notice = body.find("notice");
 
-				if (!_notice.empty()) //parsing notice message
-				{
-					auto notice = parseChat(body["notice"], isRecent).dump();
-					call(ChzzkChatEvent::NOTICE, notice);
-				}
+				if (_notice != body.end() && !_notice->empty()) //parsing notice message
+					dispatchChat(ChzzkChatEvent::NOTICE, *_notice, isRecent);
 
-				auto chats = body;
+				auto* chats = &body;
 
-				if (chats.find("messageList") != chats.end()) chats = chats["messageList"]; //recent messages
+				auto messageList = body.find("messageList");
+				if (messageList != body.end()) chats = &*messageList; //recent messages
 
-				for (auto chat : chats)
+				for (auto& chat : *chats)
 				{
 					ChatType type = ChatType::NONE;
 
 					if (chat.find("msgTypeCode") != chat.end()) type = chat["msgTypeCode"];
 					else if (chat.find("messageTypeCode") != chat.end()) type = chat["messageTypeCode"]; //case of recent message
 
-					auto message = parseChat(chat, isRecent).dump();
-
 					switch (type)
 					{
 					case ChatType::TEXT:
-						call(ChzzkChatEvent::CHAT, message);
+						dispatchChat(ChzzkChatEvent::CHAT, chat, isRecent);
 						break;
 
 					case ChatType::DONATION:
-						call(ChzzkChatEvent::DONATION, message);
+						dispatchChat(ChzzkChatEvent::DONATION, chat, isRecent);
 						break;
 
 					case ChatType::SUBSCRIPTION:
-						call(ChzzkChatEvent::SUBSCRIPTION, message);
+						dispatchChat(ChzzkChatEvent::SUBSCRIPTION, chat, isRecent);
 						break;
 
 					case ChatType::SYSTEM_MESSAGE:
-						call(ChzzkChatEvent::SYSTEM_MESSAGE, message);
+						dispatchChat(ChzzkChatEvent::SYSTEM_MESSAGE, chat, isRecent);
 						break;
 					}
 				}
@@ -458,15 +1405,16 @@ namespace chzzkpp
 			break;
 
 		case ChatCommand::NOTICE:
-			call(ChzzkChatEvent::NOTICE, body.empty() || body.is_null() ? "" : parseChat(body));
+			if (body.empty() || body.is_null()) dispatch(ChzzkChatEvent::NOTICE, "");
+			else dispatchChat(ChzzkChatEvent::NOTICE, body);
 			break;
 
 		case ChatCommand::EVENT:
-			call(ChzzkChatEvent::EVENT, body.dump());
+			dispatch(ChzzkChatEvent::EVENT, body.dump());
 			break;
 
 		case ChatCommand::BLIND:
-			call(ChzzkChatEvent::BLIND, body.is_string() ? (std::string)body : body.dump()); //idk what comes here, so just converting it
+			dispatch(ChzzkChatEvent::BLIND, body.is_string() ? (std::string)body : body.dump()); //idk what comes here, so just converting it
 			break;
 		}
 
@@ -474,10 +1422,179 @@ namespace chzzkpp
 			startPing();
 	}
 
-	void ChzzkChat::call(ChzzkChatEvent type, const std::string& message)
+	void ChzzkChat::dispatch(ChzzkChatEvent type, const std::string& message)
+	{
+		if (!dispatcher)
+		{
+			call(type, message, receivedAt);
+			return;
+		}
+
+		ChzzkDispatchItem item;
+		item.type = type;
+		item.message = message;
+		item.received = receivedAt;
+
+		dispatcher->push(std::move(item));
+	}
+
+	template <typename... Args>
+	void ChzzkChat::dispatchChat(ChzzkChatEvent type, Args&&... args)
+	{
+		if (!dispatcher)
+		{
+			ChzzkChatView view(std::forward<Args>(args)...);
+
+			if (latency) measureServer(view);
+
+			callChat(type, view, receivedAt);
+			return;
+		}
+
+		ChzzkDispatchItem item;
+		item.type = type;
+		item.view = std::make_unique<ChzzkChatView>(std::forward<Args>(args)...);
+		item.received = receivedAt;
+
+		if (latency) measureServer(*item.view);
+
+		dispatcher->push(std::move(item));
+	}
+
+	void ChzzkChat::measureServer(const ChzzkChatView& view)
+	{
+		//recent messages are old by design
+		if (view.isRecent()) return;
+
+		latency->recordServer(view.time(), receivedTime);
+		if (option.hub) option.hub->latency.recordServer(view.time(), receivedTime);
+	}
+
+	void ChzzkChat::measureHandlers(ChzzkChatEvent type, ChzzkLatencyTracker::Clock::time_point received, ChzzkLatencyTracker::Clock::time_point start)
+	{
+		auto end = ChzzkLatencyTracker::Clock::now();
+
+		latency->recordHandlers(type, received, start, end);
+		if (option.hub) option.hub->latency.recordHandlers(type, received, start, end);
+	}
+
+	void ChzzkChat::call(ChzzkChatEvent type, const std::string& message, ChzzkLatencyTracker::Clock::time_point received)
+	{
+		auto start = latency ? ChzzkLatencyTracker::Clock::now() : ChzzkLatencyTracker::Clock::time_point();
+
+		handlers[(size_t)type].call(message);
+
+		auto shared = sharedHandlers[(size_t)type].snapshot();
+
+		if (shared)
+		{
+			auto raw = std::make_shared<const std::string>(message);
+
+			for (auto& p : *shared)
+				p.second(raw);
+		}
+
+		if (latency) measureHandlers(type, received, start);
+	}
+
+	//makes the shared message only if some shared handler needs it
+	template <typename T>
+	static std::shared_ptr<const ChzzkSharedMessage<T>> makeSharedMessage(const ChzzkHandlerList<const std::shared_ptr<const ChzzkSharedMessage<T>>&>& handlers, const ChzzkChatView& view)
+	{
+		if (handlers.empty()) return nullptr;
+
+		auto shared = std::make_shared<ChzzkSharedMessage<T>>();
+		shared->message = parse_view<T>(view);
+		shared->raw = view.toJson().dump();
+
+		return shared;
+	}
+
+	//typed handlers reuse the struct of the shared message if it is made
+	template <typename T>
+	static void callTyped(const ChzzkHandlerList<const T&>& handlers, const ChzzkHandlerList<const std::shared_ptr<const ChzzkSharedMessage<T>>&>& sharedHandlers,
+		const std::shared_ptr<const ChzzkSharedMessage<T>>& shared, const ChzzkChatView& view)
+	{
+		if (shared)
+		{
+			handlers.call(shared->message);
+			sharedHandlers.call(shared);
+		}
+		else if (!handlers.empty()) handlers.call(parse_view<T>(view));
+	}
+
+	void ChzzkChat::callChat(ChzzkChatEvent type, const ChzzkChatView& view, ChzzkLatencyTracker::Clock::time_point received)
 	{
-		for (auto& p : handlers[type])
-			p.second(message);
+		auto start = latency ? ChzzkLatencyTracker::Clock::now() : ChzzkLatencyTracker::Clock::time_point();
+
+		viewHandlers[(size_t)type].call(view);
+
+		ChzzkSharedChatMessage chat;
+		ChzzkSharedDonationMessage donation;
+		ChzzkSharedSubscriptionMessage subscription;
+
+		//json of the message, pointing into the shared message if there is one, so it is dumped once
+		std::shared_ptr<const std::string> raw;
+
+		switch (type)
+		{
+		case ChzzkChatEvent::CHAT:
+			chat = makeSharedMessage(sharedChatHandlers, view);
+			if (chat) raw = std::shared_ptr<const std::string>(chat, &chat->raw);
+			break;
+
+		case ChzzkChatEvent::DONATION:
+			donation = makeSharedMessage(sharedDonationHandlers, view);
+			if (donation) raw = std::shared_ptr<const std::string>(donation, &donation->raw);
+			break;
+
+		case ChzzkChatEvent::SUBSCRIPTION:
+			subscription = makeSharedMessage(sharedSubscriptionHandlers, view);
+			if (subscription) raw = std::shared_ptr<const std::string>(subscription, &subscription->raw);
+			break;
+
+		default:
+			break;
+		}
+
+		//dump only if someone wants the string
+		auto stringHandlers = handlers[(size_t)type].snapshot();
+		auto shared = sharedHandlers[(size_t)type].snapshot();
+
+		if (!raw && (stringHandlers || shared))
+			raw = std::make_shared<const std::string>(view.toJson().dump());
+
+		if (stringHandlers)
+		{
+			for (auto& p : *stringHandlers)
+				p.second(*raw);
+		}
+
+		if (shared)
+		{
+			for (auto& p : *shared)
+				p.second(raw);
+		}
+
+		switch (type)
+		{
+		case ChzzkChatEvent::CHAT:
+			callTyped(chatHandlers, sharedChatHandlers, chat, view);
+			break;
+
+		case ChzzkChatEvent::DONATION:
+			callTyped(donationHandlers, sharedDonationHandlers, donation, view);
+			break;
+
+		case ChzzkChatEvent::SUBSCRIPTION:
+			callTyped(subscriptionHandlers, sharedSubscriptionHandlers, subscription, view);
+			break;
+
+		default:
+			break;
+		}
+
+		if (latency) measureHandlers(type, received, start);
 	}
 
 	/////////////////////
@@ -486,9 +1603,19 @@ namespace chzzkpp
 
 	void ChzzkChat::connect()
 	{
+		std::lock_guard<std::mutex> guard(stateMutex);
+
 		//connect to the chat
 		if (connected) throw std::exception("Chat is already connected.");
 
+		reconnecting = false;
+		reopenAttempts = 0;
+		connectChat();
+	}
+
+	void ChzzkChat::connectChat()
+	{
+
 		if (!option.channelID.empty() && option.chatChannelID.empty())
 			option.chatChannelID = client->getLiveStatus(option.channelID).chatChannelID;
 		
@@ -498,16 +1625,23 @@ namespace chzzkpp
 		if (!option.chatChannelID.empty() && option.accessToken.empty())
 		{
 
-			uid = client->getCore()->hasAuth() ? client->getUserData().userIDHash : "";
+			std::string userID = client->getCore()->hasAuth() ? client->getUserData().userIDHash : "";
 
 			option.accessToken = client->getAccessToken(option.chatChannelID).accessToken;
+
+			std::lock_guard<std::mutex> guard(sessionMutex);
+			uid = userID;
 		}
 
-		_default = {
-			{"cid", option.chatChannelID},
-			{"svcid", "game"},
-			{"ver", 2}
-		};
+		{
+			std::lock_guard<std::mutex> guard(sessionMutex);
+
+			_default = {
+				{"cid", option.chatChannelID},
+				{"svcid", "game"},
+				{"ver", 2}
+			};
+		}
 
 		int serverID = 0;
 
@@ -525,8 +1659,11 @@ namespace chzzkpp
 
 	void ChzzkChat::close()
 	{
+		std::lock_guard<std::mutex> guard(stateMutex);
+
 		if (!connected) throw std::exception("Chat is not connected.");
 
+		reconnecting = false;
 		_close();
 	}
 
@@ -542,44 +1679,170 @@ namespace chzzkpp
 
 	size_t ChzzkChat::addHandler(ChzzkChatEvent type, const std::function<void(const std::string&)>& func)
 	{
-#if _USE_CURL
-		std::lock_guard<std::mutex> guard(receiverMutex);
-#endif
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		handlers[(size_t)type].add(id, func);
+		return id;
+	}
+
+	size_t ChzzkChat::addViewHandler(ChzzkChatEvent type, const std::function<void(const ChzzkChatView&)>& func)
+	{
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		viewHandlers[(size_t)type].add(id, func);
+		return id;
+	}
+
+	size_t ChzzkChat::addChatHandler(const std::function<void(const ChzzkChatMessage&)>& func)
+	{
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		chatHandlers.add(id, func);
+		return id;
+	}
 
-		size_t id = 0;
+	size_t ChzzkChat::addDonationHandler(const std::function<void(const ChzzkDonationMessage&)>& func)
+	{
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		donationHandlers.add(id, func);
+		return id;
+	}
+
+	size_t ChzzkChat::addSubscriptionHandler(const std::function<void(const ChzzkSubscriptionMessage&)>& func)
+	{
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		subscriptionHandlers.add(id, func);
+		return id;
+	}
+
+	size_t ChzzkChat::addSharedHandler(ChzzkChatEvent type, const std::function<void(const std::shared_ptr<const std::string>&)>& func)
+	{
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		sharedHandlers[(size_t)type].add(id, func);
+		return id;
+	}
+
+	size_t ChzzkChat::addSharedChatHandler(const std::function<void(const ChzzkSharedChatMessage&)>& func)
+	{
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		sharedChatHandlers.add(id, func);
+		return id;
+	}
+
+	size_t ChzzkChat::addSharedDonationHandler(const std::function<void(const ChzzkSharedDonationMessage&)>& func)
+	{
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		sharedDonationHandlers.add(id, func);
+		return id;
+	}
+
+	size_t ChzzkChat::addSharedSubscriptionHandler(const std::function<void(const ChzzkSharedSubscriptionMessage&)>& func)
+	{
+		std::lock_guard<std::mutex> guard(handlerMutex);
 
-		while (handlers[type].find(id) != handlers[type].end()) id++;
+		size_t id = nextHandlerID++;
 
-		handlers[type].emplace(id, func);
+		sharedSubscriptionHandlers.add(id, func);
 		return id;
 	}
 
 	void ChzzkChat::removeHandler(ChzzkChatEvent type, size_t id)
 	{
-#if _USE_CURL
-		std::lock_guard<std::mutex> guard(receiverMutex);
-#endif
+		std::lock_guard<std::mutex> guard(handlerMutex);
+
+		handlers[(size_t)type].remove(id);
+		viewHandlers[(size_t)type].remove(id);
+		sharedHandlers[(size_t)type].remove(id);
 
-		handlers[type].erase(id);
+		if (type == ChzzkChatEvent::CHAT)
+		{
+			chatHandlers.remove(id);
+			sharedChatHandlers.remove(id);
+		}
+		else if (type == ChzzkChatEvent::DONATION)
+		{
+			donationHandlers.remove(id);
+			sharedDonationHandlers.remove(id);
+		}
+		else if (type == ChzzkChatEvent::SUBSCRIPTION)
+		{
+			subscriptionHandlers.remove(id);
+			sharedSubscriptionHandlers.remove(id);
+		}
 	}
 
 	void ChzzkChat::removeHandlers(ChzzkChatEvent type)
 	{
-#if _USE_CURL
-		std::lock_guard<std::mutex> guard(receiverMutex);
-#endif
+		std::lock_guard<std::mutex> guard(handlerMutex);
 
-		handlers[type].clear();
+		handlers[(size_t)type].clear();
+		viewHandlers[(size_t)type].clear();
+		sharedHandlers[(size_t)type].clear();
+
+		if (type == ChzzkChatEvent::CHAT)
+		{
+			chatHandlers.clear();
+			sharedChatHandlers.clear();
+		}
+		else if (type == ChzzkChatEvent::DONATION)
+		{
+			donationHandlers.clear();
+			sharedDonationHandlers.clear();
+		}
+		else if (type == ChzzkChatEvent::SUBSCRIPTION)
+		{
+			subscriptionHandlers.clear();
+			sharedSubscriptionHandlers.clear();
+		}
 	}
 
 	void ChzzkChat::removeAllHandlers()
 	{
-#if _USE_CURL
-		std::lock_guard<std::mutex> guard(receiverMutex);
-#endif
+		std::lock_guard<std::mutex> guard(handlerMutex);
 
 		for (auto& h : handlers)
-			h.second.clear();
+			h.clear();
+
+		for (auto& h : viewHandlers)
+			h.clear();
+
+		for (auto& h : sharedHandlers)
+			h.clear();
+
+		chatHandlers.clear();
+		donationHandlers.clear();
+		subscriptionHandlers.clear();
+		sharedChatHandlers.clear();
+		sharedDonationHandlers.clear();
+		sharedSubscriptionHandlers.clear();
+	}
+
+	void ChzzkChat::feed(std::string_view message)
+	{
+		if (connected) throw std::exception("Cannot feed frames to a connected chat.");
+
+		onMessage(message, false);
 	}
 
 	void ChzzkChat::requestRecentChat(int size)
@@ -592,11 +1855,17 @@ namespace chzzkpp
 		nlohmann::json json = {
 			{"bdy", bdy},
 			{"cmd", ChatCommand::REQUEST_RECENT_CHAT},
-			{"sid", sid},
 			{"tid", 2}
 		};
 
-		json.update(_default);
+		{
+			//the worker can reconnect meanwhile
+			std::lock_guard<std::mutex> guard(sessionMutex);
+
+			json["sid"] = sid;
+			json.update(_default);
+		}
+
 		_send(json.dump());
 	}
 
@@ -605,8 +1874,24 @@ namespace chzzkpp
 		if (!chat_connected)
 			throw std::exception("Chat is not connected.");
 
-		if (uid.empty())
-			throw std::exception("Chat Client is not logged in.");
+		std::string chatChannelID;
+		nlohmann::json json = {
+			{"retry", false},
+			{"cmd", ChatCommand::SEND_CHAT},
+			{"tid", 3}
+		};
+
+		{
+			//the worker can reconnect meanwhile
+			std::lock_guard<std::mutex> guard(sessionMutex);
+
+			if (uid.empty())
+				throw std::exception("Chat Client is not logged in.");
+
+			chatChannelID = _default.value("cid", "");
+			json["sid"] = sid;
+			json.update(_default);
+		}
 
 		nlohmann::json emoji_json;
 
@@ -617,7 +1902,7 @@ namespace chzzkpp
 			{"chatType", "STREAMING"},
 			{"emojis", emoji_json},
 			{"osType", config::OS_TYPE},
-			{"streamingChannelId", option.chatChannelID}
+			{"streamingChannelId", chatChannelID}
 		};
 
 		nlohmann::json body = {
@@ -627,21 +1912,37 @@ namespace chzzkpp
 			{"msgTypeCode", ChatType::TEXT}
 		};
 
-		nlohmann::json json = {
-			{"bdy", body},
-			{"retry", false},
-			{"cmd", ChatCommand::SEND_CHAT},
-			{"sid", sid},
-			{"tid", 3}
-		};
-
-		json.update(_default);
+		json["bdy"] = body;
 
 		_send(json.dump());
 	}
 
 
 
+	long long ChzzkChat::getLastConnectTime() const
+	{
+		return connectTime;
+	}
+
+	ChzzkDispatchStats ChzzkChat::getDispatchStats() const
+	{
+		if (dispatcher) return dispatcher->getStats();
+
+		return ChzzkDispatchStats();
+	}
+
+	ChzzkLatencyStats ChzzkChat::getLatencyStats() const
+	{
+		if (latency) return latency->getStats();
+
+		return ChzzkLatencyStats();
+	}
+
+	void ChzzkChat::resetLatencyStats()
+	{
+		if (latency) latency->reset();
+	}
+
 	ChzzkChatOptions& ChzzkChat::getCurrentChatOptions()
 	{
 		return option;
@@ -0,0 +1,360 @@
+#include <chzzkpp/ChzzkChatHub.h>
+#include <chzzkpp/ChzzkChat.h>
+
+#if _USE_CURL && defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if _DEBUG
+#include <iostream>
+#endif
+
+namespace chzzkpp
+{
+	ChzzkChatHub::ChzzkChatHub(size_t threadCount) : running(true)
+	{
+		if (!threadCount) threadCount = 1;
+
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			auto loop = std::make_unique<Loop>();
+			loop->current = nullptr;
+#if _USE_CURL
+#ifdef __linux__
+			loop->poller = epoll_create1(EPOLL_CLOEXEC);
+			loop->wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+			if (loop->poller < 0 || loop->wakeup < 0)
+			{
+				if (loop->poller >= 0) ::close(loop->poller);
+				if (loop->wakeup >= 0) ::close(loop->wakeup);
+
+				throw std::exception("Cannot create the event loop of the chat hub.");
+			}
+
+			//the wakeup has no chat
+			epoll_event event = {};
+			event.events = EPOLLIN;
+			event.data.ptr = nullptr;
+			epoll_ctl(loop->poller, EPOLL_CTL_ADD, loop->wakeup, &event);
+#else
+			loop->multi = curl_multi_init();
+			loop->changed = false;
+#endif
+#endif
+			loop->wakeups = 0;
+			loop->readyEvents = 0;
+			loop->frames = 0;
+
+			loops.push_back(std::move(loop));
+		}
+
+#if _USE_CURL
+		for (auto& loop : loops)
+			loop->thread = std::thread(&ChzzkChatHub::run, this, std::ref(*loop));
+#endif
+	}
+
+	ChzzkChatHub::~ChzzkChatHub()
+	{
+		running = false;
+
+#if _USE_CURL
+		for (auto& loop : loops)
+		{
+			wake(*loop);
+			if (loop->thread.joinable()) loop->thread.join();
+
+#ifdef __linux__
+			::close(loop->poller);
+			::close(loop->wakeup);
+#else
+			curl_multi_cleanup(loop->multi);
+			loop->multi = nullptr;
+#endif
+		}
+#endif
+	}
+
+#if _USE_CURL
+#ifdef __linux__
+	void ChzzkChatHub::watch(Loop& loop, ChzzkChat* chat, curl_socket_t socket)
+	{
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.ptr = chat;
+
+		epoll_ctl(loop.poller, EPOLL_CTL_ADD, socket, &event);
+	}
+
+	void ChzzkChatHub::unwatch(Loop& loop, ChzzkChat*, curl_socket_t socket)
+	{
+		//the socket is still open here, since the chat closes it after detaching
+		epoll_ctl(loop.poller, EPOLL_CTL_DEL, socket, nullptr);
+	}
+
+	void ChzzkChatHub::wake(Loop& loop)
+	{
+		uint64_t value = 1;
+		[[maybe_unused]] auto written = ::write(loop.wakeup, &value, sizeof(value));
+	}
+
+	bool ChzzkChatHub::wait(Loop& loop, std::vector<ChzzkChat*>& ready)
+	{
+		epoll_event events[MAX_EVENTS];
+
+		int count = epoll_wait(loop.poller, events, MAX_EVENTS, WAIT_TIME);
+
+		if (count < 0)
+		{
+			if (errno == EINTR) return true;
+
+#if _DEBUG
+			std::cerr << "Error occured waiting chat sockets: " << errno << std::endl;
+#endif
+			return false;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			auto chat = static_cast<ChzzkChat*>(events[i].data.ptr);
+
+			if (chat) ready.push_back(chat);
+			else
+			{
+				uint64_t value;
+				[[maybe_unused]] auto read = ::read(loop.wakeup, &value, sizeof(value));
+			}
+		}
+
+		return true;
+	}
+#else
+	//curl_multi_poll takes the whole set on every call, so the set is only rebuilt after chats change
+	void ChzzkChatHub::watch(Loop& loop, ChzzkChat*, curl_socket_t)
+	{
+		loop.changed = true;
+		curl_multi_wakeup(loop.multi);
+	}
+
+	void ChzzkChatHub::unwatch(Loop& loop, ChzzkChat*, curl_socket_t)
+	{
+		loop.changed = true;
+		curl_multi_wakeup(loop.multi);
+	}
+
+	void ChzzkChatHub::wake(Loop& loop)
+	{
+		curl_multi_wakeup(loop.multi);
+	}
+
+	bool ChzzkChatHub::wait(Loop& loop, std::vector<ChzzkChat*>& ready)
+	{
+		if (loop.changed.exchange(false))
+		{
+			std::lock_guard<std::mutex> guard(loop.mutex);
+
+			loop.fds.clear();
+			loop.owners.clear();
+
+			for (auto& chat : loop.chats)
+			{
+				if (chat.second == CURL_SOCKET_BAD) continue;
+
+				curl_waitfd fd = {};
+				fd.fd = chat.second;
+				fd.events = CURL_WAIT_POLLIN;
+
+				loop.fds.push_back(fd);
+				loop.owners.push_back(chat.first);
+			}
+		}
+
+		for (auto& fd : loop.fds)
+			fd.revents = 0;
+
+		int numfds = 0;
+		CURLMcode res = curl_multi_poll(loop.multi, loop.fds.data(), (unsigned int)loop.fds.size(), WAIT_TIME, &numfds);
+
+		if (res != CURLM_OK)
+		{
+#if _DEBUG
+			std::cerr << "Error occured waiting chat sockets: " << curl_multi_strerror(res) << std::endl;
+#endif
+			return false;
+		}
+
+		for (size_t i = 0; i < loop.fds.size(); i++)
+			if (loop.fds[i].revents) ready.push_back(loop.owners[i]);
+
+		return true;
+	}
+#endif
+
+	void ChzzkChatHub::attach(ChzzkChat* chat)
+	{
+		curl_socket_t socket = chat->activeSocket;
+
+		//attach to the loop with the fewest chats
+		Loop* target = nullptr;
+		size_t min = 0;
+
+		for (auto& loop : loops)
+		{
+			std::lock_guard<std::mutex> guard(loop->mutex);
+
+			if (!target || loop->chats.size() < min)
+			{
+				target = loop.get();
+				min = loop->chats.size();
+			}
+		}
+
+		std::lock_guard<std::mutex> guard(target->mutex);
+
+		target->chats[chat] = socket;
+		if (socket != CURL_SOCKET_BAD) watch(*target, chat, socket);
+	}
+
+#endif
+
+	void ChzzkChatHub::detach(ChzzkChat* chat)
+	{
+#if _USE_CURL
+		for (auto& loop : loops)
+		{
+			std::unique_lock<std::mutex> lock(loop->mutex);
+
+			auto found = loop->chats.find(chat);
+			if (found == loop->chats.end()) continue;
+
+			if (found->second != CURL_SOCKET_BAD) unwatch(*loop, chat, found->second);
+			loop->chats.erase(found);
+
+			//the chat could be closed in its own handler, which is running on the loop thread
+			if (std::this_thread::get_id() != loop->thread.get_id())
+				loop->finished.wait(lock, [&]() { return loop->current != chat; });
+
+			break;
+		}
+#else
+		(void)chat;
+#endif
+	}
+
+#if _USE_CURL
+	void ChzzkChatHub::run(Loop& loop)
+	{
+		std::vector<ChzzkChat*> ready;
+
+		while (running)
+		{
+			ready.clear();
+
+			if (!wait(loop, ready))
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				continue;
+			}
+
+			loop.wakeups++;
+
+			for (auto chat : ready)
+			{
+				curl_socket_t socket;
+
+				{
+					std::lock_guard<std::mutex> guard(loop.mutex);
+
+					//detached while waiting, or lost on the previous wakeup
+					auto found = loop.chats.find(chat);
+					if (found == loop.chats.end() || found->second == CURL_SOCKET_BAD) continue;
+
+					socket = found->second;
+					loop.current = chat;
+				}
+
+				loop.readyEvents++;
+
+				//an exception of a handler should not stop the other chats on the loop
+				try
+				{
+					loop.frames += chat->_drain();
+				}
+				catch (std::exception& e)
+				{
+#if _DEBUG
+					std::cerr << "Error occured receiving chat messages: " << e.what() << std::endl;
+#endif
+				}
+
+				{
+					std::lock_guard<std::mutex> guard(loop.mutex);
+					loop.current = nullptr;
+
+					//the socket is lost and the chat reconnects on the worker. stops waiting for it until the chat attaches again
+					//the chat could be detached already, waiting for the drain
+					auto found = loop.chats.find(chat);
+
+					if (found != loop.chats.end() && found->second == socket && chat->activeSocket == CURL_SOCKET_BAD)
+					{
+						unwatch(loop, chat, socket);
+						found->second = CURL_SOCKET_BAD;
+					}
+				}
+
+				loop.finished.notify_all();
+			}
+		}
+	}
+#endif
+
+	size_t ChzzkChatHub::getLoopCount() const
+	{
+		return loops.size();
+	}
+
+	ChzzkChatHubMetrics ChzzkChatHub::getMetrics(size_t loop) const
+	{
+		ChzzkChatHubMetrics metrics;
+		auto& target = *loops.at(loop);
+
+#if _USE_CURL
+		{
+			std::lock_guard<std::mutex> guard(target.mutex);
+			metrics.connections = target.chats.size();
+		}
+#else
+		metrics.connections = 0;
+#endif
+
+		metrics.wakeups = target.wakeups;
+		metrics.readyEvents = target.readyEvents;
+		metrics.frames = target.frames;
+
+		return metrics;
+	}
+
+	std::vector<ChzzkChatHubMetrics> ChzzkChatHub::getMetrics() const
+	{
+		std::vector<ChzzkChatHubMetrics> metrics;
+
+		for (size_t i = 0; i < loops.size(); i++)
+			metrics.push_back(getMetrics(i));
+
+		return metrics;
+	}
+
+	ChzzkLatencyStats ChzzkChatHub::getLatencyStats() const
+	{
+		return latency.getStats();
+	}
+
+	void ChzzkChatHub::resetLatencyStats()
+	{
+		latency.reset();
+	}
+}
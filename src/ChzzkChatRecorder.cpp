@@ -0,0 +1,499 @@
+#include <chzzkpp/ChzzkChatRecorder.h>
+#include <chzzkpp/ChzzkChat.h>
+
+#include <cstring>
+#include <chrono>
+#include <thread>
+
+#if _DEBUG
+#include <iostream>
+#endif
+
+#if _USE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace chzzkpp
+{
+	static const char LOG_MAGIC[] = "CHZZKLOG";
+	static const uint32_t LOG_VERSION = 1;
+
+	static const size_t MAGIC_SIZE = 8;
+	static const size_t SEGMENT_HEADER_SIZE = MAGIC_SIZE + 4;
+	static const size_t BLOCK_HEADER_SIZE = 12;
+	static const size_t FRAME_HEADER_SIZE = 12;
+
+	static const uint32_t BLOCK_COMPRESSED = 1;
+
+	static void put_u32(std::string& dest, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+			dest.push_back((char)((value >> (i * 8)) & 0xFF));
+	}
+
+	static void put_u64(std::string& dest, uint64_t value)
+	{
+		for (int i = 0; i < 8; i++)
+			dest.push_back((char)((value >> (i * 8)) & 0xFF));
+	}
+
+	static uint32_t get_u32(const char* src)
+	{
+		uint32_t value = 0;
+
+		for (int i = 0; i < 4; i++)
+			value |= (uint32_t)(unsigned char)src[i] << (i * 8);
+
+		return value;
+	}
+
+	static uint64_t get_u64(const char* src)
+	{
+		uint64_t value = 0;
+
+		for (int i = 0; i < 8; i++)
+			value |= (uint64_t)(unsigned char)src[i] << (i * 8);
+
+		return value;
+	}
+
+	static bool file_exists(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return file.good();
+	}
+
+	ChzzkChatRecorder::ChzzkChatRecorder(const std::string& path, ChzzkRecorderOptions options)
+		: path(path), options(options), segmentIndex(0), segmentBytes(0), timer(&ChzzkTimer::shared()), flushTimerID(0), worker(&ChzzkWorker::shared()), writing(false), frames(0), writtenBytes(0)
+	{
+#if !_USE_ZLIB
+		if (options.compress) throw std::exception("Compressing chat logs needs _USE_ZLIB.");
+#endif
+
+		//appends after the existing segments
+		while (file_exists(getSegmentPath(path, segmentIndex)))
+			segmentIndex++;
+
+		block.reserve(options.blockSize + FRAME_HEADER_SIZE);
+
+		//the timer only hands the block to the worker
+		if (options.flushTime > 0)
+			flushTimerID = timer->add(options.flushTime, [this]() {
+				std::lock_guard<std::mutex> guard(mutex);
+
+				sealBlock();
+				if (!pending.empty()) queueWrite();
+			}, true);
+	}
+
+	ChzzkChatRecorder::~ChzzkChatRecorder()
+	{
+		if (flushTimerID) timer->remove(flushTimerID);
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			written.wait(lock, [&]() { return !writing; });
+		}
+
+		try
+		{
+			flush();
+		}
+		catch (std::exception& e)
+		{
+#if _DEBUG
+			std::cerr << e.what() << std::endl;
+#endif
+		}
+	}
+
+	void ChzzkChatRecorder::openSegment()
+	{
+		if (file.is_open()) file.close();
+
+		std::string segmentPath = getSegmentPath(path, segmentIndex++);
+		file.open(segmentPath, std::ios::binary | std::ios::trunc);
+
+		if (!file) throw std::exception(("Cannot open the chat log: " + segmentPath).c_str());
+
+		std::string header(LOG_MAGIC, MAGIC_SIZE);
+		put_u32(header, LOG_VERSION);
+
+		file.write(header.data(), header.size());
+		segmentBytes = header.size();
+		writtenBytes += header.size();
+	}
+
+	void ChzzkChatRecorder::sealBlock()
+	{
+		if (block.empty()) return;
+
+		pending.push_back(std::move(block));
+
+		block = std::move(spare);
+		block.clear();
+		block.reserve(options.blockSize + FRAME_HEADER_SIZE);
+	}
+
+	void ChzzkChatRecorder::queueWrite()
+	{
+		if (writing) return;
+		writing = true;
+
+		worker->post([this]() {
+			bool failed = false;
+
+			try
+			{
+				writePending();
+			}
+			catch (std::exception& e)
+			{
+#if _DEBUG
+				std::cerr << e.what() << std::endl;
+#endif
+				//the failed block is written again with the next block or flush
+				failed = true;
+			}
+
+			std::lock_guard<std::mutex> guard(mutex);
+
+			//blocks sealed while writing get another task
+			writing = false;
+			if (!failed && !pending.empty()) queueWrite();
+
+			written.notify_all();
+		});
+	}
+
+	void ChzzkChatRecorder::writePending()
+	{
+		std::lock_guard<std::mutex> fileGuard(fileMutex);
+
+		while (true)
+		{
+			const std::string* next;
+
+			{
+				std::lock_guard<std::mutex> guard(mutex);
+
+				if (pending.empty()) break;
+				next = &pending.front(); //only popped here, under fileMutex
+			}
+
+			writeBlock(*next);
+
+			{
+				std::lock_guard<std::mutex> guard(mutex);
+
+				spare = std::move(pending.front());
+				pending.pop_front();
+			}
+		}
+	}
+
+	void ChzzkChatRecorder::writeBlock(const std::string& raw)
+	{
+		const std::string* stored = &raw;
+		uint32_t flags = 0;
+
+#if _USE_ZLIB
+		if (options.compress)
+		{
+			uLongf size = compressBound((uLong)raw.size());
+			compressed.resize(size);
+
+			//blocks which don't get smaller are stored as they are
+			if (compress2((Bytef*)&compressed[0], &size, (const Bytef*)raw.data(), (uLong)raw.size(), Z_BEST_SPEED) == Z_OK && size < raw.size())
+			{
+				compressed.resize(size);
+				stored = &compressed;
+				flags |= BLOCK_COMPRESSED;
+			}
+		}
+#endif
+
+		size_t blockBytes = BLOCK_HEADER_SIZE + stored->size();
+
+		if (!file.is_open() || (segmentBytes > SEGMENT_HEADER_SIZE && segmentBytes + blockBytes > options.segmentSize))
+			openSegment();
+
+		std::string header;
+		put_u32(header, (uint32_t)stored->size());
+		put_u32(header, (uint32_t)raw.size());
+		put_u32(header, flags);
+
+		//flushed before the block leaves pending, so a failure is found while the block is kept
+		file.write(header.data(), header.size());
+		file.write(stored->data(), stored->size());
+		file.flush();
+
+		if (!file)
+		{
+			//the segment can end with a part of the block, which the replayer ignores. the block is written again to a new segment
+			file.close();
+			throw std::exception("Error occured writing the chat log.");
+		}
+
+		segmentBytes += blockBytes;
+		writtenBytes += blockBytes;
+	}
+
+	void ChzzkChatRecorder::write(std::string_view frame)
+	{
+		auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		write(frame, (uint64_t)now);
+	}
+
+	void ChzzkChatRecorder::write(std::string_view frame, uint64_t time)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		put_u64(block, time);
+		put_u32(block, (uint32_t)frame.size());
+		block.append(frame.data(), frame.size());
+
+		frames++;
+
+		if (block.size() >= options.blockSize)
+		{
+			sealBlock();
+			queueWrite();
+		}
+	}
+
+	void ChzzkChatRecorder::flush()
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			sealBlock();
+		}
+
+		writePending();
+	}
+
+	uint64_t ChzzkChatRecorder::getFrameCount() const
+	{
+		return frames;
+	}
+
+	uint64_t ChzzkChatRecorder::getWrittenBytes() const
+	{
+		return writtenBytes;
+	}
+
+	std::string ChzzkChatRecorder::getSegmentPath(const std::string& path, size_t index)
+	{
+		std::string number = std::to_string(index);
+		if (number.size() < 6) number.insert(0, 6 - number.size(), '0');
+
+		return path + "." + number;
+	}
+
+	//read-only memory mapping of a whole file
+	class ChzzkMappedFile
+	{
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#else
+		int fd = -1;
+#endif
+		const char* data = nullptr;
+		size_t size = 0;
+
+	public:
+		explicit ChzzkMappedFile(const std::string& path)
+		{
+#ifdef _WIN32
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) throw std::exception(("Cannot open the chat log: " + path).c_str());
+
+			LARGE_INTEGER fileSize;
+			GetFileSizeEx(file, &fileSize);
+			size = (size_t)fileSize.QuadPart;
+
+			if (!size) return;
+
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping) data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+			fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0) throw std::exception(("Cannot open the chat log: " + path).c_str());
+
+			struct stat st;
+			fstat(fd, &st);
+			size = (size_t)st.st_size;
+
+			if (!size) return;
+
+			void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (mapped != MAP_FAILED)
+			{
+				data = (const char*)mapped;
+
+				//frames are read once in order
+				madvise(mapped, size, MADV_SEQUENTIAL);
+			}
+#endif
+			if (!data) throw std::exception(("Cannot map the chat log: " + path).c_str());
+		}
+
+		~ChzzkMappedFile()
+		{
+#ifdef _WIN32
+			if (data) UnmapViewOfFile(data);
+			if (mapping) CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+			if (data) munmap((void*)data, size);
+			if (fd >= 0) ::close(fd);
+#endif
+		}
+
+		ChzzkMappedFile(const ChzzkMappedFile&) = delete;
+		ChzzkMappedFile& operator=(const ChzzkMappedFile&) = delete;
+
+		const char* getData() const
+		{
+			return data;
+		}
+
+		size_t getSize() const
+		{
+			return size;
+		}
+	};
+
+	ChzzkChatReplayer::ChzzkChatReplayer(const std::string& path) : stopped(false)
+	{
+		for (size_t index = 0;; index++)
+		{
+			std::string segmentPath = ChzzkChatRecorder::getSegmentPath(path, index);
+			if (!file_exists(segmentPath)) break;
+
+			segments.push_back(segmentPath);
+		}
+	}
+
+	const std::vector<std::string>& ChzzkChatReplayer::getSegments() const
+	{
+		return segments;
+	}
+
+	size_t ChzzkChatReplayer::replay(const std::function<void(uint64_t time, std::string_view frame)>& callback, double speed)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		stopped = false;
+
+		size_t count = 0;
+		bool started = false;
+		uint64_t firstTime = 0;
+		Clock::time_point startTime;
+
+		std::string decompressed;
+
+		for (auto& segmentPath : segments)
+		{
+			ChzzkMappedFile mapped(segmentPath);
+
+			const char* data = mapped.getData();
+			size_t size = mapped.getSize();
+
+			if (size < SEGMENT_HEADER_SIZE || std::memcmp(data, LOG_MAGIC, MAGIC_SIZE) != 0)
+				throw std::exception(("Invalid chat log: " + segmentPath).c_str());
+
+			if (get_u32(data + MAGIC_SIZE) != LOG_VERSION)
+				throw std::exception(("Unsupported version of the chat log: " + segmentPath).c_str());
+
+			size_t position = SEGMENT_HEADER_SIZE;
+
+			while (position + BLOCK_HEADER_SIZE <= size)
+			{
+				uint32_t storedSize = get_u32(data + position);
+				uint32_t rawSize = get_u32(data + position + 4);
+				uint32_t flags = get_u32(data + position + 8);
+
+				position += BLOCK_HEADER_SIZE;
+
+				//cut by a crash while writing
+				if (position + storedSize > size) break;
+
+				const char* raw = data + position;
+				position += storedSize;
+
+				if (flags & BLOCK_COMPRESSED)
+				{
+#if _USE_ZLIB
+					decompressed.resize(rawSize);
+					uLongf length = rawSize;
+
+					if (uncompress((Bytef*)&decompressed[0], &length, (const Bytef*)raw, storedSize) != Z_OK || length != rawSize)
+						throw std::exception(("Corrupted block in the chat log: " + segmentPath).c_str());
+
+					raw = decompressed.data();
+#else
+					throw std::exception("Replaying compressed chat logs needs _USE_ZLIB.");
+#endif
+				}
+				else if (storedSize != rawSize)
+					throw std::exception(("Corrupted block in the chat log: " + segmentPath).c_str());
+
+				//frames of uncompressed blocks are passed straight from the mapping
+				for (size_t offset = 0; offset + FRAME_HEADER_SIZE <= rawSize;)
+				{
+					uint64_t time = get_u64(raw + offset);
+					uint32_t length = get_u32(raw + offset + 8);
+
+					offset += FRAME_HEADER_SIZE;
+					if (offset + length > rawSize) break;
+
+					if (speed > 0)
+					{
+						if (!started)
+						{
+							started = true;
+							firstTime = time;
+							startTime = Clock::now();
+						}
+						else if (time > firstTime)
+						{
+							auto delay = std::chrono::duration<double, std::micro>((time - firstTime) / speed);
+							std::this_thread::sleep_until(startTime + std::chrono::duration_cast<Clock::duration>(delay));
+						}
+					}
+
+					callback(time, std::string_view(raw + offset, length));
+					count++;
+
+					offset += length;
+
+					if (stopped) return count;
+				}
+			}
+		}
+
+		return count;
+	}
+
+	size_t ChzzkChatReplayer::replay(ChzzkChat& chat, double speed)
+	{
+		return replay([&chat](uint64_t, std::string_view frame) { chat.feed(frame); }, speed);
+	}
+
+	void ChzzkChatReplayer::stop()
+	{
+		stopped = true;
+	}
+}
@@ -0,0 +1,191 @@
+#include <chzzkpp/ChzzkChatView.h>
+#include <chzzkpp/ChzzkUtils.h>
+
+namespace chzzkpp
+{
+	//parses nested json string. returns null json if empty or invalid
+	static nlohmann::json parseNested(const std::string& raw)
+	{
+		if (raw.empty()) return nlohmann::json();
+
+		auto json = nlohmann::json::parse(raw, nullptr, false);
+		if (json.is_discarded()) return nlohmann::json();
+
+		return json;
+	}
+
+	//moves the string out of json[key] if it is a string
+	static void takeString(std::string& dest, nlohmann::json& json, const char* key)
+	{
+		auto it = json.find(key);
+
+		if (it != json.end() && it->is_string()) dest = std::move(it->get_ref<std::string&>());
+		else dest.clear();
+	}
+
+	ChzzkChatView::ChzzkChatView() : _time(0), _memberCount(0), _hidden(false), _isRecent(false)
+	{
+
+	}
+
+	ChzzkChatView::ChzzkChatView(nlohmann::json& json, bool isRecent) : _time(0), _memberCount(0), _hidden(false), _isRecent(isRecent)
+	{
+		takeString(_rawProfile, json, "profile");
+		takeString(_rawExtras, json, "extras");
+
+		if (json.find("msg") != json.end()) takeString(_message, json, "msg");
+		else takeString(_message, json, "content"); //case of recent message
+
+		if (json.find("mbrCnt") != json.end()) json_safe_get(_memberCount, json, "mbrCnt");
+		else if (json.find("memberCount") != json.end()) json_safe_get(_memberCount, json, "memberCount"); //case of recent message
+
+		if (json.find("msgTime") != json.end()) json_safe_get(_time, json, "msgTime");
+		else if (json.find("messageTime") != json.end()) json_safe_get(_time, json, "messageTime"); //case of recent message
+
+		std::string messageStatusType;
+
+		if (json.find("msgStatusType") != json.end()) takeString(messageStatusType, json, "msgStatusType");
+		else takeString(messageStatusType, json, "messageStatusType"); //case of recent message
+
+		_hidden = (messageStatusType == "HIDDEN");
+	}
+
+	ChzzkChatView::ChzzkChatView(std::string&& message, std::string&& rawProfile, std::string&& rawExtras, unsigned long long time, int memberCount, bool hidden, bool isRecent)
+		: _message(std::move(message)), _time(time), _memberCount(memberCount), _hidden(hidden), _isRecent(isRecent), _rawProfile(std::move(rawProfile)), _rawExtras(std::move(rawExtras))
+	{
+
+	}
+
+	void ChzzkChatView::release(std::string& message, std::string& rawProfile, std::string& rawExtras)
+	{
+		message = std::move(_message);
+		rawProfile = std::move(_rawProfile);
+		rawExtras = std::move(_rawExtras);
+
+		_message.clear();
+		_rawProfile.clear();
+		_rawExtras.clear();
+	}
+
+	const std::string& ChzzkChatView::message() const
+	{
+		return _message;
+	}
+
+	unsigned long long ChzzkChatView::time() const
+	{
+		return _time;
+	}
+
+	int ChzzkChatView::memberCount() const
+	{
+		return _memberCount;
+	}
+
+	bool ChzzkChatView::hidden() const
+	{
+		return _hidden;
+	}
+
+	bool ChzzkChatView::isRecent() const
+	{
+		return _isRecent;
+	}
+
+	const std::string& ChzzkChatView::rawProfile() const
+	{
+		return _rawProfile;
+	}
+
+	const std::string& ChzzkChatView::rawExtras() const
+	{
+		return _rawExtras;
+	}
+
+	const nlohmann::json& ChzzkChatView::profile() const
+	{
+		std::call_once(profileFlag, [this]() { _profile = parseNested(_rawProfile); });
+		return _profile;
+	}
+
+	const nlohmann::json& ChzzkChatView::extras() const
+	{
+		std::call_once(extrasFlag, [this]() { _extras = parseNested(_rawExtras); });
+		return _extras;
+	}
+
+	const nlohmann::json& ChzzkChatView::paramsProfile(std::once_flag& flag, nlohmann::json& dest, const char* key) const
+	{
+		std::call_once(flag, [&]() {
+			auto& extras = this->extras();
+
+			auto params = extras.find("params");
+			if (params == extras.end() || !params->is_object()) return;
+
+			auto raw = params->find(key);
+			if (raw == params->end() || !raw->is_string()) return;
+
+			dest = parseNested(raw->get_ref<const std::string&>());
+		});
+
+		return dest;
+	}
+
+	const nlohmann::json& ChzzkChatView::registerChatProfile() const
+	{
+		return paramsProfile(registerChatProfileFlag, _registerChatProfile, "registerChatProfileJson");
+	}
+
+	const nlohmann::json& ChzzkChatView::targetChatProfile() const
+	{
+		return paramsProfile(targetChatProfileFlag, _targetChatProfile, "targetChatProfileJson");
+	}
+
+	std::string ChzzkChatView::nickname() const
+	{
+		std::string nickname;
+		json_safe_get(nickname, profile(), "nickname");
+
+		return nickname;
+	}
+
+	int ChzzkChatView::payAmount() const
+	{
+		int payAmount;
+		json_safe_get(payAmount, extras(), "payAmount");
+
+		return payAmount;
+	}
+
+	nlohmann::json ChzzkChatView::toJson() const
+	{
+		auto extras = this->extras();
+
+		auto& registerChatProfile = this->registerChatProfile();
+		auto& targetChatProfile = this->targetChatProfile();
+
+		if (!registerChatProfile.is_null() && !targetChatProfile.is_null())
+		{
+			auto& params = extras["params"];
+
+			params["registerChatProfile"] = registerChatProfile;
+			params["targetChatProfile"] = targetChatProfile;
+
+			params.erase("registerChatProfileJson");
+			params.erase("targetChatProfileJson");
+		}
+
+		nlohmann::json parsed = {
+			{"profile", profile()},
+			{"extras", extras},
+			{"hidden", _hidden},
+			{"message", _message},
+			{"time", _time},
+			{"isRecent", _isRecent}
+		};
+
+		if (_memberCount) parsed["memberCount"] = _memberCount;
+
+		return parsed;
+	}
+}
@@ -1,5 +1,6 @@
 #include <chzzkpp/ChzzkClient.h>
 #include <chzzkpp/ChzzkUtils.h>
+#include <chzzkpp/ChzzkSax.h>
 
 #if _DEBUG
 #include <iostream>
@@ -7,25 +8,184 @@
 
 namespace chzzkpp
 {
-	ChzzkClient::ChzzkClient(ChzzkCore* core) : core(core)
+	//content tables of the list endpoints for ChzzkDecodeMode::STREAMING
+
+	static constexpr ChzzkField TOP_VIEWER_LIVES_FIELDS[] = {
+		chzzk_list_field<ChzzkTopViewerResult, &ChzzkTopViewerResult::lives>("data", ChzzkFields<ChzzkLiveBase>::table)
+	};
+
+	static constexpr ChzzkFieldTable TOP_VIEWER_LIVES_TABLE = chzzk_table(TOP_VIEWER_LIVES_FIELDS);
+
+	static constexpr ChzzkField RECOMMENDATION_LIVES_FIELDS[] = {
+		chzzk_list_field<ChzzkLiveResult, &ChzzkLiveResult::lives>("topRecommendedLives", ChzzkFields<ChzzkLive>::table)
+	};
+
+	static constexpr ChzzkFieldTable RECOMMENDATION_LIVES_TABLE = chzzk_table(RECOMMENDATION_LIVES_FIELDS);
+
+	//search results are {"channel": {...}}
+	static constexpr ChzzkField SEARCH_CHANNEL_ELEMENT_FIELDS[] = {
+		chzzk_inline_field("channel", ChzzkFields<ChzzkChannelInfo>::table)
+	};
+
+	static constexpr ChzzkFieldTable SEARCH_CHANNEL_ELEMENT_TABLE = chzzk_table(SEARCH_CHANNEL_ELEMENT_FIELDS);
+
+	static constexpr ChzzkField SEARCH_CHANNEL_FIELDS[] = {
+		chzzk_list_field<ChzzkChannelResult, &ChzzkChannelResult::channels>("data", SEARCH_CHANNEL_ELEMENT_TABLE)
+	};
+
+	static constexpr ChzzkFieldTable SEARCH_CHANNEL_TABLE = chzzk_table(SEARCH_CHANNEL_FIELDS);
+
+	//search results are {"live": {...}, "channel": {...}}
+	static constexpr ChzzkField SEARCH_LIVE_ELEMENT_FIELDS[] = {
+		chzzk_inline_field("live", ChzzkFields<ChzzkLive>::table),
+		chzzk_object_field<ChzzkLive, &ChzzkLive::channelInfo>("channel", ChzzkFields<ChzzkChannelInfo>::table)
+	};
+
+	static constexpr ChzzkFieldTable SEARCH_LIVE_ELEMENT_TABLE = chzzk_table(SEARCH_LIVE_ELEMENT_FIELDS);
+
+	static constexpr ChzzkField SEARCH_LIVE_FIELDS[] = {
+		chzzk_list_field<ChzzkLiveResult, &ChzzkLiveResult::lives>("data", SEARCH_LIVE_ELEMENT_TABLE)
+	};
+
+	static constexpr ChzzkFieldTable SEARCH_LIVE_TABLE = chzzk_table(SEARCH_LIVE_FIELDS);
+
+	//search results are {"video": {...}, "channel": {...}}
+	static constexpr ChzzkField SEARCH_VIDEO_ELEMENT_FIELDS[] = {
+		chzzk_inline_field("video", ChzzkFields<ChzzkVideoInfo>::table),
+		chzzk_object_field<ChzzkVideoInfo, &ChzzkVideoInfo::channelInfo>("channel", ChzzkFields<ChzzkChannelInfo>::table)
+	};
+
+	static constexpr ChzzkFieldTable SEARCH_VIDEO_ELEMENT_TABLE = chzzk_table(SEARCH_VIDEO_ELEMENT_FIELDS);
+
+	static constexpr ChzzkField SEARCH_VIDEO_FIELDS[] = {
+		chzzk_list_field<ChzzkVideoResult, &ChzzkVideoResult::videos>("data", SEARCH_VIDEO_ELEMENT_TABLE)
+	};
+
+	static constexpr ChzzkFieldTable SEARCH_VIDEO_TABLE = chzzk_table(SEARCH_VIDEO_FIELDS);
+
+	static constexpr ChzzkField MISSIONS_FIELDS[] = {
+		chzzk_field<ChzzkMissionResult, &ChzzkMissionResult::totalCount>("totalCount"),
+		chzzk_field<ChzzkMissionResult, &ChzzkMissionResult::totalPages>("totalPages"),
+		chzzk_list_field<ChzzkMissionResult, &ChzzkMissionResult::missions>("data", ChzzkFields<ChzzkMissionInfo>::table)
+	};
+
+	static constexpr ChzzkFieldTable MISSIONS_TABLE = chzzk_table(MISSIONS_FIELDS);
+
+	//response of the api
+	template <typename T>
+	struct ChzzkResponse
+	{
+		int code;
+		std::string message;
+		T content;
+	};
+
+	ChzzkClient::ChzzkClient(ChzzkCore* core) : core(core), decodeMode(ChzzkDecodeMode::DOM), coalesced(0)
+	{
+
+	}
+
+	ChzzkClient::~ChzzkClient()
+	{
+		std::lock_guard<std::mutex> guard(batchMutex);
+
+		for (auto& batch : batches)
+			if (batch.valid()) batch.wait();
+
+		batches.clear();
+	}
+
+	template <typename T>
+	void ChzzkClient::requestBatch(const std::vector<std::string>& paths, const std::function<void(size_t, std::future<T>)>& callback, size_t maxInFlight)
+	{
+		core->requestBatch(paths, [&](size_t index, std::string& response, bool failed) {
+			std::promise<T> promise;
+
+			try
+			{
+				if (failed) throw std::exception(response.c_str());
+
+				promise.set_value(parse<T>(getContent(response)));
+			}
+			catch (...)
+			{
+				promise.set_exception(std::current_exception());
+			}
+
+			callback(index, promise.get_future());
+		}, maxInFlight);
+	}
+
+	template <typename T>
+	std::vector<std::future<T>> ChzzkClient::requestBatchAsync(const std::vector<std::string>& paths, size_t maxInFlight)
 	{
+		auto promises = std::make_shared<std::vector<std::promise<T>>>(paths.size());
 
+		std::vector<std::future<T>> futures;
+		futures.reserve(paths.size());
+
+		for (auto& promise : *promises)
+			futures.push_back(promise.get_future());
+
+		std::lock_guard<std::mutex> guard(batchMutex);
+
+		//remove finished batches
+		for (auto it = batches.begin(); it != batches.end();)
+		{
+			if (it->wait_for(std::chrono::seconds(0)) == std::future_status::ready) it = batches.erase(it);
+			else it++;
+		}
+
+		batches.push_back(std::async(std::launch::async, [this, paths, promises, maxInFlight]() {
+			try
+			{
+				requestBatch<T>(paths, [&](size_t index, std::future<T> result) {
+					try
+					{
+						(*promises)[index].set_value(result.get());
+					}
+					catch (...)
+					{
+						(*promises)[index].set_exception(std::current_exception());
+					}
+				}, maxInFlight);
+			}
+			catch (...)
+			{
+				//batch failed before completing. fail the remaining promises
+				for (auto& promise : *promises)
+				{
+					try
+					{
+						promise.set_exception(std::current_exception());
+					}
+					catch (std::future_error&)
+					{
+					}
+				}
+			}
+		}));
+
+		return futures;
 	}
 
 	nlohmann::json ChzzkClient::getContent(const std::string& data)
 	{
-		if (!nlohmann::json::accept(data))
+		//parse once without exceptions, instead of validating and parsing again
+		nlohmann::json json = nlohmann::json::parse(data, nullptr, false);
+
+		if (json.is_discarded())
 		{
 #if _DEBUG
 			std::cerr << "Input data is not JSON object: " << data << std::endl;
 #endif
-			return nlohmann::json();
+			throw std::exception("Input data is not JSON object.");
 		}
 
-		nlohmann::json json = nlohmann::json::parse(data);
 		int code = json["code"];
 
-		if (code == 200) return json["content"];
+		//content is moved out of the response, not copied
+		if (code == 200) return std::move(json["content"]);
 		else
 		{
 			std::string message = json["message"];
@@ -41,24 +201,171 @@ namespace chzzkpp
 
 	}
 
+	template <typename T>
+	T ChzzkClient::streamContent(const std::string& data, const ChzzkFieldTable& table)
+	{
+		ChzzkField fields[] = {
+			chzzk_field<ChzzkResponse<T>, &ChzzkResponse<T>::code>("code"),
+			chzzk_field<ChzzkResponse<T>, &ChzzkResponse<T>::message>("message"),
+			chzzk_object_field<ChzzkResponse<T>, &ChzzkResponse<T>::content>("content", table)
+		};
+
+		ChzzkResponse<T> response = ChzzkResponse<T>();
+
+		if (!parse_stream(data, chzzk_table(fields), &response))
+		{
+#if _DEBUG
+			std::cerr << "Input data is not JSON object: " << data << std::endl;
+#endif
+			throw std::exception("Input data is not JSON object.");
+		}
+
+		if (response.code != 200)
+		{
+			auto e = invalid_status_exception(response.code, response.message);
+
+#if _DEBUG
+			std::cerr << e.what() << std::endl;
+#endif
+			throw e;
+		}
+
+		return std::move(response.content);
+	}
+
+	template <typename T, typename F>
+	T ChzzkClient::singleFlight(const std::string& name, F&& func)
+	{
+		//ex) getUserData and getAccessToken of another user should not get this result
+		std::string key = core->getAuthIdentity() + " " + name;
+
+		std::promise<T> promise;
+		std::shared_future<T> future;
+		bool leader = false;
+
+		{
+			std::lock_guard<std::mutex> guard(flightMutex);
+
+			auto it = flights.find(key);
+
+			if (it != flights.end())
+			{
+				future = *static_cast<std::shared_future<T>*>(it->second.get());
+				coalesced++;
+			}
+			else
+			{
+				future = promise.get_future().share();
+				flights.emplace(key, std::make_shared<std::shared_future<T>>(future));
+				leader = true;
+			}
+		}
+
+		if (leader)
+		{
+			try
+			{
+				promise.set_value(func());
+			}
+			catch (...)
+			{
+				promise.set_exception(std::current_exception());
+			}
+
+			std::lock_guard<std::mutex> guard(flightMutex);
+			flights.erase(key);
+		}
+
+		//throws the exception of the leader to every waiter
+		return future.get();
+	}
+
 	ChzzkChannel ChzzkClient::getChannel(const std::string& channelID)
 	{
-		return parse<ChzzkChannel>(getContent(core->getChannel(channelID)));
+		return singleFlight<ChzzkChannel>("getChannel " + channelID, [&]() {
+			return parse<ChzzkChannel>(getContent(core->getChannel(channelID)));
+		});
 	}
 
 	ChzzkLiveStatus ChzzkClient::getLiveStatus(const std::string& channelID)
 	{
-		return parse<ChzzkLiveStatus>(getContent(core->getLiveStatus(channelID)));
+		return singleFlight<ChzzkLiveStatus>("getLiveStatus " + channelID, [&]() {
+			return parse<ChzzkLiveStatus>(getContent(core->getLiveStatus(channelID)));
+		});
 	}
 
 	ChzzkLiveDetail ChzzkClient::getLiveDetail(const std::string& channelID)
 	{
-		return parse<ChzzkLiveDetail>(getContent(core->getLiveDetail(channelID)));
+		return singleFlight<ChzzkLiveDetail>("getLiveDetail " + channelID, [&]() {
+			return parse<ChzzkLiveDetail>(getContent(core->getLiveDetail(channelID)));
+		});
 	}
 
 	ChzzkVideo ChzzkClient::getVideo(int videoNo)
 	{
-		return parse<ChzzkVideo>(getContent(core->getVideo(videoNo)));
+		return singleFlight<ChzzkVideo>("getVideo " + std::to_string(videoNo), [&]() {
+			return parse<ChzzkVideo>(getContent(core->getVideo(videoNo)));
+		});
+	}
+
+	std::vector<std::future<ChzzkChannel>> ChzzkClient::getChannelBatch(const std::vector<std::string>& channelIDs, size_t maxInFlight)
+	{
+		std::vector<std::string> paths;
+
+		for (auto& channelID : channelIDs)
+			paths.push_back(getChannelPath(channelID));
+
+		return requestBatchAsync<ChzzkChannel>(paths, maxInFlight);
+	}
+
+	void ChzzkClient::getChannelBatch(const std::vector<std::string>& channelIDs, const std::function<void(size_t, std::future<ChzzkChannel>)>& callback, size_t maxInFlight)
+	{
+		std::vector<std::string> paths;
+
+		for (auto& channelID : channelIDs)
+			paths.push_back(getChannelPath(channelID));
+
+		requestBatch<ChzzkChannel>(paths, callback, maxInFlight);
+	}
+
+	std::vector<std::future<ChzzkLiveStatus>> ChzzkClient::getLiveStatusBatch(const std::vector<std::string>& channelIDs, size_t maxInFlight)
+	{
+		std::vector<std::string> paths;
+
+		for (auto& channelID : channelIDs)
+			paths.push_back(getLiveStatusPath(channelID));
+
+		return requestBatchAsync<ChzzkLiveStatus>(paths, maxInFlight);
+	}
+
+	void ChzzkClient::getLiveStatusBatch(const std::vector<std::string>& channelIDs, const std::function<void(size_t, std::future<ChzzkLiveStatus>)>& callback, size_t maxInFlight)
+	{
+		std::vector<std::string> paths;
+
+		for (auto& channelID : channelIDs)
+			paths.push_back(getLiveStatusPath(channelID));
+
+		requestBatch<ChzzkLiveStatus>(paths, callback, maxInFlight);
+	}
+
+	std::vector<std::future<ChzzkLiveDetail>> ChzzkClient::getLiveDetailBatch(const std::vector<std::string>& channelIDs, size_t maxInFlight)
+	{
+		std::vector<std::string> paths;
+
+		for (auto& channelID : channelIDs)
+			paths.push_back(getLiveDetailPath(channelID));
+
+		return requestBatchAsync<ChzzkLiveDetail>(paths, maxInFlight);
+	}
+
+	void ChzzkClient::getLiveDetailBatch(const std::vector<std::string>& channelIDs, const std::function<void(size_t, std::future<ChzzkLiveDetail>)>& callback, size_t maxInFlight)
+	{
+		std::vector<std::string> paths;
+
+		for (auto& channelID : channelIDs)
+			paths.push_back(getLiveDetailPath(channelID));
+
+		requestBatch<ChzzkLiveDetail>(paths, callback, maxInFlight);
 	}
 
 	ChzzkTopViewerResult ChzzkClient::getTopViewerLives(int size)
@@ -68,6 +375,12 @@ namespace chzzkpp
 		result.requested_size = size;
 		result.offset = 0;
 
+		if (decodeMode == ChzzkDecodeMode::STREAMING)
+		{
+			result.lives = streamContent<ChzzkTopViewerResult>(core->getTopViewerLives(size), TOP_VIEWER_LIVES_TABLE).lives;
+			return result;
+		}
+
 		auto content = getContent(core->getTopViewerLives(size));
 
 		for (auto& element : content["data"])
@@ -83,6 +396,12 @@ namespace chzzkpp
 		result.requested_size = size;
 		result.offset = 0;
 
+		if (decodeMode == ChzzkDecodeMode::STREAMING)
+		{
+			result.lives = streamContent<ChzzkTopViewerResult>(core->getTopViewerLives(keyword, size), TOP_VIEWER_LIVES_TABLE).lives;
+			return result;
+		}
+
 		auto content = getContent(core->getTopViewerLives(keyword, size));
 
 		for (auto& element : content["data"])
@@ -122,6 +441,12 @@ namespace chzzkpp
 		result.offset = 0;
 		result.requested_size = 0;
 
+		if (decodeMode == ChzzkDecodeMode::STREAMING)
+		{
+			result.lives = streamContent<ChzzkLiveResult>(core->getRecommendationLives(), RECOMMENDATION_LIVES_TABLE).lives;
+			return result;
+		}
+
 		auto content = getContent(core->getRecommendationLives());
 
 		for (auto& element : content["topRecommendedLives"])
@@ -132,12 +457,16 @@ namespace chzzkpp
 
 	ChzzkUserData ChzzkClient::getUserData()
 	{
-		return parse<ChzzkUserData>(getContent(core->getUserData()));
+		return singleFlight<ChzzkUserData>(std::string("getUserData"), [&]() {
+			return parse<ChzzkUserData>(getContent(core->getUserData()));
+		});
 	}
 
 	ChzzkAccessToken ChzzkClient::getAccessToken(const std::string& chatChannelID)
 	{
-		return parse<ChzzkAccessToken>(getContent(core->getAccessToken(chatChannelID)));
+		return singleFlight<ChzzkAccessToken>("getAccessToken " + chatChannelID, [&]() {
+			return parse<ChzzkAccessToken>(getContent(core->getAccessToken(chatChannelID)));
+		});
 	}
 
 	ChzzkChannelResult ChzzkClient::searchChannel(const std::string& keyword, int offset, int size, bool withFirstChannelContent)
@@ -147,6 +476,12 @@ namespace chzzkpp
 		result.offset = offset;
 		result.requested_size = size;
 
+		if (decodeMode == ChzzkDecodeMode::STREAMING)
+		{
+			result.channels = streamContent<ChzzkChannelResult>(core->searchChannel(keyword, offset, size, withFirstChannelContent), SEARCH_CHANNEL_TABLE).channels;
+			return result;
+		}
+
 		auto content = getContent(core->searchChannel(keyword, offset, size, withFirstChannelContent));
 
 		for (auto& element : content["data"])
@@ -162,6 +497,12 @@ namespace chzzkpp
 		result.offset = offset;
 		result.requested_size = size;
 
+		if (decodeMode == ChzzkDecodeMode::STREAMING)
+		{
+			result.lives = streamContent<ChzzkLiveResult>(core->searchLive(keyword, offset, size), SEARCH_LIVE_TABLE).lives;
+			return result;
+		}
+
 		auto content = getContent(core->searchLive(keyword, offset, size));
 
 		for (auto& element : content["data"])
@@ -182,6 +523,12 @@ namespace chzzkpp
 		result.offset = offset;
 		result.requested_size = size;
 
+		if (decodeMode == ChzzkDecodeMode::STREAMING)
+		{
+			result.videos = streamContent<ChzzkVideoResult>(core->searchVideo(keyword, offset, size), SEARCH_VIDEO_TABLE).videos;
+			return result;
+		}
+
 		auto content = getContent(core->searchVideo(keyword, offset, size));
 
 		for (auto& element : content["data"])
@@ -197,6 +544,15 @@ namespace chzzkpp
 
 	ChzzkMissionResult ChzzkClient::getMissions(const std::string& channelID, bool mine, int page, int size)
 	{
+		if (decodeMode == ChzzkDecodeMode::STREAMING)
+		{
+			ChzzkMissionResult result = streamContent<ChzzkMissionResult>(core->getMissions(channelID, mine, page, size), MISSIONS_TABLE);
+			result.page = page;
+			result.size = size;
+
+			return result;
+		}
+
 		ChzzkMissionResult result;
 		result.page = page;
 		result.size = size;
@@ -217,27 +573,48 @@ namespace chzzkpp
 
 	ChzzkChatDonationSetting ChzzkClient::getChatDonationSetting(const std::string& channelID)
 	{
-		auto content = getContent(core->getChatDonationSetting(channelID));
+		return singleFlight<ChzzkChatDonationSetting>("getChatDonationSetting " + channelID, [&]() {
+			auto content = getContent(core->getChatDonationSetting(channelID));
 
-		return parse<ChzzkChatDonationSetting>(content);
+			return parse<ChzzkChatDonationSetting>(content);
+		});
 	}
 
 	ChzzkVideoDonationSetting ChzzkClient::getVideoDonationSetting(const std::string& channelID)
 	{
-		auto content = getContent(core->getVideoDonationSetting(channelID));
+		return singleFlight<ChzzkVideoDonationSetting>("getVideoDonationSetting " + channelID, [&]() {
+			auto content = getContent(core->getVideoDonationSetting(channelID));
 
-		return parse<ChzzkVideoDonationSetting>(content);
+			return parse<ChzzkVideoDonationSetting>(content);
+		});
 	}
 
 	ChzzkMissionDonationSetting ChzzkClient::getMissionDonationSetting(const std::string& channelID)
 	{
-		auto content = getContent(core->getMissionDonationSetting(channelID));
+		return singleFlight<ChzzkMissionDonationSetting>("getMissionDonationSetting " + channelID, [&]() {
+			auto content = getContent(core->getMissionDonationSetting(channelID));
+
+			return parse<ChzzkMissionDonationSetting>(content);
+		});
+	}
+
+	void ChzzkClient::setDecodeMode(ChzzkDecodeMode mode)
+	{
+		decodeMode = mode;
+	}
 
-		return parse<ChzzkMissionDonationSetting>(content);
+	ChzzkDecodeMode ChzzkClient::getDecodeMode() const
+	{
+		return decodeMode;
 	}
 
 	ChzzkCore* ChzzkClient::getCore()
 	{
 		return core;
 	}
+
+	uint64_t ChzzkClient::getCoalescedCount() const
+	{
+		return coalesced;
+	}
 }
\ No newline at end of file
@@ -1,7 +1,17 @@
 #include <chzzkpp/ChzzkCore.h>
+#include <chzzkpp/ChzzkShare.h>
 #include <chzzkpp/Path.h>
 #include <chzzkpp/ChzzkUtils.h>
 
+#include <thread>
+#include <deque>
+#include <queue>
+#include <condition_variable>
+
+#if _DEBUG
+#include <iostream>
+#endif
+
 #ifdef _WIN32
 
 #pragma comment (lib, "ws2_32.lib")
@@ -30,77 +40,642 @@ namespace chzzkpp
 		return newLength;
 	}
 
-	ChzzkCore::ChzzkCore(int timeout) : timeout(timeout)
+	//collects the validators of the response into ChzzkCacheEntry
+	static size_t curl_header_validator_callback(char* buffer, size_t size, size_t nitems, ChzzkCacheEntry* entry)
+	{
+		size_t length = size * nitems;
+
+		std::string line(buffer, length);
+		size_t colon = line.find(':');
+
+		if (colon == std::string::npos) return length;
+
+		std::string name = line.substr(0, colon);
+
+		for (auto& c : name)
+			c = (char)tolower((unsigned char)c);
+
+		size_t begin = line.find_first_not_of(" \t", colon + 1);
+		size_t end = line.find_last_not_of(" \t\r\n");
+
+		std::string value = (begin == std::string::npos || end < begin) ? "" : line.substr(begin, end - begin + 1);
+
+		if (name == "etag") entry->etag = std::move(value);
+		else if (name == "last-modified") entry->lastModified = std::move(value);
+
+		return length;
+	}
+
+	ChzzkCore::ChzzkCore(int timeout, size_t poolSize) : transport(nullptr), poolSize(poolSize), shareConnection(true), poolHits(0), poolMisses(0), timeout(timeout), retried(0), failed(0)
 	{
 		_hasAuth = false;
 		authKeys = { "", "" };
+	}
 
-		curl = curl_easy_init();
+	ChzzkCore::~ChzzkCore()
+	{
+		std::lock_guard<std::mutex> guard(poolMutex);
 
-		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+		for (auto handle : idleHandles)
+			curl_easy_cleanup(handle);
 
-		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_string_callback);
+		idleHandles.clear();
 	}
 
-	ChzzkCore::~ChzzkCore()
+	CURL* ChzzkCore::createHandle()
 	{
-		curl_easy_cleanup(curl);
-		curl = nullptr;
+		CURL* handle = curl_easy_init();
+		if (!handle) return nullptr;
+
+		curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+		curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
+
+		curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, curl_write_string_callback);
+
+		if (shareConnection) ChzzkShare::shared().apply(handle);
+
+		return handle;
 	}
 
-	std::string ChzzkCore::request(const std::string& path)
+	CURL* ChzzkCore::acquireHandle()
 	{
+		{
+			std::lock_guard<std::mutex> guard(poolMutex);
+
+			if (!idleHandles.empty())
+			{
+				CURL* handle = idleHandles.back();
+				idleHandles.pop_back();
+
+				poolHits++;
+				return handle;
+			}
+		}
+
+		poolMisses++;
+		return createHandle();
+	}
+
+	void ChzzkCore::releaseHandle(CURL* handle)
+	{
+		{
+			std::lock_guard<std::mutex> guard(poolMutex);
+
+			if (idleHandles.size() < poolSize)
+			{
+				idleHandles.push_back(handle);
+				return;
+			}
+		}
+
+		curl_easy_cleanup(handle);
+	}
+
+	curl_slist* ChzzkCore::prepareHandle(CURL* handle, const std::string& path, std::string* response, const ChzzkCacheEntry* validator)
+	{
+		curl_easy_setopt(handle, CURLOPT_URL, path.c_str());
+
+		curl_easy_setopt(handle, CURLOPT_TIMEOUT, (long)timeout);
+
+		curl_easy_setopt(handle, CURLOPT_WRITEDATA, response);
+
+		curl_slist* slist = nullptr;
+
+		for (auto& header : makeHeaders(validator))
+			slist = curl_slist_append(slist, header.c_str());
+
+		curl_easy_setopt(handle, CURLOPT_HTTPHEADER, slist);
+
+		return slist;
+	}
+
+	void ChzzkCore::finishHandle(CURL* handle, curl_slist* slist)
+	{
+		//the handle should not keep the freed header list
+		curl_easy_setopt(handle, CURLOPT_HTTPHEADER, nullptr);
+		curl_slist_free_all(slist);
+
+		releaseHandle(handle);
+	}
+
+	//whether the request failed temporarily, so it may succeed if retried
+	static bool is_retryable(CURLcode result, long status)
+	{
+		switch (result)
+		{
+		case CURLE_OK:
+			return ChzzkRetryPolicy::retryable(status);
+
+		case CURLE_COULDNT_RESOLVE_HOST:
+		case CURLE_COULDNT_CONNECT:
+		case CURLE_OPERATION_TIMEDOUT:
+		case CURLE_SEND_ERROR:
+		case CURLE_RECV_ERROR:
+		case CURLE_GOT_NOTHING:
+		case CURLE_PARTIAL_FILE:
+		case CURLE_SSL_CONNECT_ERROR:
+		case CURLE_HTTP2:
+		case CURLE_HTTP2_STREAM:
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	void ChzzkCore::performHandle(const std::string& path, const ChzzkCacheEntry* validator, bool validators, ChzzkHttpResponse& response)
+	{
+		CURL* curl = acquireHandle();
+
 		if (!curl)
 		{
 			throw std::exception("Core is not initialized.");
-			return "";
+			return;
 		}
 
-		CURLcode result;
-		std::string response;
+		ChzzkCacheEntry received;
+		curl_slist* slist = prepareHandle(curl, path, &response.body, validator);
 
-		curl_easy_setopt(curl, CURLOPT_URL, path.c_str());
+		if (validators)
+		{
+			curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_header_validator_callback);
+			curl_easy_setopt(curl, CURLOPT_HEADERDATA, &received);
+		}
 
-		curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
+		CURLcode result = curl_easy_perform(curl);
 
-		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+		if (result == CURLE_OK)
+		{
+			curl_off_t retryAfter = 0;
 
-		curl_slist* slist = nullptr;
+			curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status);
+			curl_easy_getinfo(curl, CURLINFO_RETRY_AFTER, &retryAfter);
 
-		if (_hasAuth)
+			response.retryAfter = retryAfter;
+			response.etag = std::move(received.etag);
+			response.lastModified = std::move(received.lastModified);
+		}
+		else
 		{
-			std::string auth = "Cookie: NID_AUT=" + authKeys.first + ";NID_SES=" + authKeys.second;
+			response.body = curl_easy_strerror(result);
+			response.failed = true;
+			response.transient = is_retryable(result, 0);
+		}
 
-			slist = curl_slist_append(slist, auth.c_str());
+		if (validators)
+		{
+			curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, nullptr);
+			curl_easy_setopt(curl, CURLOPT_HEADERDATA, nullptr);
 		}
 
-		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, slist);
+		finishHandle(curl, slist);
+	}
 
-		result = curl_easy_perform(curl);
+	std::string ChzzkCore::perform(const std::string& path, const ChzzkCacheEntry* validator, ChzzkCacheEntry* received, long* status)
+	{
+		std::string host = ChzzkRateLimiter::host(path);
+		ChzzkRetryPolicy policy = getRetryPolicy();
 
-		if (result != CURLE_OK)
-			response = curl_easy_strerror(result);
+		for (int attempt = 0;; attempt++)
+		{
+			limiter.acquire(host);
 
-		curl_slist_free_all(slist);
+			ChzzkHttpResponse response;
+			ChzzkHttpTransport* custom = transport;
+
+			if (custom) custom->perform({ path, makeHeaders(validator), timeout }, response);
+			else performHandle(path, validator, received != nullptr, response);
+
+			bool retry = response.failed ? response.transient : ChzzkRetryPolicy::retryable(response.status);
+
+			if (!retry || attempt >= policy.maxRetries)
+			{
+				if (retry) failed++;
+
+				//the error string is not a response, so it should not be parsed by the caller
+				if (response.failed) throw std::exception(("Request failed: " + response.body).c_str());
+
+				if (status) *status = response.status;
+
+				if (received)
+				{
+					received->etag = std::move(response.etag);
+					received->lastModified = std::move(response.lastModified);
+				}
+
+				return response.body;
+			}
+
+			retried++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(policy.delay(attempt, response.retryAfter)));
+		}
+	}
+
+	std::string ChzzkCore::request(const std::string& path)
+	{
+		return perform(path);
+	}
+
+	std::string ChzzkCore::request(const std::string& path, ChzzkEndpoint endpoint)
+	{
+		int ttl = cache.getTTL(endpoint);
+		if (ttl <= 0 || !cache.getCapacity()) return perform(path);
+
+		std::string key;
+
+		{
+			std::lock_guard<std::mutex> guard(authMutex);
+			key = authIdentity + " " + path;
+		}
+
+		ChzzkCacheEntry cached;
+		auto lookup = cache.find(key, cached);
+
+		if (lookup == ChzzkCache::Lookup::FRESH) return cached.response;
+
+		//entries without validators can't be revalidated
+		bool revalidate = lookup == ChzzkCache::Lookup::STALE && (!cached.etag.empty() || !cached.lastModified.empty());
+
+		ChzzkCacheEntry received;
+		long status = 0;
+
+		received.response = perform(path, revalidate ? &cached : nullptr, &received, &status);
+
+		if (status == 304 && revalidate)
+		{
+			if (cache.refresh(key, ttl, cached)) return cached.response;
+
+			//evicted while revalidating
+			return perform(path);
+		}
+
+		if (status != 200) return received.response;
+
+		std::string response = received.response;
+		cache.store(key, std::move(received), ttl);
 
 		return response;
 	}
 
+	void ChzzkCore::requestBatch(const std::vector<std::string>& paths, const ChzzkBatchCallback& callback, size_t maxInFlight)
+	{
+		if (paths.empty()) return;
+		if (!maxInFlight) maxInFlight = 1;
+
+		if (transport)
+		{
+			requestBatchTransport(paths, callback, maxInFlight);
+			return;
+		}
+
+		CURLM* multi = curl_multi_init();
+
+		if (!multi)
+		{
+			throw std::exception("Core is not initialized.");
+			return;
+		}
+
+		//requests to the same host are multiplexed over http2 when possible
+		curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+		curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)maxInFlight);
+
+		struct Transfer
+		{
+			CURL* handle;
+			curl_slist* slist;
+			size_t index;
+			int attempt;
+			std::string response;
+			bool failed;	//whether the request failed without a response
+		};
+
+		//requests waiting for the rate limit or the retry delay
+		struct Delayed
+		{
+			size_t index;
+			int attempt;
+			bool reserved;	//whether the token of the rate limit is already taken
+			std::chrono::steady_clock::time_point time;
+
+			bool operator>(const Delayed& other) const
+			{
+				return time > other.time;
+			}
+		};
+
+		ChzzkRetryPolicy policy = getRetryPolicy();
+
+		std::vector<Transfer> transfers(maxInFlight < paths.size() ? maxInFlight : paths.size());
+		std::vector<Transfer*> idleTransfers;
+
+		//earliest one on top
+		std::priority_queue<Delayed, std::vector<Delayed>, std::greater<Delayed>> delayed;
+
+		for (auto& transfer : transfers)
+			idleTransfers.push_back(&transfer);
+
+		size_t next = 0;
+		size_t running = 0;
+
+		auto complete = [&](Transfer* transfer) {
+			try
+			{
+				callback(transfer->index, transfer->response, transfer->failed);
+			}
+			catch (std::exception& e)
+			{
+#if _DEBUG
+				std::cerr << "Error occured in the batch callback: " << e.what() << std::endl;
 #endif
+			}
+
+			idleTransfers.push_back(transfer);
+		};
+
+		//starts the request, or delays it until the rate limit allows
+		auto start = [&](size_t index, int attempt, bool reserved) {
+			if (!reserved)
+			{
+				int wait = limiter.reserve(ChzzkRateLimiter::host(paths[index]));
+
+				if (wait > 0)
+				{
+					delayed.push({ index, attempt, true, std::chrono::steady_clock::now() + std::chrono::milliseconds(wait) });
+					return;
+				}
+			}
+
+			Transfer* transfer = idleTransfers.back();
+			idleTransfers.pop_back();
+
+			transfer->index = index;
+			transfer->attempt = attempt;
+			transfer->response.clear();
+			transfer->failed = false;
+			transfer->handle = acquireHandle();
+
+			if (!transfer->handle)
+			{
+				transfer->response = "Core is not initialized.";
+				transfer->failed = true;
+				complete(transfer);
+				return;
+			}
+
+			transfer->slist = prepareHandle(transfer->handle, paths[transfer->index], &transfer->response);
+
+			curl_easy_setopt(transfer->handle, CURLOPT_PRIVATE, transfer);
+			curl_easy_setopt(transfer->handle, CURLOPT_PIPEWAIT, 1L);
+
+			curl_multi_add_handle(multi, transfer->handle);
+			running++;
+		};
+
+		while (next < paths.size() || running || !delayed.empty())
+		{
+			auto now = std::chrono::steady_clock::now();
+
+			//start may delay the request again, but always later than now
+			while (!delayed.empty() && delayed.top().time <= now && !idleTransfers.empty())
+			{
+				Delayed item = delayed.top();
+				delayed.pop();
+
+				start(item.index, item.attempt, item.reserved);
+			}
+
+			while (next < paths.size() && idleTransfers.size() > 0)
+				start(next++, 0, false);
+
+			int stillRunning = 0;
+			curl_multi_perform(multi, &stillRunning);
+
+			CURLMsg* msg;
+			int left;
+
+			while ((msg = curl_multi_info_read(multi, &left)))
+			{
+				if (msg->msg != CURLMSG_DONE) continue;
+
+				Transfer* transfer = nullptr;
+				curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &transfer);
+
+				CURLcode result = msg->data.result;
+				long code = 0;
+				curl_off_t retryAfter = 0;
+
+				if (result == CURLE_OK)
+				{
+					curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &code);
+					curl_easy_getinfo(transfer->handle, CURLINFO_RETRY_AFTER, &retryAfter);
+				}
+				else
+				{
+					//same error string as perform
+					transfer->response = std::string("Request failed: ") + curl_easy_strerror(result);
+					transfer->failed = true;
+				}
+
+				curl_multi_remove_handle(multi, transfer->handle);
+				curl_easy_setopt(transfer->handle, CURLOPT_PRIVATE, nullptr);
+
+				finishHandle(transfer->handle, transfer->slist);
+				running--;
+
+				bool retry = is_retryable(result, code);
+
+				if (retry && transfer->attempt < policy.maxRetries)
+				{
+					retried++;
+
+					int wait = policy.delay(transfer->attempt, retryAfter);
+					delayed.push({ transfer->index, transfer->attempt + 1, false, std::chrono::steady_clock::now() + std::chrono::milliseconds(wait) });
+
+					idleTransfers.push_back(transfer);
+					continue;
+				}
+
+				if (retry) failed++;
+
+				complete(transfer);
+			}
+
+			//wait for the sockets, or until the next delayed request
+			int timeout = 1000;
+
+			if (!delayed.empty())
+			{
+				auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(delayed.top().time - std::chrono::steady_clock::now()).count();
+				timeout = wait < 0 ? 0 : wait < timeout ? (int)wait : timeout;
+			}
+
+			if (running) curl_multi_poll(multi, nullptr, 0, timeout, nullptr);
+			else if (!delayed.empty() && timeout > 0) std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+		}
+
+		curl_multi_cleanup(multi);
+	}
+
+	void ChzzkCore::requestBatchTransport(const std::vector<std::string>& paths, const ChzzkBatchCallback& callback, size_t maxInFlight)
+	{
+		std::atomic<size_t> next(0);
+
+		struct Done
+		{
+			size_t index;
+			std::string response;
+			bool failed;
+		};
+
+		std::deque<Done> done;
+		std::mutex doneMutex;
+		std::condition_variable doneSignal;
+
+		auto work = [&]() {
+			for (size_t index; (index = next++) < paths.size();)
+			{
+				std::string response;
+				bool failed = false;
+
+				try
+				{
+					response = perform(paths[index]);
+				}
+				catch (std::exception& e)
+				{
+					response = e.what();
+					failed = true;
+				}
+
+				{
+					std::lock_guard<std::mutex> guard(doneMutex);
+					done.push_back({ index, std::move(response), failed });
+				}
+
+				doneSignal.notify_one();
+			}
+		};
+
+		std::vector<std::thread> workers;
+
+		for (size_t i = 0; i < maxInFlight && i < paths.size(); i++)
+			workers.emplace_back(work);
+
+		//callbacks are called on the calling thread, like the curl multi batch
+		for (size_t completed = 0; completed < paths.size(); completed++)
+		{
+			std::unique_lock<std::mutex> lock(doneMutex);
+			doneSignal.wait(lock, [&]() { return !done.empty(); });
+
+			auto result = std::move(done.front());
+			done.pop_front();
+
+			lock.unlock();
+
+			try
+			{
+				callback(result.index, result.response, result.failed);
+			}
+			catch (std::exception& e)
+			{
+#if _DEBUG
+				std::cerr << "Error occured in the batch callback: " << e.what() << std::endl;
+#endif
+			}
+		}
+
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	void ChzzkCore::setPoolSize(size_t poolSize)
+	{
+		std::vector<CURL*> removed;
+
+		{
+			std::lock_guard<std::mutex> guard(poolMutex);
+			this->poolSize = poolSize;
+
+			while (idleHandles.size() > poolSize)
+			{
+				removed.push_back(idleHandles.back());
+				idleHandles.pop_back();
+			}
+		}
+
+		for (auto handle : removed)
+			curl_easy_cleanup(handle);
+	}
+
+	ChzzkCorePoolStats ChzzkCore::getPoolStats()
+	{
+		ChzzkCorePoolStats stats;
+
+		stats.hits = poolHits;
+		stats.misses = poolMisses;
+
+		{
+			std::lock_guard<std::mutex> guard(poolMutex);
+			stats.idle = idleHandles.size();
+		}
+
+		return stats;
+	}
+
+	void ChzzkCore::setShareConnection(bool share)
+	{
+		std::vector<CURL*> removed;
+
+		{
+			std::lock_guard<std::mutex> guard(poolMutex);
+			shareConnection = share;
+
+			removed.swap(idleHandles);
+		}
+
+		for (auto handle : removed)
+			curl_easy_cleanup(handle);
+	}
+#endif
+
+	std::vector<std::string> ChzzkCore::makeHeaders(const ChzzkCacheEntry* validator)
+	{
+		std::vector<std::string> headers;
+
+		if (_hasAuth)
+		{
+			std::lock_guard<std::mutex> guard(authMutex);
+			headers.push_back("Cookie: NID_AUT=" + authKeys.first + ";NID_SES=" + authKeys.second);
+		}
+
+		if (validator)
+		{
+			if (!validator->etag.empty()) headers.push_back("If-None-Match: " + validator->etag);
+			if (!validator->lastModified.empty()) headers.push_back("If-Modified-Since: " + validator->lastModified);
+		}
+
+		return headers;
+	}
 
 	void ChzzkCore::setAuth(const std::string& auth, const std::string& session)
 	{
+		std::lock_guard<std::mutex> guard(authMutex);
+
 		authKeys.first = auth;
 		authKeys.second = session;
+		authIdentity = std::to_string(std::hash<std::string>()(auth + ";" + session));
 
 		_hasAuth = true;
 	}
 
 	void ChzzkCore::clearAuth()
 	{
+		std::lock_guard<std::mutex> guard(authMutex);
+
 		authKeys.first = "";
 		authKeys.second = "";
+		authIdentity.clear();
 		_hasAuth = false;
 	}
 
@@ -114,93 +689,183 @@ namespace chzzkpp
 		return timeout;
 	}
 
+	size_t ChzzkCore::getPoolSize() const
+	{
+		return poolSize;
+	}
+
+	bool ChzzkCore::isSharingConnection() const
+	{
+		return shareConnection;
+	}
+
+	void ChzzkCore::setCacheCapacity(size_t bytes)
+	{
+		cache.setCapacity(bytes);
+	}
+
+	size_t ChzzkCore::getCacheCapacity()
+	{
+		return cache.getCapacity();
+	}
+
+	void ChzzkCore::setCacheTTL(ChzzkEndpoint endpoint, int ttl)
+	{
+		cache.setTTL(endpoint, ttl);
+	}
+
+	int ChzzkCore::getCacheTTL(ChzzkEndpoint endpoint)
+	{
+		return cache.getTTL(endpoint);
+	}
+
+	void ChzzkCore::clearCache()
+	{
+		cache.clear();
+	}
+
+	ChzzkCacheStats ChzzkCore::getCacheStats()
+	{
+		return cache.getStats();
+	}
+
+	void ChzzkCore::setRateLimit(double rate, int burst)
+	{
+		limiter.setLimit(rate, burst);
+	}
+
+	void ChzzkCore::setRateLimit(const std::string& host, double rate, int burst)
+	{
+		limiter.setLimit(host, rate, burst);
+	}
+
+	void ChzzkCore::setRetryPolicy(const ChzzkRetryPolicy& policy)
+	{
+		std::lock_guard<std::mutex> guard(retryMutex);
+		retryPolicy = policy;
+	}
+
+	ChzzkRetryPolicy ChzzkCore::getRetryPolicy()
+	{
+		std::lock_guard<std::mutex> guard(retryMutex);
+		return retryPolicy;
+	}
+
+	ChzzkRateStats ChzzkCore::getRateStats()
+	{
+		ChzzkRateStats stats;
+
+		stats.throttled = limiter.getThrottled();
+		stats.throttledTime = limiter.getThrottledTime();
+		stats.retried = retried;
+		stats.failed = failed;
+
+		return stats;
+	}
+
+	void ChzzkCore::setTransport(ChzzkHttpTransport* transport)
+	{
+		this->transport = transport;
+	}
+
+	ChzzkHttpTransport* ChzzkCore::getTransport() const
+	{
+		return transport;
+	}
+
 	std::string ChzzkCore::getChannel(const std::string& channelID)
 	{
-		return request(getChannelPath(channelID));
+		return request(getChannelPath(channelID), ChzzkEndpoint::CHANNEL);
 	}
 
 	std::string ChzzkCore::getLiveStatus(const std::string& channelID)
 	{
-		return request(getLiveStatusPath(channelID));
+		return request(getLiveStatusPath(channelID), ChzzkEndpoint::LIVE_STATUS);
 	}
 
 	std::string ChzzkCore::getLiveDetail(const std::string& channelID)
 	{
-		return request(getLiveDetailPath(channelID));
+		return request(getLiveDetailPath(channelID), ChzzkEndpoint::LIVE_DETAIL);
 	}
 
 	std::string ChzzkCore::getVideo(int videoNo)
 	{
-		return request(getVideoPath(videoNo));
+		return request(getVideoPath(videoNo), ChzzkEndpoint::VIDEO);
 	}
 
 	std::string ChzzkCore::getTopViewerLives(int size)
 	{
-		return request(getTopViewerLivesPath(size));
+		return request(getTopViewerLivesPath(size), ChzzkEndpoint::TOP_VIEWER_LIVES);
 	}
 
 	std::string ChzzkCore::getTopViewerLives(const std::string& keyword, int size)
 	{
-		return request(getTopViewerLivesPath(keyword, size));
+		return request(getTopViewerLivesPath(keyword, size), ChzzkEndpoint::TOP_VIEWER_LIVES);
 	}
 
 	std::string ChzzkCore::getRecommendationChannels(bool partner)
 	{
-		return request(partner ? CHZZK_API_PATH_RECOMMENDATION_PARTNERS : CHZZK_API_PATH_RECOMMENDATION_CHANNELS);
+		return request(partner ? CHZZK_API_PATH_RECOMMENDATION_PARTNERS : CHZZK_API_PATH_RECOMMENDATION_CHANNELS, ChzzkEndpoint::RECOMMENDATION_CHANNELS);
 	}
 
 	std::string ChzzkCore::getRecommendationLives()
 	{
-		return request(CHZZK_API_PATH_RECOMMENDATION_LIVES);
+		return request(CHZZK_API_PATH_RECOMMENDATION_LIVES, ChzzkEndpoint::RECOMMENDATION_LIVES);
 	}
 
 	std::string ChzzkCore::getMissions(const std::string& channelID, bool mine, int page, int size)
 	{
-		return request(getChannelMissionsPath(channelID, mine, page, size));
+		return request(getChannelMissionsPath(channelID, mine, page, size), ChzzkEndpoint::MISSIONS);
 	}
 
 	std::string ChzzkCore::getChatDonationSetting(const std::string& channelID)
 	{
-		return request(getChatDonationSettingPath(channelID));
+		return request(getChatDonationSettingPath(channelID), ChzzkEndpoint::CHAT_DONATION_SETTING);
 	}
 
 	std::string ChzzkCore::getVideoDonationSetting(const std::string& channelID)
 	{
-		return request(getVideoDonationSettingPath(channelID));
+		return request(getVideoDonationSettingPath(channelID), ChzzkEndpoint::VIDEO_DONATION_SETTING);
 	}
 
 	std::string ChzzkCore::getMissionDonationSetting(const std::string& channelID)
 	{
-		return request(getMissionDonationSettingPath(channelID));
+		return request(getMissionDonationSettingPath(channelID), ChzzkEndpoint::MISSION_DONATION_SETTING);
 	}
 
 	std::string ChzzkCore::getUserData()
 	{
-		return request(CHZZK_API_PATH_USER);
+		return request(CHZZK_API_PATH_USER, ChzzkEndpoint::USER);
 	}
 
 	std::string ChzzkCore::getAccessToken(const std::string& chatChannelID)
 	{
-		return request(getAccessTokenPath(chatChannelID));
+		return request(getAccessTokenPath(chatChannelID), ChzzkEndpoint::ACCESS_TOKEN);
 	}
 
 	std::string ChzzkCore::searchChannel(const std::string& keyword, int offset, int size, bool withFirstChannelContent)
 	{
-		return request(getSearchChannelPath(encodeURL(keyword), offset, size, withFirstChannelContent));
+		return request(getSearchChannelPath(encodeURL(keyword), offset, size, withFirstChannelContent), ChzzkEndpoint::SEARCH);
 	}
 
 	std::string ChzzkCore::searchLive(const std::string& keyword, int offset, int size)
 	{
-		return request(getSearchLivePath(encodeURL(keyword), offset, size));
+		return request(getSearchLivePath(encodeURL(keyword), offset, size), ChzzkEndpoint::SEARCH);
 	}
 
 	std::string ChzzkCore::searchVideo(const std::string& keyword, int offset, int size)
 	{
-		return request(getSearchVideoPath(encodeURL(keyword), offset, size));
+		return request(getSearchVideoPath(encodeURL(keyword), offset, size), ChzzkEndpoint::SEARCH);
 	}
 
 	bool ChzzkCore::hasAuth() const
 	{
 		return _hasAuth;
 	}
+
+	std::string ChzzkCore::getAuthIdentity()
+	{
+		std::lock_guard<std::mutex> guard(authMutex);
+		return authIdentity;
+	}
 }
\ No newline at end of file
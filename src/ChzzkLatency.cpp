@@ -0,0 +1,177 @@
+#include <chzzkpp/ChzzkLatency.h>
+
+namespace chzzkpp
+{
+	uint64_t ChzzkHistogramSnapshot::percentile(double percent) const
+	{
+		if (!count) return 0;
+		if (percent >= 100) return max;
+
+		uint64_t target = (uint64_t)(percent / 100 * count + 0.5);
+		if (target < 1) target = 1;
+
+		uint64_t seen = 0;
+
+		for (size_t i = 0; i < buckets.size(); i++)
+		{
+			seen += buckets[i];
+
+			if (seen >= target)
+			{
+				uint64_t bound = ChzzkHistogram::bucketUpperBound(i);
+				return bound < max ? bound : max;
+			}
+		}
+
+		return max;
+	}
+
+	ChzzkHistogram::ChzzkHistogram()
+	{
+		reset();
+	}
+
+	size_t ChzzkHistogram::bucketIndex(uint64_t micros)
+	{
+		static const uint64_t MAX_VALUE = ((uint64_t)1 << MAX_VALUE_BITS) - 1;
+
+		if (micros > MAX_VALUE) micros = MAX_VALUE;
+		if (micros < 2 * SUB_BUCKET_COUNT) return (size_t)micros;
+
+		int msb = SUB_BUCKET_BITS + 1;
+		while (micros >> (msb + 1)) msb++;
+
+		//the top SUB_BUCKET_BITS + 1 bits decide the bucket
+		int shift = msb - SUB_BUCKET_BITS;
+		return 2 * SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_COUNT + (size_t)((micros >> shift) - SUB_BUCKET_COUNT);
+	}
+
+	uint64_t ChzzkHistogram::bucketUpperBound(size_t index)
+	{
+		if (index < 2 * SUB_BUCKET_COUNT) return index;
+
+		int shift = (int)((index - 2 * SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT) + 1;
+		uint64_t sub = (index - 2 * SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+
+		return ((sub + 1) << shift) - 1;
+	}
+
+	void ChzzkHistogram::record(uint64_t micros)
+	{
+		buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+		sum.fetch_add(micros, std::memory_order_relaxed);
+
+		uint64_t current = min.load(std::memory_order_relaxed);
+		while (micros < current && !min.compare_exchange_weak(current, micros, std::memory_order_relaxed));
+
+		current = max.load(std::memory_order_relaxed);
+		while (micros > current && !max.compare_exchange_weak(current, micros, std::memory_order_relaxed));
+	}
+
+	ChzzkHistogramSnapshot ChzzkHistogram::snapshot() const
+	{
+		ChzzkHistogramSnapshot snapshot;
+		snapshot.buckets.resize(BUCKET_COUNT);
+
+		//the count is summed from the copied buckets, so percentiles are consistent even while recording
+		for (size_t i = 0; i < BUCKET_COUNT; i++)
+		{
+			snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+			snapshot.count += snapshot.buckets[i];
+		}
+
+		if (!snapshot.count) return snapshot;
+
+		snapshot.min = min.load(std::memory_order_relaxed);
+		snapshot.max = max.load(std::memory_order_relaxed);
+		snapshot.mean = (double)sum.load(std::memory_order_relaxed) / snapshot.count;
+
+		return snapshot;
+	}
+
+	void ChzzkHistogram::reset()
+	{
+		for (auto& bucket : buckets)
+			bucket.store(0, std::memory_order_relaxed);
+
+		sum = 0;
+		min = UINT64_MAX;
+		max = 0;
+	}
+
+	ChzzkLatencyTracker::ChzzkLatencyTracker()
+	{
+		for (auto& histogram : handlers)
+			histogram = nullptr;
+	}
+
+	ChzzkLatencyTracker::~ChzzkLatencyTracker()
+	{
+		for (auto& histogram : handlers)
+			delete histogram.load();
+	}
+
+	void ChzzkLatencyTracker::recordServer(unsigned long long messageTime, unsigned long long receiveTime)
+	{
+		if (!messageTime) return;
+
+		//clock of the server could be ahead
+		server.record(receiveTime > messageTime ? (receiveTime - messageTime) * 1000 : 0);
+	}
+
+	void ChzzkLatencyTracker::recordHandlers(ChzzkChatEvent type, Clock::time_point received, Clock::time_point start, Clock::time_point end)
+	{
+		auto micros = [](Clock::duration duration) {
+			auto count = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+			return count < 0 ? (uint64_t)0 : (uint64_t)count;
+		};
+
+		dispatch.record(micros(start - received));
+		total.record(micros(end - received));
+
+		size_t index = (size_t)type;
+		if (index >= MAX_EVENTS) return;
+
+		ChzzkHistogram* histogram = handlers[index].load(std::memory_order_acquire);
+
+		if (!histogram)
+		{
+			ChzzkHistogram* created = new ChzzkHistogram();
+
+			if (handlers[index].compare_exchange_strong(histogram, created, std::memory_order_acq_rel)) histogram = created;
+			else delete created; //made by another thread
+		}
+
+		histogram->record(micros(end - start));
+	}
+
+	ChzzkLatencyStats ChzzkLatencyTracker::getStats() const
+	{
+		ChzzkLatencyStats stats;
+
+		stats.server = server.snapshot();
+		stats.dispatch = dispatch.snapshot();
+		stats.total = total.snapshot();
+
+		for (size_t i = 0; i < MAX_EVENTS; i++)
+		{
+			ChzzkHistogram* histogram = handlers[i].load(std::memory_order_acquire);
+			if (histogram) stats.handlers.emplace((ChzzkChatEvent)i, histogram->snapshot());
+		}
+
+		return stats;
+	}
+
+	void ChzzkLatencyTracker::reset()
+	{
+		server.reset();
+		dispatch.reset();
+		total.reset();
+
+		for (auto& histogram : handlers)
+		{
+			ChzzkHistogram* current = histogram.load(std::memory_order_acquire);
+			if (current) current->reset();
+		}
+	}
+}
@@ -0,0 +1,320 @@
+#include <chzzkpp/ChzzkLiveWatcher.h>
+
+#include <cstdlib>
+
+#if _DEBUG
+#include <iostream>
+#endif
+
+namespace chzzkpp
+{
+	static bool is_open(const ChzzkLiveStatus& status)
+	{
+		return status.status == "OPEN";
+	}
+
+	ChzzkLiveWatcher::ChzzkLiveWatcher(ChzzkClient* client, ChzzkLiveWatcherOptions options)
+		: client(client), options(options), nextHandlerID(1), running(true), polls(0), failures(0), events(0), handlerFailures(0)
+	{
+		thread = std::thread(&ChzzkLiveWatcher::run, this);
+	}
+
+	ChzzkLiveWatcher::~ChzzkLiveWatcher()
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			running = false;
+		}
+
+		wakeup.notify_all();
+
+		if (thread.joinable()) thread.join();
+	}
+
+	void ChzzkLiveWatcher::run()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (running)
+		{
+			auto now = Clock::now();
+			auto window = now + std::chrono::milliseconds(options.batchWindow);
+			auto next = now + std::chrono::milliseconds(WAIT_TIME);
+
+			std::vector<std::string> batch;
+
+			for (auto& entry : entries)
+			{
+				if (entry.polling) continue;
+
+				if (entry.deadline <= window)
+				{
+					entry.polling = true;
+					batch.push_back(entry.channelID);
+				}
+				else if (entry.deadline < next) next = entry.deadline;
+			}
+
+			if (batch.empty())
+			{
+				wakeup.wait_until(lock, next);
+				continue;
+			}
+
+			lock.unlock();
+
+			try
+			{
+				client->getLiveStatusBatch(batch, [&](size_t i, std::future<ChzzkLiveStatus> future) {
+					try
+					{
+						//failed requests and invalid responses throw, so they are never taken as the end of the live
+						update(batch[i], future.get());
+					}
+					catch (std::exception& e)
+					{
+#if _DEBUG
+						std::cerr << "Error occured while polling live status of " << batch[i] << ": " << e.what() << std::endl;
+#endif
+						fail(batch[i]);
+					}
+				}, options.maxInFlight);
+			}
+			catch (std::exception& e)
+			{
+#if _DEBUG
+				std::cerr << "Error occured while polling live status: " << e.what() << std::endl;
+#endif
+				for (auto& channelID : batch)
+					fail(channelID);
+			}
+
+			lock.lock();
+
+			//channels which didn't get the result are retried as failed
+			for (auto& channelID : batch)
+			{
+				auto it = index.find(channelID);
+				if (it == index.end()) continue;
+
+				Entry& entry = entries[it->second];
+
+				if (entry.polling)
+				{
+					entry.polling = false;
+					entry.deadline = Clock::now() + std::chrono::milliseconds(entry.schedule.fail());
+				}
+			}
+		}
+	}
+
+	void ChzzkLiveWatcher::update(const std::string& channelID, const ChzzkLiveStatus& status)
+	{
+		polls++;
+
+		ChzzkLiveStatus previous;
+		bool initialized;
+		int reportedViewers;
+
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+
+			auto it = index.find(channelID);
+			if (it == index.end()) return; //removed while polling
+
+			Entry& entry = entries[it->second];
+
+			entry.polling = false;
+			entry.deadline = Clock::now() + std::chrono::milliseconds(entry.schedule.next(status.livePollingStatus));
+
+			previous = std::move(entry.status);
+			entry.status = status;
+
+			initialized = entry.initialized;
+			entry.initialized = true;
+
+			reportedViewers = entry.reportedViewers;
+
+			bool viewersChanged = options.viewerDelta > 0 && std::abs(status.concurrentUserCount - reportedViewers) >= options.viewerDelta;
+			if (!initialized || viewersChanged || (is_open(status) && !is_open(previous))) entry.reportedViewers = status.concurrentUserCount;
+		}
+
+		//the first status is the baseline
+		if (!initialized) return;
+
+		if (is_open(status) && !is_open(previous)) call(ChzzkLiveEvent::OPEN, channelID, previous, status);
+		else if (!is_open(status) && is_open(previous)) call(ChzzkLiveEvent::CLOSE, channelID, previous, status);
+		else if (is_open(status) && options.viewerDelta > 0 && std::abs(status.concurrentUserCount - reportedViewers) >= options.viewerDelta)
+			call(ChzzkLiveEvent::VIEWERS, channelID, previous, status);
+
+		if (status.title != previous.title) call(ChzzkLiveEvent::TITLE, channelID, previous, status);
+
+		if (status.categoryType != previous.categoryType || status.liveCategory != previous.liveCategory)
+			call(ChzzkLiveEvent::CATEGORY, channelID, previous, status);
+
+		if (!status.chatChannelID.empty() && status.chatChannelID != previous.chatChannelID)
+			call(ChzzkLiveEvent::CHAT_CHANNEL, channelID, previous, status);
+	}
+
+	void ChzzkLiveWatcher::fail(const std::string& channelID)
+	{
+		failures++;
+
+		std::lock_guard<std::mutex> guard(mutex);
+
+		auto it = index.find(channelID);
+		if (it == index.end()) return;
+
+		Entry& entry = entries[it->second];
+
+		entry.polling = false;
+		entry.deadline = Clock::now() + std::chrono::milliseconds(entry.schedule.fail());
+	}
+
+	void ChzzkLiveWatcher::call(ChzzkLiveEvent type, const std::string& channelID, const ChzzkLiveStatus& previous, const ChzzkLiveStatus& current)
+	{
+		events++;
+
+		std::shared_lock<std::shared_mutex> lock(handlerMutex);
+
+		auto it = handlers.find(type);
+		if (it == handlers.end()) return;
+
+		ChzzkLiveChange change = { type, channelID, previous, current };
+
+		for (auto& p : it->second)
+		{
+			try
+			{
+				p.second(change);
+			}
+			catch (std::exception& e)
+			{
+				handlerFailures++;
+#if _DEBUG
+				std::cerr << "Error occured handling the live change of " << channelID << ": " << e.what() << std::endl;
+#endif
+			}
+		}
+	}
+
+	void ChzzkLiveWatcher::addChannel(const std::string& channelID)
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+
+			if (index.find(channelID) != index.end()) return;
+
+			Entry entry;
+			entry.channelID = channelID;
+			entry.status = ChzzkLiveStatus();
+			entry.initialized = false;
+			entry.polling = false;
+			entry.reportedViewers = 0;
+			entry.schedule = ChzzkPollSchedule(options.pollTime);
+			entry.deadline = Clock::now();
+
+			index.emplace(channelID, entries.size());
+			entries.push_back(std::move(entry));
+		}
+
+		wakeup.notify_one();
+	}
+
+	void ChzzkLiveWatcher::removeChannel(const std::string& channelID)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		auto it = index.find(channelID);
+		if (it == index.end()) return;
+
+		size_t position = it->second;
+		index.erase(it);
+
+		if (position != entries.size() - 1)
+		{
+			entries[position] = std::move(entries.back());
+			index[entries[position].channelID] = position;
+		}
+
+		entries.pop_back();
+	}
+
+	bool ChzzkLiveWatcher::hasChannel(const std::string& channelID)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return index.find(channelID) != index.end();
+	}
+
+	std::vector<std::string> ChzzkLiveWatcher::getChannels()
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		std::vector<std::string> channels;
+		channels.reserve(entries.size());
+
+		for (auto& entry : entries)
+			channels.push_back(entry.channelID);
+
+		return channels;
+	}
+
+	size_t ChzzkLiveWatcher::size()
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return entries.size();
+	}
+
+	bool ChzzkLiveWatcher::getStatus(const std::string& channelID, ChzzkLiveStatus& status)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		auto it = index.find(channelID);
+		if (it == index.end() || !entries[it->second].initialized) return false;
+
+		status = entries[it->second].status;
+		return true;
+	}
+
+	size_t ChzzkLiveWatcher::addHandler(ChzzkLiveEvent type, const std::function<void(const ChzzkLiveChange&)>& func)
+	{
+		std::lock_guard<std::shared_mutex> guard(handlerMutex);
+
+		size_t id = nextHandlerID++;
+
+		handlers[type].emplace(id, func);
+		return id;
+	}
+
+	void ChzzkLiveWatcher::removeHandler(ChzzkLiveEvent type, size_t id)
+	{
+		std::lock_guard<std::shared_mutex> guard(handlerMutex);
+		handlers[type].erase(id);
+	}
+
+	void ChzzkLiveWatcher::removeHandlers(ChzzkLiveEvent type)
+	{
+		std::lock_guard<std::shared_mutex> guard(handlerMutex);
+		handlers[type].clear();
+	}
+
+	uint64_t ChzzkLiveWatcher::getPollCount() const
+	{
+		return polls;
+	}
+
+	uint64_t ChzzkLiveWatcher::getFailureCount() const
+	{
+		return failures;
+	}
+
+	uint64_t ChzzkLiveWatcher::getEventCount() const
+	{
+		return events;
+	}
+
+	uint64_t ChzzkLiveWatcher::getHandlerFailureCount() const
+	{
+		return handlerFailures;
+	}
+}
@@ -0,0 +1,364 @@
+#include <chzzkpp/ChzzkMockServer.h>
+#include <chzzkpp/ChzzkChat.h>
+
+#include <fstream>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+namespace chzzkpp
+{
+	static const char NOT_FOUND_RESPONSE[] = "{\"code\":404,\"message\":\"Not Found\",\"content\":null}";
+
+	//max frames replayed between the checks of the replies and the rate
+	static const size_t REPLAY_CHUNK_SIZE = 64;
+
+	//socket replaying the frames on its own thread
+	//the state is shared with the thread, so the socket can be destroyed in its callbacks
+	class ChzzkMockServer::Socket : public ChzzkWebSocket
+	{
+		using Clock = std::chrono::steady_clock;
+
+		struct State
+		{
+			ChzzkMockServer* server;
+			ChzzkSocketMessageCallback onMessage;
+
+			std::mutex mutex;
+			std::condition_variable wakeup;
+			std::atomic<bool> closed;
+
+			std::deque<std::string> replies;	//replies to the chat, sent before the replayed frames
+
+			//set when the chat connects
+			bool replaying;
+			std::shared_ptr<const std::vector<std::string>> frames;
+			int rate;
+			int loops;
+			Clock::time_point start;
+		};
+
+		std::shared_ptr<State> state;
+		std::thread thread;
+
+		static void run(std::shared_ptr<State> state);
+
+	public:
+		Socket(ChzzkMockServer* server, const ChzzkSocketMessageCallback& onMessage);
+		~Socket() override;
+
+		void send(const std::string& message) override;
+		void close() override;
+	};
+
+	ChzzkMockServer::Socket::Socket(ChzzkMockServer* server, const ChzzkSocketMessageCallback& onMessage) : state(std::make_shared<State>())
+	{
+		state->server = server;
+		state->onMessage = onMessage;
+		state->closed = false;
+		state->replaying = false;
+		state->rate = 0;
+		state->loops = 1;
+
+		thread = std::thread(&Socket::run, state);
+	}
+
+	ChzzkMockServer::Socket::~Socket()
+	{
+		close();
+	}
+
+	void ChzzkMockServer::Socket::run(std::shared_ptr<State> state)
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+
+		size_t position = 0;
+		int loop = 0;
+		uint64_t replayed = 0;
+
+		while (!state->closed)
+		{
+			if (!state->replies.empty())
+			{
+				std::string reply = std::move(state->replies.front());
+				state->replies.pop_front();
+
+				lock.unlock();
+
+				state->onMessage(reply);
+				state->server->sentFrames++;
+
+				lock.lock();
+				continue;
+			}
+
+			auto frames = state->frames;
+
+			if (!state->replaying || !frames || frames->empty() || (state->loops && loop >= state->loops))
+			{
+				state->wakeup.wait(lock);
+				continue;
+			}
+
+			size_t due = REPLAY_CHUNK_SIZE;
+
+			if (state->rate > 0)
+			{
+				//frames are paced from the start of the replay, so slow handlers don't lower the rate
+				double elapsed = std::chrono::duration<double>(Clock::now() - state->start).count();
+				uint64_t target = (uint64_t)(elapsed * state->rate) + 1;
+
+				if (target <= replayed)
+				{
+					auto next = state->start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((double)replayed / state->rate));
+					state->wakeup.wait_until(lock, next);
+					continue;
+				}
+
+				if (target - replayed < due) due = (size_t)(target - replayed);
+			}
+
+			int loops = state->loops;
+			lock.unlock();
+
+			size_t sent = 0;
+
+			while (sent < due && !state->closed)
+			{
+				state->onMessage((*frames)[position]);
+				sent++;
+
+				if (++position == frames->size())
+				{
+					position = 0;
+					if (loops && ++loop >= loops) break;
+				}
+			}
+
+			replayed += sent;
+			state->server->sentFrames += sent;
+
+			lock.lock();
+		}
+	}
+
+	void ChzzkMockServer::Socket::send(const std::string& message)
+	{
+		ChzzkMockServer* server = state->server;
+		server->receivedFrames++;
+
+		nlohmann::json json = nlohmann::json::parse(message, nullptr, false);
+		if (json.is_discarded() || !json.contains("cmd") || !json["cmd"].is_number_integer()) return;
+
+		ChatCommand cmd = json["cmd"];
+		nlohmann::json reply;
+
+		switch (cmd)
+		{
+		case ChatCommand::CONNECT:
+			reply = {
+				{"bdy", { {"sid", "mock-" + std::to_string(server->connections.load())}, {"uuid", ""} }},
+				{"cmd", ChatCommand::CONNECTED},
+				{"retCode", 0},
+				{"retMsg", "SUCCESS"},
+				{"tid", json.value("tid", 1)},
+				{"cid", json.value("cid", "")},
+				{"svcid", "game"},
+				{"ver", "2"}
+			};
+			break;
+
+		case ChatCommand::PING:
+			reply = {
+				{"cmd", ChatCommand::PONG},
+				{"ver", "2"}
+			};
+			break;
+
+		case ChatCommand::REQUEST_RECENT_CHAT:
+			reply = {
+				{"bdy", { {"messageList", nlohmann::json::array()}, {"userCount", 0} }},
+				{"cmd", ChatCommand::RECENT_CHAT},
+				{"ver", "2"}
+			};
+			break;
+
+		default:
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(state->mutex);
+
+			state->replies.push_back(reply.dump());
+
+			//frames are replayed after CONNECTED, like the chat server does
+			if (cmd == ChatCommand::CONNECT && !state->replaying)
+			{
+				{
+					std::lock_guard<std::mutex> frameGuard(server->frameMutex);
+					state->frames = server->frames;
+				}
+
+				state->rate = server->replayRate;
+				state->loops = server->replayLoops;
+				state->start = Clock::now();
+				state->replaying = true;
+			}
+		}
+
+		state->wakeup.notify_one();
+	}
+
+	void ChzzkMockServer::Socket::close()
+	{
+		{
+			std::lock_guard<std::mutex> guard(state->mutex);
+			state->closed = true;
+		}
+
+		state->wakeup.notify_one();
+
+		if (!thread.joinable()) return;
+
+		//closed in the callback. the thread stops after the callback returns
+		if (thread.get_id() == std::this_thread::get_id()) thread.detach();
+		else thread.join();
+	}
+
+	ChzzkMockServer::ChzzkMockServer() : frames(std::make_shared<std::vector<std::string>>()), replayRate(0), replayLoops(1), requests(0), sentFrames(0), receivedFrames(0), connections(0)
+	{
+	}
+
+	void ChzzkMockServer::setResponse(const std::string& url, const std::string& body, long status)
+	{
+		std::lock_guard<std::shared_mutex> guard(responseMutex);
+		responses[url] = { status, body };
+	}
+
+	void ChzzkMockServer::removeResponse(const std::string& url)
+	{
+		std::lock_guard<std::shared_mutex> guard(responseMutex);
+		responses.erase(url);
+	}
+
+	void ChzzkMockServer::clearResponses()
+	{
+		std::lock_guard<std::shared_mutex> guard(responseMutex);
+		responses.clear();
+	}
+
+	void ChzzkMockServer::addFrame(const std::string& frame)
+	{
+		std::lock_guard<std::mutex> guard(frameMutex);
+
+		//connections keep the old snapshot
+		auto updated = std::make_shared<std::vector<std::string>>(*frames);
+		updated->push_back(frame);
+
+		frames = std::move(updated);
+	}
+
+	size_t ChzzkMockServer::loadFrames(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) throw std::exception(("Cannot open the frame file: " + path).c_str());
+
+		std::vector<std::string> loaded;
+		std::string line;
+
+		while (std::getline(file, line))
+		{
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			if (!line.empty()) loaded.push_back(std::move(line));
+		}
+
+		std::lock_guard<std::mutex> guard(frameMutex);
+
+		auto updated = std::make_shared<std::vector<std::string>>(*frames);
+		updated->insert(updated->end(), std::make_move_iterator(loaded.begin()), std::make_move_iterator(loaded.end()));
+
+		frames = std::move(updated);
+
+		return loaded.size();
+	}
+
+	void ChzzkMockServer::clearFrames()
+	{
+		std::lock_guard<std::mutex> guard(frameMutex);
+		frames = std::make_shared<std::vector<std::string>>();
+	}
+
+	void ChzzkMockServer::setReplayRate(int rate)
+	{
+		replayRate = rate < 0 ? 0 : rate;
+	}
+
+	int ChzzkMockServer::getReplayRate() const
+	{
+		return replayRate;
+	}
+
+	void ChzzkMockServer::setReplayLoops(int loops)
+	{
+		replayLoops = loops < 0 ? 0 : loops;
+	}
+
+	int ChzzkMockServer::getReplayLoops() const
+	{
+		return replayLoops;
+	}
+
+	void ChzzkMockServer::perform(const ChzzkHttpRequest& request, ChzzkHttpResponse& response)
+	{
+		requests++;
+
+		std::shared_lock<std::shared_mutex> lock(responseMutex);
+
+		auto it = responses.find(request.url);
+
+		if (it == responses.end())
+		{
+			size_t query = request.url.find('?');
+			if (query != std::string::npos) it = responses.find(request.url.substr(0, query));
+		}
+
+		if (it == responses.end())
+		{
+			response.status = 404;
+			response.body = NOT_FOUND_RESPONSE;
+			return;
+		}
+
+		response.status = it->second.status;
+		response.body = it->second.body;
+	}
+
+	//every url connects, and the socket never fails. it just stops after the replay ends
+	std::unique_ptr<ChzzkWebSocket> ChzzkMockServer::open(const std::string&, int, const ChzzkSocketMessageCallback& onMessage, const ChzzkSocketErrorCallback&)
+	{
+		connections++;
+		return std::make_unique<Socket>(this, onMessage);
+	}
+
+	uint64_t ChzzkMockServer::getRequestCount() const
+	{
+		return requests;
+	}
+
+	uint64_t ChzzkMockServer::getSentFrameCount() const
+	{
+		return sentFrames;
+	}
+
+	uint64_t ChzzkMockServer::getReceivedFrameCount() const
+	{
+		return receivedFrames;
+	}
+
+	uint64_t ChzzkMockServer::getConnectionCount() const
+	{
+		return connections;
+	}
+}
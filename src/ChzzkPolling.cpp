@@ -0,0 +1,73 @@
+#include <chzzkpp/ChzzkPolling.h>
+
+#include <random>
+
+namespace chzzkpp
+{
+	static std::mt19937& random_engine()
+	{
+		thread_local std::mt19937 engine(std::random_device{}());
+		return engine;
+	}
+
+	ChzzkPollSchedule::ChzzkPollSchedule(int defaultInterval, int minInterval, int maxInterval)
+		: defaultInterval(defaultInterval), minInterval(minInterval), maxInterval(maxInterval < minInterval ? minInterval : maxInterval), period(0), backoff(0)
+	{
+		reset();
+	}
+
+	int ChzzkPollSchedule::clamp(long long interval) const
+	{
+		if (interval < minInterval) return minInterval;
+		if (interval > maxInterval) return maxInterval;
+
+		return (int)interval;
+	}
+
+	int ChzzkPollSchedule::first() const
+	{
+		std::uniform_int_distribution<int> distribution(minInterval, clamp(defaultInterval));
+		return distribution(random_engine());
+	}
+
+	int ChzzkPollSchedule::next(const ChzzkLivePollingStatus& status)
+	{
+		period = clamp(status.callPeriodMilliSecond > 0 ? status.callPeriodMilliSecond : defaultInterval);
+
+		//throttling is positive while the server asks clients to slow down
+		if (status.trafficThrottling > 0)
+		{
+			if (backoff < 16) backoff++;
+		}
+		else backoff = 0;
+
+		return jitter(clamp((long long)period << backoff));
+	}
+
+	int ChzzkPollSchedule::fail()
+	{
+		if (backoff < 16) backoff++;
+
+		return jitter(clamp((long long)period << backoff));
+	}
+
+	void ChzzkPollSchedule::reset()
+	{
+		period = clamp(defaultInterval);
+		backoff = 0;
+	}
+
+	int ChzzkPollSchedule::getBackoff() const
+	{
+		return backoff;
+	}
+
+	int ChzzkPollSchedule::jitter(int interval)
+	{
+		int range = (int)((long long)interval * JITTER_PERCENT / 100);
+		if (range <= 0) return interval;
+
+		std::uniform_int_distribution<int> distribution(-range, range);
+		return interval + distribution(random_engine());
+	}
+}
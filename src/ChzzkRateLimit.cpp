@@ -0,0 +1,127 @@
+#include <chzzkpp/ChzzkRateLimit.h>
+
+#include <random>
+#include <thread>
+#include <cmath>
+
+namespace chzzkpp
+{
+	int ChzzkRetryPolicy::delay(int attempt, long long retryAfter) const
+	{
+		long long backoff = baseDelay;
+
+		for (int i = 0; i < attempt && backoff < maxDelay; i++)
+			backoff <<= 1;
+
+		if (backoff > maxDelay) backoff = maxDelay;
+		if (backoff < 0) backoff = 0;
+
+		//full jitter, so clients failed at once don't retry at once
+		thread_local std::mt19937 engine(std::random_device{}());
+		std::uniform_int_distribution<long long> distribution(0, backoff);
+
+		long long wait = distribution(engine);
+
+		if (retryAfter > 0)
+		{
+			long long after = retryAfter * 1000;
+			if (after > maxDelay) after = maxDelay;
+			if (wait < after) wait = after;
+		}
+
+		return (int)wait;
+	}
+
+	bool ChzzkRetryPolicy::retryable(long status)
+	{
+		return status == 429 || status == 500 || status == 502 || status == 503 || status == 504;
+	}
+
+	ChzzkRateLimiter::ChzzkRateLimiter() : defaultLimit({ 0, 0 }), throttled(0), throttledTime(0)
+	{
+	}
+
+	ChzzkRateLimiter::Limit ChzzkRateLimiter::findLimit(const std::string& host) const
+	{
+		auto it = limits.find(host);
+		return it != limits.end() ? it->second : defaultLimit;
+	}
+
+	void ChzzkRateLimiter::setLimit(double rate, int burst)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		defaultLimit = { rate, burst < 1 ? 1 : burst };
+
+		for (auto& p : buckets)
+			p.second.limit = findLimit(p.first);
+	}
+
+	void ChzzkRateLimiter::setLimit(const std::string& host, double rate, int burst)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		limits[host] = { rate, burst < 1 ? 1 : burst };
+
+		auto it = buckets.find(host);
+		if (it != buckets.end()) it->second.limit = limits[host];
+	}
+
+	int ChzzkRateLimiter::reserve(const std::string& host)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		auto now = Clock::now();
+		auto it = buckets.find(host);
+
+		if (it == buckets.end())
+		{
+			Limit limit = findLimit(host);
+			it = buckets.emplace(host, Bucket{ limit, (double)limit.burst, now }).first;
+		}
+
+		Bucket& bucket = it->second;
+		if (bucket.limit.rate <= 0) return 0;
+
+		double elapsed = std::chrono::duration<double>(now - bucket.last).count();
+		bucket.last = now;
+
+		bucket.tokens += elapsed * bucket.limit.rate;
+		if (bucket.tokens > bucket.limit.burst) bucket.tokens = bucket.limit.burst;
+
+		bucket.tokens -= 1;
+		if (bucket.tokens >= 0) return 0;
+
+		int wait = (int)std::ceil(-bucket.tokens / bucket.limit.rate * 1000);
+
+		throttled++;
+		throttledTime += wait;
+
+		return wait;
+	}
+
+	void ChzzkRateLimiter::acquire(const std::string& host)
+	{
+		int wait = reserve(host);
+		if (wait > 0) std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+	}
+
+	uint64_t ChzzkRateLimiter::getThrottled() const
+	{
+		return throttled;
+	}
+
+	uint64_t ChzzkRateLimiter::getThrottledTime() const
+	{
+		return throttledTime;
+	}
+
+	std::string ChzzkRateLimiter::host(const std::string& url)
+	{
+		size_t begin = url.find("://");
+		begin = begin == std::string::npos ? 0 : begin + 3;
+
+		size_t end = url.find_first_of("/?#", begin);
+		return url.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+	}
+}
@@ -0,0 +1,716 @@
+#include <chzzkpp/ChzzkSax.h>
+#include <chzzkpp/ChzzkUtils.h>
+#include <nlohmann/json.hpp>
+
+#if _USE_SIMDJSON
+#include <simdjson.h>
+#endif
+
+namespace chzzkpp
+{
+	//sax handler filling the structs with the field tables
+	class ChzzkSaxDecoder : public nlohmann::json::json_sax_t
+	{
+		enum class FrameType
+		{
+			OBJECT,			//json object of a struct
+			OBJECT_LIST,	//json array of structs
+			STRING_LIST,	//json array of strings
+		};
+
+		struct Frame
+		{
+			FrameType type;
+			void* object;				//struct for OBJECT and OBJECT_LIST, std::vector for STRING_LIST
+			const ChzzkField* field;	//list field for OBJECT_LIST
+			const ChzzkFieldTable* table;
+		};
+
+		struct Match
+		{
+			const ChzzkField* field;
+			void* object;
+		};
+
+		std::vector<Frame> stack;
+		std::vector<Match> matches;	//fields of the last key
+
+		const ChzzkFieldTable& rootTable;
+		void* root;
+
+		size_t skipDepth;	//depth of the json value being skipped. 0 if not skipping
+
+		//json value being captured for RAW fields
+		std::string* rawDest;
+		nlohmann::json raw;
+		std::vector<nlohmann::json*> rawStack;
+		std::string rawKey;
+
+		void pushObject(void* object, const ChzzkFieldTable* table)
+		{
+			stack.push_back({ FrameType::OBJECT, object, nullptr, table });
+		}
+
+		bool capturing() const
+		{
+			return rawDest != nullptr;
+		}
+
+		//adds the value to the captured json. returns the added value
+		nlohmann::json* capture(nlohmann::json&& value)
+		{
+			if (rawStack.empty())
+			{
+				raw = std::move(value);
+				return &raw;
+			}
+
+			nlohmann::json* parent = rawStack.back();
+
+			if (parent->is_array())
+			{
+				parent->push_back(std::move(value));
+				return &parent->back();
+			}
+
+			auto& element = (*parent)[rawKey];
+			element = std::move(value);
+
+			return &element;
+		}
+
+		void finishCapture()
+		{
+			if (rawStack.empty())
+			{
+				*rawDest = raw.dump();
+				rawDest = nullptr;
+				raw = nullptr;
+			}
+		}
+
+		//the raw field of the last key, if any
+		std::string* rawMatch()
+		{
+			for (auto& match : matches)
+				if (match.field->type == ChzzkFieldType::RAW) return static_cast<std::string*>(match.field->member(match.object));
+
+			return nullptr;
+		}
+
+		//set is called with each field of the last key. make creates the json value, only when it is captured or dumped
+		template <typename F, typename M>
+		bool scalar(F&& set, M&& make)
+		{
+			if (skipDepth) return true;
+
+			if (capturing())
+			{
+				capture(make());
+				finishCapture();
+				return true;
+			}
+
+			if (stack.empty()) return true;
+
+			Frame& frame = stack.back();
+
+			if (frame.type == FrameType::STRING_LIST)
+			{
+				//same as json_safe_get<std::string> of non-string elements
+				static_cast<std::vector<std::string>*>(frame.object)->emplace_back();
+			}
+			else if (frame.type == FrameType::OBJECT)
+			{
+				for (auto& match : matches)
+				{
+					if (match.field->type == ChzzkFieldType::RAW) *static_cast<std::string*>(match.field->member(match.object)) = make().dump();
+					else set(*match.field, match.field->member(match.object));
+				}
+
+				matches.clear();
+			}
+
+			return true;
+		}
+
+		//resets the field to its default value for null, same as parse_field
+		static void reset(const ChzzkField& field, void* member)
+		{
+			switch (field.type)
+			{
+			case ChzzkFieldType::BOOL: *static_cast<bool*>(member) = false; break;
+			case ChzzkFieldType::INT: *static_cast<int*>(member) = 0; break;
+			case ChzzkFieldType::STRING: static_cast<std::string*>(member)->clear(); break;
+			case ChzzkFieldType::STRING_LIST: static_cast<std::vector<std::string>*>(member)->clear(); break;
+			case ChzzkFieldType::RAW: *static_cast<std::string*>(member) = "null"; break;
+
+			//structs are left as they are
+			case ChzzkFieldType::OBJECT:
+			case ChzzkFieldType::NESTED:
+			case ChzzkFieldType::INLINE:
+			case ChzzkFieldType::OBJECT_LIST:
+				break;
+			}
+		}
+
+		template <typename V>
+		static void setNumber(const ChzzkField& field, void* member, V value)
+		{
+			if (field.type == ChzzkFieldType::INT) *static_cast<int*>(member) = (int)value;
+			else if (field.type == ChzzkFieldType::BOOL) *static_cast<bool*>(member) = value != 0;
+		}
+
+	public:
+		ChzzkSaxDecoder(const ChzzkFieldTable& table, void* object) : rootTable(table), root(object), skipDepth(0), rawDest(nullptr)
+		{
+		}
+
+		bool null() override
+		{
+			return scalar([](const ChzzkField& field, void* member) { reset(field, member); }, []() { return nlohmann::json(); });
+		}
+
+		bool boolean(bool value) override
+		{
+			return scalar([&](const ChzzkField& field, void* member) {
+				if (field.type == ChzzkFieldType::BOOL) *static_cast<bool*>(member) = value;
+				else if (field.type == ChzzkFieldType::INT) *static_cast<int*>(member) = value;
+			}, [&]() { return nlohmann::json(value); });
+		}
+
+		bool number_integer(number_integer_t value) override
+		{
+			return scalar([&](const ChzzkField& field, void* member) { setNumber(field, member, value); }, [&]() { return nlohmann::json(value); });
+		}
+
+		bool number_unsigned(number_unsigned_t value) override
+		{
+			return scalar([&](const ChzzkField& field, void* member) { setNumber(field, member, value); }, [&]() { return nlohmann::json(value); });
+		}
+
+		bool number_float(number_float_t value, const string_t&) override
+		{
+			return scalar([&](const ChzzkField& field, void* member) { setNumber(field, member, value); }, [&]() { return nlohmann::json(value); });
+		}
+
+		bool string(string_t& value) override
+		{
+			if (!skipDepth && !capturing() && !stack.empty())
+			{
+				Frame& frame = stack.back();
+
+				if (frame.type == FrameType::STRING_LIST)
+				{
+					static_cast<std::vector<std::string>*>(frame.object)->push_back(std::move(value));
+					return true;
+				}
+
+				//the string is moved only if no other field needs it
+				if (frame.type == FrameType::OBJECT && matches.size() == 1 && matches[0].field->type == ChzzkFieldType::STRING)
+				{
+					*static_cast<std::string*>(matches[0].field->member(matches[0].object)) = std::move(value);
+					matches.clear();
+
+					return true;
+				}
+			}
+
+			return scalar([&](const ChzzkField& field, void* member) {
+				if (field.type == ChzzkFieldType::STRING) *static_cast<std::string*>(member) = value;
+				else if (field.type == ChzzkFieldType::NESTED) parse_nested(value, *field.table, member);
+			}, [&]() { return nlohmann::json(value); });
+		}
+
+		bool binary(binary_t&) override
+		{
+			return true;
+		}
+
+		bool start_object(std::size_t) override
+		{
+			if (skipDepth)
+			{
+				skipDepth++;
+				return true;
+			}
+
+			if (capturing())
+			{
+				rawStack.push_back(capture(nlohmann::json::object()));
+				return true;
+			}
+
+			if (stack.empty())
+			{
+				pushObject(root, &rootTable);
+				return true;
+			}
+
+			Frame& frame = stack.back();
+
+			if (frame.type == FrameType::STRING_LIST)
+			{
+				static_cast<std::vector<std::string>*>(frame.object)->emplace_back();
+				skipDepth = 1;
+
+				return true;
+			}
+
+			if (frame.type == FrameType::OBJECT_LIST)
+			{
+				void* element = frame.field->append(frame.object);
+				pushObject(element, frame.field->table);
+
+				return true;
+			}
+
+			if (frame.type == FrameType::OBJECT)
+			{
+				if (std::string* dest = rawMatch())
+				{
+					rawDest = dest;
+					rawStack.push_back(capture(nlohmann::json::object()));
+					matches.clear();
+
+					return true;
+				}
+
+				for (auto& match : matches)
+				{
+					if (match.field->type == ChzzkFieldType::OBJECT || match.field->type == ChzzkFieldType::NESTED || match.field->type == ChzzkFieldType::INLINE)
+					{
+						void* object = match.field->member(match.object);
+						const ChzzkFieldTable* table = match.field->table;
+
+						if (table->available) *table->available(object) = false;
+
+						matches.clear();
+						pushObject(object, table);
+
+						return true;
+					}
+				}
+			}
+
+			matches.clear();
+			skipDepth = 1;
+
+			return true;
+		}
+
+		bool key(string_t& key) override
+		{
+			if (skipDepth) return true;
+
+			if (capturing())
+			{
+				rawKey = key;
+				return true;
+			}
+
+			Frame& frame = stack.back();
+			const ChzzkFieldTable* table = frame.table;
+
+			if (table->available) *table->available(frame.object) = true;
+
+			matches.clear();
+			table->find(key.data(), key.size(), field_hash(key.data(), key.size()), frame.object, [&](const ChzzkField& field, void* object) {
+				matches.push_back({ &field, object });
+			});
+
+			return true;
+		}
+
+		bool end_object() override
+		{
+			if (skipDepth)
+			{
+				skipDepth--;
+				return true;
+			}
+
+			if (capturing())
+			{
+				rawStack.pop_back();
+				finishCapture();
+
+				return true;
+			}
+
+			stack.pop_back();
+			matches.clear();
+
+			return true;
+		}
+
+		bool start_array(std::size_t) override
+		{
+			if (skipDepth)
+			{
+				skipDepth++;
+				return true;
+			}
+
+			if (capturing())
+			{
+				rawStack.push_back(capture(nlohmann::json::array()));
+				return true;
+			}
+
+			if (!stack.empty() && stack.back().type == FrameType::STRING_LIST)
+				static_cast<std::vector<std::string>*>(stack.back().object)->emplace_back();
+
+			if (!stack.empty() && stack.back().type == FrameType::OBJECT)
+			{
+				if (std::string* dest = rawMatch())
+				{
+					rawDest = dest;
+					rawStack.push_back(capture(nlohmann::json::array()));
+					matches.clear();
+
+					return true;
+				}
+
+				for (auto& match : matches)
+				{
+					if (match.field->type == ChzzkFieldType::STRING_LIST)
+					{
+						auto list = static_cast<std::vector<std::string>*>(match.field->member(match.object));
+						list->clear();
+
+						stack.push_back({ FrameType::STRING_LIST, list, nullptr, nullptr });
+						matches.clear();
+
+						return true;
+					}
+					else if (match.field->type == ChzzkFieldType::OBJECT_LIST)
+					{
+						stack.push_back({ FrameType::OBJECT_LIST, match.object, match.field, nullptr });
+						matches.clear();
+
+						return true;
+					}
+				}
+			}
+
+			matches.clear();
+			skipDepth = 1;
+
+			return true;
+		}
+
+		bool end_array() override
+		{
+			if (skipDepth)
+			{
+				skipDepth--;
+				return true;
+			}
+
+			if (capturing())
+			{
+				rawStack.pop_back();
+				finishCapture();
+
+				return true;
+			}
+
+			stack.pop_back();
+
+			return true;
+		}
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override
+		{
+			return false;
+		}
+	};
+
+#if _USE_SIMDJSON
+	//on-demand decoder filling the structs with the field tables. gives the same results as ChzzkSaxDecoder
+	//values of unknown keys are skipped without being parsed
+	class ChzzkSimdDecoder
+	{
+		using value = simdjson::ondemand::value;
+
+		struct Match
+		{
+			const ChzzkField* field;
+			void* object;
+		};
+
+		//max number of fields with the same key in a table
+		static constexpr size_t MAX_MATCHES = 8;
+
+		//same as the json value dumped by nlohmann::json. empty if the value is not valid json
+		static std::string dump(std::string_view raw)
+		{
+			auto json = nlohmann::json::parse(raw.begin(), raw.end(), nullptr, false);
+			if (json.is_discarded()) return "";
+
+			return json.dump();
+		}
+
+		static void setRaw(const Match& match, const std::string& raw)
+		{
+			*static_cast<std::string*>(match.field->member(match.object)) = raw;
+		}
+
+		//the first match of the types, if any
+		static const Match* first(const Match* matches, size_t count, ChzzkFieldType type, ChzzkFieldType other)
+		{
+			for (size_t i = 0; i < count; i++)
+				if (matches[i].field->type == type || matches[i].field->type == other) return &matches[i];
+
+			return nullptr;
+		}
+
+		template <typename V>
+		static void setNumber(const Match* matches, size_t count, V number)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const ChzzkField& field = *matches[i].field;
+				void* member = field.member(matches[i].object);
+
+				if (field.type == ChzzkFieldType::INT) *static_cast<int*>(member) = (int)number;
+				else if (field.type == ChzzkFieldType::BOOL) *static_cast<bool*>(member) = number != 0;
+				else if (field.type == ChzzkFieldType::RAW) *static_cast<std::string*>(member) = nlohmann::json(number).dump();
+			}
+		}
+
+		static simdjson::error_code decodeList(simdjson::ondemand::array array, const Match& match)
+		{
+			for (auto element : array)
+			{
+				value item;
+				simdjson::ondemand::json_type type;
+
+				if (auto error = std::move(element).get(item)) return error;
+				if (auto error = item.type().get(type)) return error;
+
+				if (match.field->type == ChzzkFieldType::STRING_LIST)
+				{
+					auto list = static_cast<std::vector<std::string>*>(match.field->member(match.object));
+
+					if (type == simdjson::ondemand::json_type::string)
+					{
+						std::string_view str;
+						if (auto error = item.get_string().get(str)) return error;
+
+						list->emplace_back(str);
+					}
+					else
+					{
+						//same as json_safe_get<std::string> of non-string elements
+						list->emplace_back();
+					}
+				}
+				else if (type == simdjson::ondemand::json_type::object)
+				{
+					simdjson::ondemand::object object;
+					if (auto error = item.get_object().get(object)) return error;
+
+					if (auto error = decodeObject(object, *match.field->table, match.field->append(match.object))) return error;
+				}
+			}
+
+			return simdjson::SUCCESS;
+		}
+
+		static simdjson::error_code decodeValue(value& json, const Match* matches, size_t count)
+		{
+			simdjson::ondemand::json_type type;
+			if (auto error = json.type().get(type)) return error;
+
+			switch (type)
+			{
+			case simdjson::ondemand::json_type::object:
+			case simdjson::ondemand::json_type::array:
+				{
+					//raw fields take the whole value
+					if (const Match* raw = first(matches, count, ChzzkFieldType::RAW, ChzzkFieldType::RAW))
+					{
+						std::string_view text;
+						if (auto error = json.raw_json().get(text)) return error;
+
+						setRaw(*raw, dump(text));
+						return simdjson::SUCCESS;
+					}
+
+					if (type == simdjson::ondemand::json_type::object)
+					{
+						const Match* match = first(matches, count, ChzzkFieldType::OBJECT, ChzzkFieldType::INLINE);
+						if (!match) match = first(matches, count, ChzzkFieldType::NESTED, ChzzkFieldType::NESTED);
+						if (!match) return simdjson::SUCCESS;
+
+						simdjson::ondemand::object object;
+						if (auto error = json.get_object().get(object)) return error;
+
+						return decodeObject(object, *match->field->table, match->field->member(match->object));
+					}
+
+					const Match* match = first(matches, count, ChzzkFieldType::STRING_LIST, ChzzkFieldType::OBJECT_LIST);
+					if (!match) return simdjson::SUCCESS;
+
+					simdjson::ondemand::array array;
+					if (auto error = json.get_array().get(array)) return error;
+
+					if (match->field->type == ChzzkFieldType::STRING_LIST)
+						static_cast<std::vector<std::string>*>(match->field->member(match->object))->clear();
+
+					return decodeList(array, *match);
+				}
+
+			case simdjson::ondemand::json_type::string:
+				{
+					std::string_view str;
+					if (auto error = json.get_string().get(str)) return error;
+
+					for (size_t i = 0; i < count; i++)
+					{
+						if (matches[i].field->type == ChzzkFieldType::STRING) static_cast<std::string*>(matches[i].field->member(matches[i].object))->assign(str);
+						else if (matches[i].field->type == ChzzkFieldType::RAW) setRaw(matches[i], nlohmann::json(str).dump());
+						//decoded with nlohmann::json, since the parser of the thread is busy with the outer document
+						else if (matches[i].field->type == ChzzkFieldType::NESTED) parse_nested(std::string(str), *matches[i].field->table, matches[i].field->member(matches[i].object));
+					}
+				}
+				break;
+
+			case simdjson::ondemand::json_type::number:
+				{
+					simdjson::ondemand::number number;
+					if (auto error = json.get_number().get(number)) return error;
+
+					switch (number.get_number_type())
+					{
+					case simdjson::ondemand::number_type::signed_integer: setNumber(matches, count, number.get_int64()); break;
+					case simdjson::ondemand::number_type::unsigned_integer: setNumber(matches, count, number.get_uint64()); break;
+					default: setNumber(matches, count, number.get_double()); break;
+					}
+				}
+				break;
+
+			case simdjson::ondemand::json_type::boolean:
+				{
+					bool flag;
+					if (auto error = json.get_bool().get(flag)) return error;
+
+					for (size_t i = 0; i < count; i++)
+					{
+						const ChzzkField& field = *matches[i].field;
+						void* member = field.member(matches[i].object);
+
+						if (field.type == ChzzkFieldType::BOOL) *static_cast<bool*>(member) = flag;
+						else if (field.type == ChzzkFieldType::INT) *static_cast<int*>(member) = flag;
+						else if (field.type == ChzzkFieldType::RAW) setRaw(matches[i], flag ? "true" : "false");
+					}
+				}
+				break;
+
+			case simdjson::ondemand::json_type::null:
+				{
+					bool isNull;
+					if (auto error = json.is_null().get(isNull)) return error;
+
+					//resets the fields to their default values
+					for (size_t i = 0; i < count; i++)
+					{
+						const ChzzkField& field = *matches[i].field;
+						void* member = field.member(matches[i].object);
+
+						switch (field.type)
+						{
+						case ChzzkFieldType::BOOL: *static_cast<bool*>(member) = false; break;
+						case ChzzkFieldType::INT: *static_cast<int*>(member) = 0; break;
+						case ChzzkFieldType::STRING: static_cast<std::string*>(member)->clear(); break;
+						case ChzzkFieldType::STRING_LIST: static_cast<std::vector<std::string>*>(member)->clear(); break;
+						case ChzzkFieldType::RAW: setRaw(matches[i], "null"); break;
+
+						//structs are left as they are, same as parse_field
+						case ChzzkFieldType::OBJECT:
+						case ChzzkFieldType::NESTED:
+						case ChzzkFieldType::INLINE:
+						case ChzzkFieldType::OBJECT_LIST:
+							break;
+						}
+					}
+				}
+				break;
+			}
+
+			return simdjson::SUCCESS;
+		}
+
+	public:
+		static simdjson::error_code decodeObject(simdjson::ondemand::object object, const ChzzkFieldTable& table, void* target)
+		{
+			if (table.available) *table.available(target) = false;
+
+			for (auto entry : object)
+			{
+				simdjson::ondemand::field field;
+				std::string_view key;
+
+				if (auto error = std::move(entry).get(field)) return error;
+				if (auto error = field.unescaped_key().get(key)) return error;
+
+				if (table.available) *table.available(target) = true;
+
+				Match matches[MAX_MATCHES];
+				size_t count = 0;
+
+				table.find(key.data(), key.size(), field_hash(key.data(), key.size()), target, [&](const ChzzkField& field, void* object) {
+					if (count < MAX_MATCHES) matches[count++] = { &field, object };
+				});
+
+				//unknown keys are skipped by the iterator
+				if (!count) continue;
+
+				if (auto error = decodeValue(field.value(), matches, count)) return error;
+			}
+
+			return simdjson::SUCCESS;
+		}
+	};
+
+	bool parse_stream(const std::string& data, const ChzzkFieldTable& table, void* object)
+	{
+		//simdjson reads past the end of the input, so the data is copied into a padded buffer reused by the thread
+		thread_local simdjson::ondemand::parser parser;
+		thread_local std::string buffer;
+
+		buffer.reserve(data.size() + simdjson::SIMDJSON_PADDING);
+		buffer.assign(data);
+
+		simdjson::ondemand::document document;
+		if (parser.iterate(simdjson::padded_string_view(buffer.data(), buffer.size(), buffer.capacity())).get(document)) return false;
+
+		simdjson::ondemand::json_type type;
+		if (document.type().get(type)) return false;
+
+		if (type == simdjson::ondemand::json_type::object)
+		{
+			simdjson::ondemand::object root;
+
+			if (document.get_object().get(root)) return false;
+			if (ChzzkSimdDecoder::decodeObject(root, table, object)) return false;
+		}
+		else
+		{
+			//not a struct. only checks that it is valid json
+			std::string_view raw;
+			if (document.raw_json().get(raw)) return false;
+		}
+
+		return document.at_end();
+	}
+#else
+	bool parse_stream(const std::string& data, const ChzzkFieldTable& table, void* object)
+	{
+		ChzzkSaxDecoder decoder(table, object);
+		return nlohmann::json::sax_parse(data, &decoder);
+	}
+#endif
+}
@@ -0,0 +1,62 @@
+#include <chzzkpp/ChzzkShare.h>
+
+namespace chzzkpp
+{
+#if _USE_CURL
+	ChzzkShare::ChzzkShare()
+	{
+		share = curl_share_init();
+
+		if (share)
+		{
+			curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lock);
+			curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlock);
+			curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+
+			curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+			curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+		}
+	}
+
+	ChzzkShare::~ChzzkShare()
+	{
+		if (share) curl_share_cleanup(share);
+		share = nullptr;
+	}
+
+	void ChzzkShare::lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr)
+	{
+		if (data < 0 || data >= CURL_LOCK_DATA_LAST) return;
+
+		static_cast<ChzzkShare*>(userptr)->mutexes[data].lock();
+	}
+
+	void ChzzkShare::unlock(CURL*, curl_lock_data data, void* userptr)
+	{
+		if (data < 0 || data >= CURL_LOCK_DATA_LAST) return;
+
+		static_cast<ChzzkShare*>(userptr)->mutexes[data].unlock();
+	}
+
+	void ChzzkShare::apply(CURL* handle)
+	{
+		if (share) curl_easy_setopt(handle, CURLOPT_SHARE, share);
+	}
+#else
+	ChzzkShare::ChzzkShare()
+	{
+
+	}
+
+	ChzzkShare::~ChzzkShare()
+	{
+
+	}
+#endif
+
+	ChzzkShare& ChzzkShare::shared()
+	{
+		static ChzzkShare share;
+		return share;
+	}
+}
@@ -0,0 +1,175 @@
+#include <chzzkpp/ChzzkTimer.h>
+
+#if _DEBUG
+#include <iostream>
+#endif
+
+namespace chzzkpp
+{
+	ChzzkTimer::ChzzkTimer() : running(true), nextID(1), runningID(0)
+	{
+		thread = std::thread(&ChzzkTimer::run, this);
+		threadID = thread.get_id();
+	}
+
+	ChzzkTimer::~ChzzkTimer()
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			running = false;
+		}
+
+		wakeup.notify_all();
+
+		if (thread.joinable()) thread.join();
+	}
+
+	ChzzkTimer& ChzzkTimer::shared()
+	{
+		static ChzzkTimer timer;
+		return timer;
+	}
+
+	void ChzzkTimer::schedule(size_t id, Timer& timer, Clock::time_point deadline)
+	{
+		timer.deadline = deadline;
+
+		//the heap only needs a new entry if the timer fires earlier than its current entry
+		if (deadline < timer.scheduled)
+		{
+			timer.scheduled = deadline;
+			queue.push({ deadline, id });
+
+			if (queue.top().id == id) wakeup.notify_one();
+		}
+	}
+
+	size_t ChzzkTimer::add(int interval, const Callback& callback, bool repeat)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		size_t id = nextID++;
+
+		auto timer = std::make_shared<Timer>();
+		timer->callback = callback;
+		timer->interval = interval;
+		timer->repeat = repeat;
+		timer->scheduled = Clock::time_point::max();
+
+		schedule(id, *timer, Clock::now() + std::chrono::milliseconds(interval));
+
+		timers.emplace(id, std::move(timer));
+
+		return id;
+	}
+
+	void ChzzkTimer::rearm(size_t id)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		auto it = timers.find(id);
+		if (it == timers.end()) return;
+
+		auto& timer = *it->second;
+		schedule(id, timer, Clock::now() + std::chrono::milliseconds(timer.interval));
+	}
+
+	void ChzzkTimer::rearm(size_t id, int interval)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		auto it = timers.find(id);
+		if (it == timers.end()) return;
+
+		auto& timer = *it->second;
+		timer.interval = interval;
+		schedule(id, timer, Clock::now() + std::chrono::milliseconds(interval));
+	}
+
+	void ChzzkTimer::remove(size_t id)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		timers.erase(id);
+
+		//removing itself from the callback should not wait
+		if (std::this_thread::get_id() != threadID)
+			finished.wait(lock, [&]() { return runningID != id; });
+	}
+
+	bool ChzzkTimer::exists(size_t id)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return timers.find(id) != timers.end();
+	}
+
+	size_t ChzzkTimer::size()
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return timers.size();
+	}
+
+	void ChzzkTimer::run()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (running)
+		{
+			if (queue.empty())
+			{
+				wakeup.wait(lock);
+				continue;
+			}
+
+			Entry top = queue.top();
+			auto now = Clock::now();
+
+			if (top.time > now)
+			{
+				wakeup.wait_until(lock, top.time);
+				continue;
+			}
+
+			queue.pop();
+
+			auto it = timers.find(top.id);
+			if (it == timers.end()) continue; //removed
+
+			auto timer = it->second;
+			if (top.time != timer->scheduled) continue; //outdated entry
+
+			if (timer->deadline > now) //rearmed later, so move the entry
+			{
+				timer->scheduled = timer->deadline;
+				queue.push({ timer->deadline, top.id });
+				continue;
+			}
+
+			if (timer->repeat)
+			{
+				timer->scheduled = Clock::time_point::max();
+				schedule(top.id, *timer, now + std::chrono::milliseconds(timer->interval));
+			}
+			else
+				timers.erase(it);
+
+			runningID = top.id;
+			lock.unlock();
+
+			try
+			{
+				timer->callback();
+			}
+			catch (std::exception& e)
+			{
+#if _DEBUG
+				std::cerr << "Error occured on timer callback: " << e.what() << std::endl;
+#endif
+			}
+
+			lock.lock();
+			runningID = 0;
+			finished.notify_all();
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #include <chzzkpp/ChzzkUtils.h>
 #include <chzzkpp/Path.h>
+#include <chzzkpp/ChzzkChatView.h>
 
 #if _WIN32
 #include <Windows.h>
@@ -160,487 +161,238 @@ namespace chzzkpp
 		return CHZZK_API_PATH_PREFIX_CHANNEL + channelID + CHZZK_API_PATH_SUFFIX_DONATION_MISSION_SETTING;
 	}
 
-	template <>
-	ChzzkUserData parse(nlohmann::json json)
+	//decodes the json value into the field of the object. values of other types than the field are ignored
+	static void parse_field(const nlohmann::json& json, const ChzzkField& field, void* object)
 	{
-		ChzzkUserData userData;
-
-		json_safe_get(userData.hasProfile, json, "hasProfile");
-		json_safe_get(userData.userIDHash, json, "userIdHash");
-		json_safe_get(userData.nickname, json, "nickname");
-		json_safe_get(userData.profileImageUrl, json, "profileImageUrl");
+		void* member = field.member(object);
 
-		if (json.find("penalties") != json.end())
+		switch (field.type)
 		{
-			for (auto& element : json["penalties"])
-				userData.penalties.push_back(json_safe_get<std::string>(element));
+		case ChzzkFieldType::BOOL:
+			if (json.is_null()) *static_cast<bool*>(member) = false;
+			else if (json.is_boolean()) *static_cast<bool*>(member) = json.get<bool>();
+			else if (json.is_number()) *static_cast<bool*>(member) = json.get<double>() != 0;
+			break;
+
+		case ChzzkFieldType::INT:
+			if (json.is_null()) *static_cast<int*>(member) = 0;
+			else if (json.is_number()) *static_cast<int*>(member) = json.get<int>();
+			else if (json.is_boolean()) *static_cast<int*>(member) = json.get<bool>();
+			break;
+
+		case ChzzkFieldType::STRING:
+			if (json.is_null()) static_cast<std::string*>(member)->clear();
+			else if (json.is_string()) *static_cast<std::string*>(member) = json.get_ref<const std::string&>();
+			break;
+
+		case ChzzkFieldType::STRING_LIST:
+			if (json.is_null() || json.is_array())
+			{
+				auto list = static_cast<std::vector<std::string>*>(member);
+
+				list->clear();
+				list->reserve(json.size());
+
+				//same as json_safe_get<std::string> of each element
+				for (auto& element : json)
+				{
+					if (element.is_string()) list->push_back(element.get_ref<const std::string&>());
+					else list->emplace_back();
+				}
+			}
+			break;
+
+		case ChzzkFieldType::RAW:
+			*static_cast<std::string*>(member) = json.dump();
+			break;
+
+		case ChzzkFieldType::OBJECT:
+		case ChzzkFieldType::INLINE:
+			if (json.is_object()) parse_table(json, *field.table, member);
+			break;
+
+		case ChzzkFieldType::NESTED:
+			if (json.is_object()) parse_table(json, *field.table, member);
+			else if (json.is_string()) parse_nested(json.get_ref<const std::string&>(), *field.table, member);
+			break;
+
+		case ChzzkFieldType::OBJECT_LIST:
+			if (json.is_array())
+			{
+				for (auto& element : json)
+					if (element.is_object()) parse_table(element, *field.table, field.append(object));
+			}
+			break;
 		}
-
-		json_safe_get(userData.officialNotiAgree, json, "officialNotiAgree");
-		json_safe_get(userData.officialNotiAgreeUpdatedDate, json, "officialNotiAgreeUpdateDate");
-		json_safe_get(userData.verified, json, "verifiedMask");
-		json_safe_get(userData.loggedIn, json, "loggedIn");
-
-		return userData;
-	}
-
-	template <>
-	ChzzkAccessTokenTemporaryRestrict parse(nlohmann::json json)
-	{
-		ChzzkAccessTokenTemporaryRestrict temp;
-
-		json_safe_get(temp.createdTime, json, "createdTime");
-		json_safe_get(temp.duration, json, "duration");
-		json_safe_get(temp.temporaryRestrict, json, "temporaryRestrict");
-		json_safe_get(temp.times, json, "times");
-
-		return temp;
-	}
-
-	template <>
-	ChzzkAccessToken parse(nlohmann::json json)
-	{
-		ChzzkAccessToken token;
-
-		json_safe_get(token.accessToken, json, "accessToken");
-		json_safe_get(token.extraToken, json, "extraToken");
-		json_safe_get(token.realNameAuth, json, "realNameAuth");
-
-		if (json.find("temporaryRestrict") != json.end()) token.temporaryRestrict = parse<ChzzkAccessTokenTemporaryRestrict>(json["temporaryRestrict"]);
-
-		return token;
 	}
 
-	template <>
-	ChzzkChannelFollowingInfo parse(nlohmann::json json)
+	void parse_table(const nlohmann::json& json, const ChzzkFieldTable& table, void* object)
 	{
-		ChzzkChannelFollowingInfo info;
+		if (table.available) *table.available(object) = json.is_object() && !json.empty();
+		if (!json.is_object()) return;
 
-		if (json.empty()) info.available = false;
-		else
+		for (auto it = json.begin(); it != json.end(); ++it)
 		{
-			info.available = true;
-			json_safe_get(info.following, json, "following");
-			json_safe_get(info.notification, json, "notification");
-			json_safe_get(info.followDate, json, "followDate");
-		}
+			const std::string& key = it.key();
 
-		return info;
-	}
-
-	template <>
-	ChzzkChannelPersonalData parse(nlohmann::json json)
-	{
-		ChzzkChannelPersonalData data;
-
-		if (json.empty()) data.available = false;
-		else
-		{
-			data.available = true;
-			if (json.find("following") != json.end()) data.followInfo = parse<ChzzkChannelFollowingInfo>(json["following"]);
-			json_safe_get(data.privateUserBlock, json, "privateUserBlock");
+			table.find(key.data(), key.size(), field_hash(key.data(), key.size()), object, [&](const ChzzkField& field, void* target) {
+				parse_field(it.value(), field, target);
+			});
 		}
-
-		return data;
 	}
 
-	template <>
-	ChzzkSubscriptionPaymentAvailability parse(nlohmann::json json)
+	void parse_nested(const std::string& text, const ChzzkFieldTable& table, void* object)
 	{
-		ChzzkSubscriptionPaymentAvailability payment;
-
-		json_safe_get(payment.iapAvailability, json, "iapAvailability");
-		json_safe_get(payment.iabAvailability, json, "iabAvailability");
-		return payment;
+		auto json = nlohmann::json::parse(text, nullptr, false);
+		if (json.is_object()) parse_table(json, table, object);
 	}
 
-	template <>
-	ChzzkChannelInfo parse(nlohmann::json json)
+	//sets json with the field of the object
+	static void dump_field(nlohmann::json& json, const ChzzkField& field, void* object)
 	{
-		ChzzkChannelInfo info;
-
-		json_safe_get(info.ID, json, "channelId");
-		json_safe_get(info.name, json, "channelName");
-		json_safe_get(info.imageURL, json, "channelImageUrl");
-		json_safe_get(info.verified, json, "verifiedMask");
-		json_safe_get(info.description, json, "channelDescription");
-		json_safe_get(info.followerCount, json, "followerCount");
-		if (json.find("personalData") != json.end()) info.personalData = parse<ChzzkChannelPersonalData>(json["personalData"]);
+		void* member = field.member(object);
 
-		return info;
-	}
-
-	template <>
-	ChzzkChannel parse(nlohmann::json json)
-	{
-		ChzzkChannel channel;
-
-		json_safe_get(channel.ID, json, "channelId");
-		json_safe_get(channel.name, json, "channelName");
-		json_safe_get(channel.imageURL, json, "channelImageUrl");
-		json_safe_get(channel.verified, json, "verifiedMask");
-		json_safe_get(channel.description, json, "channelDescription");
-		json_safe_get(channel.followerCount, json, "followerCount");
-		if (json.find("personalData") != json.end()) channel.personalData = parse<ChzzkChannelPersonalData>(json["personalData"]);
-
-		json_safe_get(channel.type, json, "channelType");
-		json_safe_get(channel.openLive, json, "openLive");
-		json_safe_get(channel.subscriptionAvailability, json, "subscriptionAvailability");
-		if (json.find("sucbscriptionPaymentAvailability") != json.end()) channel.subscriptionPaymentAvailability = parse<ChzzkSubscriptionPaymentAvailability>(json["sucbscriptionPaymentAvailability"]);
-		json_safe_get(channel.adMonetizationAvailability, json, "adMonetizationAvailability");
-
-		return channel;
-	}
-
-	template <>
-	ChzzkLivePollingStatus parse(nlohmann::json json)
-	{
-		ChzzkLivePollingStatus status;
-
-		json_safe_get(status.status, json, "status");
-		json_safe_get(status.isPublishing, json, "isPublishing");
-		json_safe_get(status.playableStatus, json, "playableStatus");
-		json_safe_get(status.trafficThrottling, json, "trafficThrottling");
-		json_safe_get(status.callPeriodMilliSecond, json, "callPeriodMilliSecond");
-
-		return status;
-	}
-
-	template <>
-	ChzzkLiveStatus parse(nlohmann::json json)
-	{
-		ChzzkLiveStatus status;
-
-		json_safe_get(status.title, json, "liveTitle");
-		json_safe_get(status.status, json, "status");
-		json_safe_get(status.concurrentUserCount, json, "concurrentUserCount");
-		json_safe_get(status.accumulatedUserCount, json, "accumulateCount");
-		json_safe_get(status.paidPromotion, json, "paidPromotion");
-		json_safe_get(status.adult, json, "adult");
-		json_safe_get(status.krOnlyViewing, json, "krOnlyViewing");
-		json_safe_get(status.clipActive, json, "clipActive");
-		json_safe_get(status.chatChannelID, json, "chatChannelId");
-
-		if (json.find("tags") != json.end())
+		switch (field.type)
 		{
-			for (auto& element : json["tags"])
-				status.tags.push_back(json_safe_get<std::string>(element));
+		case ChzzkFieldType::BOOL:
+			json[field.key] = *static_cast<bool*>(member);
+			break;
+
+		case ChzzkFieldType::INT:
+			json[field.key] = *static_cast<int*>(member);
+			break;
+
+		case ChzzkFieldType::STRING:
+			json[field.key] = *static_cast<std::string*>(member);
+			break;
+
+		case ChzzkFieldType::STRING_LIST:
+			json[field.key] = *static_cast<std::vector<std::string>*>(member);
+			break;
+
+		case ChzzkFieldType::RAW:
+			{
+				auto& raw = *static_cast<std::string*>(member);
+				if (raw.empty()) break; //not in the json
+
+				auto value = nlohmann::json::parse(raw, nullptr, false);
+				json[field.key] = value.is_discarded() ? nlohmann::json(raw) : std::move(value);
+			}
+			break;
+
+		case ChzzkFieldType::OBJECT:
+		case ChzzkFieldType::INLINE:
+			json[field.key] = dump_table(*field.table, member);
+			break;
+
+		case ChzzkFieldType::NESTED:
+			json[field.key] = dump_table(*field.table, member).dump();
+			break;
+
+		case ChzzkFieldType::OBJECT_LIST:
+			{
+				auto& list = json[field.key] = nlohmann::json::array();
+
+				for (size_t i = 0; void* element = field.element(object, i); i++)
+					list.push_back(dump_table(*field.table, element));
+			}
+			break;
 		}
-
-		json_safe_get(status.categoryType, json, "categoryType");
-		json_safe_get(status.liveCategory, json, "liveCategory");
-		json_safe_get(status.liveCategoryValue, json, "liveCategoryValue");
-		if (json.find("livePollingStatusJson") != json.end()) status.livePollingStatus = parse<ChzzkLivePollingStatus>(json["livePollingStatusJson"]);
-		json_safe_get(status.faultStatus, json, "faultStatus");
-		json_safe_get(status.userAdultStatus, json, "userAdultStatus");
-		json_safe_get(status.blindType, json, "blindType");
-		json_safe_get(status.chatActive, json, "chatActive");
-		json_safe_get(status.chatAvailableGroup, json, "chatAvailableGroup");
-		json_safe_get(status.chatAvailableCondition, json, "chatAvailableCondition");
-		json_safe_get(status.minFollowerMinute, json, "minFollowerMinute");
-		json_safe_get(status.chatDonationRankingExposure, json, "chatDonationRankingExposure");
-
-		return status;
 	}
 
-	template <>
-	ChzzkLiveBase parse(nlohmann::json json)
+	nlohmann::json dump_table(const ChzzkFieldTable& table, const void* object)
 	{
-		ChzzkLiveBase info;
-
-		json_safe_get(info.ID, json, "liveId");
-		json_safe_get(info.title, json, "liveTitle");
-		json_safe_get(info.imageURL, json, "liveImageUrl");
-		json_safe_get(info.defaultThumbnailImageURL, json, "defaultThumbnailImageUrl");
-		json_safe_get(info.concurrentUserCount, json, "concurrentUserCount");
-		json_safe_get(info.accumulatedUserCount, json, "accumulateCount");
-		json_safe_get(info.openDate, json, "openDate");
-		json_safe_get(info.adult, json, "adult");
-
-		if (json.find("tags") != json.end())
-		{
-			for (auto& element : json["tags"])
-				info.tags.push_back(json_safe_get<std::string>(element));
-		}
+		nlohmann::json json = nlohmann::json::object();
 
-		json_safe_get(info.categoryType, json, "categoryType");
-		json_safe_get(info.liveCategory, json, "liveCategory");
-		json_safe_get(info.liveCategoryValue, json, "liveCategoryValue");
-		json_safe_get(info.channelID, json, "channelId");
-		json_safe_get(info.blindType, json, "blindType");
-		if (json.find("channel") != json.end()) info.channelInfo = parse<ChzzkChannelInfo>(json["channel"]);
+		//the fields are only read
+		void* target = const_cast<void*>(object);
 
-		return info;
-	}
+		if (table.available && !*table.available(target)) return json;
 
-	template <>
-	ChzzkLive parse(nlohmann::json json)
-	{
-		ChzzkLive live;
-
-		json_safe_get(live.ID, json, "liveId");
-		json_safe_get(live.title, json, "liveTitle");
-		json_safe_get(live.imageURL, json, "liveImageUrl");
-		json_safe_get(live.defaultThumbnailImageURL, json, "defaultThumbnailImageUrl");
-		json_safe_get(live.concurrentUserCount, json, "concurrentUserCount");
-		json_safe_get(live.accumulatedUserCount, json, "accumulateCount");
-		json_safe_get(live.openDate, json, "openDate");
-		json_safe_get(live.adult, json, "adult");
-
-		if (json.find("tags") != json.end())
+		for (const ChzzkFieldTable* current = &table; current; current = current->base)
 		{
-			for (auto& element : json["tags"])
-				live.tags.push_back(json_safe_get<std::string>(element));
-		}
+			for (size_t i = 0; i < current->size; i++)
+				dump_field(json, current->fields[i], target);
 
-		json_safe_get(live.categoryType, json, "categoryType");
-		json_safe_get(live.liveCategory, json, "liveCategory");
-		json_safe_get(live.liveCategoryValue, json, "liveCategoryValue");
-		json_safe_get(live.channelID, json, "channelId");
-		json_safe_get(live.blindType, json, "blindType");
-		//live.channelInfo is not here
+			if (current->toBase) target = current->toBase(target);
+		}
 
-		json_safe_get(live.chatChannelID, json, "chatChannelId");
-		json_safe_get(live.livePlayback, json, "livePlaybackJson");
-		return live;
+		return json;
 	}
 
-	template <>
-	ChzzkLiveDetail parse(nlohmann::json json)
-	{
-		ChzzkLiveDetail live;
-
-		json_safe_get(live.title, json, "liveTitle");
-		json_safe_get(live.imageURL, json, "liveImageUrl");
-		json_safe_get(live.defaultThumbnailImageURL, json, "defaultThumbnailImageUrl");
-		json_safe_get(live.concurrentUserCount, json, "concurrentUserCount");
-		json_safe_get(live.accumulatedUserCount, json, "accumulateCount");
-		json_safe_get(live.openDate, json, "openDate");
-		json_safe_get(live.ID, json, "liveId");
-		json_safe_get(live.adult, json, "adult");
-
-		if (json.find("tags") != json.end())
-		{
-			for (auto& element : json["tags"])
-				live.tags.push_back(json_safe_get<std::string>(element));
-		}
-
-		json_safe_get(live.chatChannelID, json, "chatChannelId");
-		json_safe_get(live.categoryType, json, "categoryType");
-		json_safe_get(live.liveCategory, json, "liveCategory");
-		json_safe_get(live.liveCategoryValue, json, "liveCategoryValue");
-		json_safe_get(live.channelID, json, "channelId");
-		json_safe_get(live.livePlayback, json, "livePlaybackJson");
-		json_safe_get(live.blindType, json, "blindType");
-		if (json.find("channel") != json.end()) live.channelInfo = parse<ChzzkChannelInfo>(json["channel"]);
-
-		json_safe_get(live.status, json, "status");
-		json_safe_get(live.closeDate, json, "closeDate");
-		json_safe_get(live.clipActive, json, "clipActive");
-		json_safe_get(live.chatActive, json, "chatActive");
-		json_safe_get(live.chatAvailableGroup, json, "chatAvailableGroup");
-		json_safe_get(live.chatAvailableCondition, json, "chatAvailableCondition");
-		json_safe_get(live.minFollowerMinute, json, "minFollowerMinute");
-
-		if (json.find("p2pQuality") != json.end())
-		{
-			for (auto& element : json["p2pQuality"])
-				live.p2pQuality.push_back(json_safe_get<std::string>(element));
-		}
+	//fields in the extras of chat messages
 
-		json_safe_get(live.userAdultStatus, json, "userAdultStatus");
-		json_safe_get(live.chatDonationRankingExposure, json, "chatDonationRankingExposure");
-		
-		if (json.find("adParameter") != json.end())
-			live.adParameter = json["adParameter"].dump();
+	static constexpr ChzzkField CHAT_EXTRAS_FIELDS[] = {
+		chzzk_field<ChzzkChatMessage, &ChzzkChatMessage::osType>("osType")
+	};
 
-		return live;
-	}
+	static constexpr ChzzkFieldTable CHAT_EXTRAS_TABLE = chzzk_table(CHAT_EXTRAS_FIELDS);
 
-	template <>
-	ChzzkVideoInfo parse(nlohmann::json json)
-	{
-		ChzzkVideoInfo info;
-		json_safe_get(info.videoNo, json, "videoNo");
-		json_safe_get(info.ID, json, "videoId");
-		json_safe_get(info.title, json, "videoTitle");
-		json_safe_get(info.type, json, "videoType");
-		json_safe_get(info.publishDate, json, "publishDate");
-		json_safe_get(info.thumbnailImageURL, json, "thumbnailImageUrl");
-		json_safe_get(info.duration, json, "duration");
-		json_safe_get(info.readCount, json, "readCount");
-		json_safe_get(info.channelID, json, "channelId");
-		json_safe_get(info.publishDateAt, json, "publishDateAt");
-		json_safe_get(info.adult, json, "adult");
-		json_safe_get(info.categoryType, json, "categoryType");
-		json_safe_get(info.videoCategory, json, "videoCategory");
-		json_safe_get(info.videoCategoryValue, json, "videoCategoryValue");
-		json_safe_get(info.blindType, json, "blindType");
-		//info.channelInfo is not here
-
-		return info;
-	}
+	static constexpr ChzzkField DONATION_EXTRAS_FIELDS[] = {
+		chzzk_field<ChzzkDonationMessage, &ChzzkDonationMessage::isAnonymous>("isAnonymous"),
+		chzzk_field<ChzzkDonationMessage, &ChzzkDonationMessage::nickname>("nickname"),
+		chzzk_field<ChzzkDonationMessage, &ChzzkDonationMessage::payType>("payType"),
+		chzzk_field<ChzzkDonationMessage, &ChzzkDonationMessage::payAmount>("payAmount"),
+		chzzk_field<ChzzkDonationMessage, &ChzzkDonationMessage::donationType>("donationType"),
+		chzzk_field<ChzzkDonationMessage, &ChzzkDonationMessage::missionDonationID>("missionDonationId"),
+		chzzk_field<ChzzkDonationMessage, &ChzzkDonationMessage::missionText>("missionText")
+	};
 
-	template <>
-	ChzzkVideo parse(nlohmann::json json)
-	{
-		ChzzkVideo video;
-		json_safe_get(video.videoNo, json, "videoNo");
-		json_safe_get(video.ID, json, "videoId");
-		json_safe_get(video.title, json, "videoTitle");
-		json_safe_get(video.type, json, "videoType");
-		json_safe_get(video.publishDate, json, "publishDate");
-		json_safe_get(video.thumbnailImageURL, json, "thumbnailImageUrl");
-		json_safe_get(video.duration, json, "duration");
-		json_safe_get(video.readCount, json, "readCount");
-		json_safe_get(video.channelID, json, "channelId");
-		json_safe_get(video.publishDateAt, json, "publishDateAt");
-		json_safe_get(video.adult, json, "adult");
-		json_safe_get(video.categoryType, json, "categoryType");
-		json_safe_get(video.videoCategory, json, "videoCategory");
-		json_safe_get(video.videoCategoryValue, json, "videoCategoryValue");
-		json_safe_get(video.blindType, json, "blindType");
-		if (json.find("channel") != json.end()) video.channelInfo = parse<ChzzkChannelInfo>(json["channel"]);
-
-		json_safe_get(video.exposure, json, "exposure");
-		json_safe_get(video.clipActive, json, "clipActive");
-		json_safe_get(video.inKey, json, "inKey");
-		json_safe_get(video.liveOpenDate, json, "liveOpenDate");
-		json_safe_get(video.vodStatus, json, "vodStatus");
-
-		if (json.find("prevVideo") != json.end())
-			video.prevVideo = json["prevVideo"].dump();
-
-		if (json.find("nextVideo") != json.end())
-			video.nextVideo = json["nextVideo"].dump();
-
-		json_safe_get(video.userAdultStatus, json, "userAdultStatus");
-		
-		if (json.find("adParameter") != json.end())
-			video.adParameter = json["adParameter"].dump();
-
-		return video;
-	}
+	static constexpr ChzzkFieldTable DONATION_EXTRAS_TABLE = chzzk_derived_table<ChzzkDonationMessage, ChzzkChatMessage>(DONATION_EXTRAS_FIELDS, CHAT_EXTRAS_TABLE);
 
-	template <>
-	ChzzkRecommendChannel parse(nlohmann::json json)
-	{
-		ChzzkRecommendChannel channel;
+	static constexpr ChzzkField SUBSCRIPTION_EXTRAS_FIELDS[] = {
+		chzzk_field<ChzzkSubscriptionMessage, &ChzzkSubscriptionMessage::nickname>("nickname"),
+		chzzk_field<ChzzkSubscriptionMessage, &ChzzkSubscriptionMessage::month>("month"),
+		chzzk_field<ChzzkSubscriptionMessage, &ChzzkSubscriptionMessage::tierName>("tierName"),
+		chzzk_field<ChzzkSubscriptionMessage, &ChzzkSubscriptionMessage::tierNo>("tierNo")
+	};
 
-		json_safe_get(channel.ID, json, "channelId");
+	static constexpr ChzzkFieldTable SUBSCRIPTION_EXTRAS_TABLE = chzzk_derived_table<ChzzkSubscriptionMessage, ChzzkChatMessage>(SUBSCRIPTION_EXTRAS_FIELDS, CHAT_EXTRAS_TABLE);
 
-		json_safe_get(channel.name, json["channel"], "channelName");
-		json_safe_get(channel.imageURL, json["channel"], "channelImageUrl");
-		json_safe_get(channel.verified, json["channel"], "verifiedMask");
+	//makes the message with common message data from the view, and the fields in the extras with the table
+	template <typename T>
+	static T parseChatMessage(const ChzzkChatView& view, const ChzzkFieldTable& extrasTable)
+	{
+		T message = T();
 
-		json_safe_get(channel.openLive, json["streamer"], "openLive");
+		message.profile = parse<ChzzkChatProfile>(view.profile());
 
-		json_safe_get(channel.title, json["liveInfo"], "liveTitle");
-		json_safe_get(channel.concurrentUserCount, json["liveInfo"], "concurrentUserCount");
-		json_safe_get(channel.liveCategoryValue, json["liveInfo"], "liveCategoryValue");
+		message.message = view.message();
+		message.time = view.time();
+		message.memberCount = view.memberCount();
+		message.hidden = view.hidden();
+		message.isRecent = view.isRecent();
 
-		json_safe_get(channel.contentLineage, json, "contentLineage");
+		auto& extras = view.extras();
 
-		return channel;
-	}
+		parse_table(extras, extrasTable, &message);
 
-	template <>
-	ChzzkRecommendPartnerChannel parse(nlohmann::json json)
-	{
-		ChzzkRecommendPartnerChannel channel;
-
-		json_safe_get(channel.ID, json, "channelId");
-		json_safe_get(channel.imageURL, json, "channelImageUrl");
-		json_safe_get(channel.originalName, json, "originalNickname");
-		json_safe_get(channel.name, json, "channelName");
-		json_safe_get(channel.verified, json, "verifiedMask");
-		json_safe_get(channel.openLive, json, "openLive");
-		json_safe_get(channel.isNewStreamer, json, "newStreamer");
-		json_safe_get(channel.title, json, "liveTitle");
-		json_safe_get(channel.concurrentUserCount, json, "concurrentUserCount");
-		json_safe_get(channel.liveCategoryValue, json, "liveCategoryValue");
-
-		return channel;
-	}
+		auto emojis = extras.find("emojis");
 
-	template <>
-	ChzzkMissionInfo parse(nlohmann::json json)
-	{
-		ChzzkMissionInfo info;
-
-		json_safe_get(info.ID, json, "missionDonationId");
-		json_safe_get(info.missionText, json, "missionText");
-		json_safe_get(info.channelID, json, "channelId");
-		json_safe_get(info.type, json, "missionType");
-		json_safe_get(info.amount, json, "amount");
-		json_safe_get(info.failCheeringRate, json, "failCheeringRate");
-		json_safe_get(info.status, json, "status");
-		json_safe_get(info.success, json, "success");
-		json_safe_get(info.durationTime, json, "missionDurationTime");
-		json_safe_get(info.startTime, json, "missionStartTime");
-		json_safe_get(info.endTime, json, "missionEndTime");
-		json_safe_get(info.createdTime, json, "createdTime");
-
-		if (json.find("user") != json.end())
+		if (emojis != extras.end() && emojis->is_object())
 		{
-			json_safe_get(info.userIdHash, json["user"], "userIdHash");
-			json_safe_get(info.userNickname, json["user"], "nickname");
-			json_safe_get(info.userProfileImageURL, json["user"], "profileImageUrl");
-			json_safe_get(info.userVerified, json["user"], "verifiedMask");
+			for (auto& emoji : emojis->items())
+				message.emojis[emoji.key()] = json_safe_get<std::string>(emoji.value());
 		}
 
-		json_safe_get(info.anonymous, json, "anonymous");
-
-		//json_safe_get(info.channel, json, "channel");
-		//json_safe_get(info.createdBadge, json, "createdBadge");
-
-		json_safe_get(info.totalAmount, json, "totalAmount");
-		json_safe_get(info.missionType, json, "missionType");
-		json_safe_get(info.participationCount, json, "participationCount");
-		json_safe_get(info.relatedMissionID, json, "relatedMissionDonationId");
-
-		return info;
+		return message;
 	}
 
 	template <>
-	ChzzkChatDonationSetting parse(nlohmann::json json)
+	ChzzkChatMessage parse_view(const ChzzkChatView& view)
 	{
-		ChzzkChatDonationSetting setting;
-
-		json_safe_get(setting.active, json, "donationActive");
-		json_safe_get(setting.minCurrencyPayAmount, json, "minCurrencyPayAmount");
-		json_safe_get(setting.exposureDonationAmount, json, "exposureDonationAmount");
-
-		return setting;
+		return parseChatMessage<ChzzkChatMessage>(view, CHAT_EXTRAS_TABLE);
 	}
 
 	template <>
-	ChzzkVideoDonationSetting parse(nlohmann::json json)
+	ChzzkDonationMessage parse_view(const ChzzkChatView& view)
 	{
-		ChzzkVideoDonationSetting setting;
-
-		json_safe_get(setting.active, json, "donationActive");
-		json_safe_get(setting.minCurrencyPayAmount, json, "minCurrencyPayAmount");
-		json_safe_get(setting.payAmountPerSecond, json, "payAmountPerSecond");
-		json_safe_get(setting.maxDurationLength, json, "maxDurationLength");
-		json_safe_get(setting.isYoutubeAllowed, json, "isYoutubeVideoAllow");
-		json_safe_get(setting.isChzzkClipAllowed, json, "isChzzkClipAllow");
-		json_safe_get(setting.isAllowedForSubscribers, json, "isAllowForSubscriber");
-
-		return setting;
+		return parseChatMessage<ChzzkDonationMessage>(view, DONATION_EXTRAS_TABLE);
 	}
 
 	template <>
-	ChzzkMissionDonationSetting parse(nlohmann::json json)
+	ChzzkSubscriptionMessage parse_view(const ChzzkChatView& view)
 	{
-		ChzzkMissionDonationSetting setting;
-
-		json_safe_get(setting.active, json, "donationActive");
-		json_safe_get(setting.minCurrencyPayAmount, json, "minCurrencyPayAmount");
-		json_safe_get(setting.maxCurrencyPayAmount, json, "maxCurrencyPayAmount");
-		json_safe_get(setting.failCheeringRate, json, "failCheeringRate");
-		json_safe_get(setting.coolTime, json, "cooltime");
-
-		return setting;
+		return parseChatMessage<ChzzkSubscriptionMessage>(view, SUBSCRIPTION_EXTRAS_TABLE);
 	}
 }
\ No newline at end of file
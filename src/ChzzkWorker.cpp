@@ -0,0 +1,81 @@
+#include <chzzkpp/ChzzkWorker.h>
+
+#if _DEBUG
+#include <iostream>
+#endif
+
+namespace chzzkpp
+{
+	ChzzkWorker::ChzzkWorker(size_t threadCount) : running(true)
+	{
+		if (!threadCount) threadCount = 1;
+
+		for (size_t i = 0; i < threadCount; i++)
+			threads.emplace_back(&ChzzkWorker::run, this);
+	}
+
+	ChzzkWorker::~ChzzkWorker()
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			running = false;
+		}
+
+		wakeup.notify_all();
+
+		for (auto& thread : threads)
+			if (thread.joinable()) thread.join();
+	}
+
+	ChzzkWorker& ChzzkWorker::shared()
+	{
+		static ChzzkWorker worker;
+		return worker;
+	}
+
+	void ChzzkWorker::post(const Task& task)
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			tasks.push_back(task);
+		}
+
+		wakeup.notify_one();
+	}
+
+	size_t ChzzkWorker::size()
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return tasks.size();
+	}
+
+	void ChzzkWorker::run()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (true)
+		{
+			wakeup.wait(lock, [&]() { return !running || !tasks.empty(); });
+
+			if (tasks.empty()) break; //stopped
+
+			Task task = std::move(tasks.front());
+			tasks.pop_front();
+
+			lock.unlock();
+
+			try
+			{
+				task();
+			}
+			catch (std::exception& e)
+			{
+#if _DEBUG
+				std::cerr << "Error occured on worker task: " << e.what() << std::endl;
+#endif
+			}
+
+			lock.lock();
+		}
+	}
+}
@@ -0,0 +1,151 @@
+#include "ChzzkTest.h"
+
+#include <chzzkpp/ChzzkCache.h>
+
+#include <string>
+#include <thread>
+
+using namespace chzzkpp;
+
+static ChzzkCacheEntry makeEntry(const std::string& response, const std::string& etag = "")
+{
+	ChzzkCacheEntry entry;
+	entry.response = response;
+	entry.etag = etag;
+
+	return entry;
+}
+
+static void testFind()
+{
+	ChzzkCache cache(1024 * 1024);
+	ChzzkCacheEntry entry;
+
+	CHZZK_CHECK(cache.find("a", entry) == ChzzkCache::Lookup::NONE);
+
+	cache.store("a", makeEntry("response a", "\"1\""), 60);
+
+	CHZZK_CHECK(cache.find("a", entry) == ChzzkCache::Lookup::FRESH);
+	CHZZK_CHECK(entry.response == "response a");
+	CHZZK_CHECK(entry.etag == "\"1\"");
+
+	//not stored without ttl
+	cache.store("b", makeEntry("response b"), 0);
+	CHZZK_CHECK(cache.find("b", entry) == ChzzkCache::Lookup::NONE);
+
+	ChzzkCacheStats stats = cache.getStats();
+	CHZZK_CHECK(stats.hits == 1);
+	CHZZK_CHECK(stats.misses == 2);
+	CHZZK_CHECK(stats.entries == 1);
+}
+
+static void testDisabled()
+{
+	ChzzkCache cache;
+	ChzzkCacheEntry entry;
+
+	cache.store("a", makeEntry("response a"), 60);
+
+	CHZZK_CHECK(cache.find("a", entry) == ChzzkCache::Lookup::NONE);
+	CHZZK_CHECK(cache.getStats().entries == 0);
+}
+
+static void testEviction()
+{
+	//size of an entry, measured with the first one
+	size_t size;
+	{
+		ChzzkCache measure(1024 * 1024);
+		measure.store("0", makeEntry(std::string(100, 'x')), 60);
+		size = measure.getStats().bytes;
+	}
+
+	ChzzkCache cache(size * 3);
+	ChzzkCacheEntry entry;
+
+	cache.store("0", makeEntry(std::string(100, 'x')), 60);
+	cache.store("1", makeEntry(std::string(100, 'x')), 60);
+	cache.store("2", makeEntry(std::string(100, 'x')), 60);
+
+	//0 becomes the most recently used, so 1 is evicted
+	CHZZK_CHECK(cache.find("0", entry) == ChzzkCache::Lookup::FRESH);
+
+	cache.store("3", makeEntry(std::string(100, 'x')), 60);
+
+	CHZZK_CHECK(cache.find("1", entry) == ChzzkCache::Lookup::NONE);
+	CHZZK_CHECK(cache.find("0", entry) == ChzzkCache::Lookup::FRESH);
+	CHZZK_CHECK(cache.find("2", entry) == ChzzkCache::Lookup::FRESH);
+	CHZZK_CHECK(cache.find("3", entry) == ChzzkCache::Lookup::FRESH);
+
+	ChzzkCacheStats stats = cache.getStats();
+	CHZZK_CHECK(stats.evictions == 1);
+	CHZZK_CHECK(stats.entries == 3);
+	CHZZK_CHECK(stats.bytes == size * 3);
+
+	//replacing a key doesn't evict the others
+	cache.store("3", makeEntry(std::string(100, 'y')), 60);
+	CHZZK_CHECK(cache.find("3", entry) == ChzzkCache::Lookup::FRESH && entry.response[0] == 'y');
+	CHZZK_CHECK(cache.getStats().evictions == 1);
+
+	//response bigger than the cache is not stored
+	cache.store("4", makeEntry(std::string(size * 3, 'x')), 60);
+	CHZZK_CHECK(cache.find("4", entry) == ChzzkCache::Lookup::NONE);
+	CHZZK_CHECK(cache.getStats().entries == 3);
+
+	//shrinking the capacity evicts the least recently used
+	cache.setCapacity(size);
+	CHZZK_CHECK(cache.getStats().entries == 1);
+	CHZZK_CHECK(cache.find("3", entry) == ChzzkCache::Lookup::FRESH);
+
+	cache.clear();
+	CHZZK_CHECK(cache.getStats().entries == 0);
+	CHZZK_CHECK(cache.getStats().bytes == 0);
+}
+
+static void testRevalidation()
+{
+	ChzzkCache cache(1024 * 1024);
+	ChzzkCacheEntry entry;
+
+	cache.store("a", makeEntry("response a", "\"1\""), 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+	//expired entries are kept with their validators
+	CHZZK_CHECK(cache.find("a", entry) == ChzzkCache::Lookup::STALE);
+	CHZZK_CHECK(entry.etag == "\"1\"");
+
+	//304 Not Modified
+	entry = ChzzkCacheEntry();
+	CHZZK_CHECK(cache.refresh("a", 60, entry));
+	CHZZK_CHECK(entry.response == "response a");
+	CHZZK_CHECK(cache.find("a", entry) == ChzzkCache::Lookup::FRESH);
+
+	CHZZK_CHECK(!cache.refresh("b", 60, entry));
+	CHZZK_CHECK(cache.getStats().revalidated == 1);
+}
+
+static void testTTL()
+{
+	ChzzkCache cache;
+
+	CHZZK_CHECK(cache.getTTL(ChzzkEndpoint::CHANNEL) == 60);
+	CHZZK_CHECK(cache.getTTL(ChzzkEndpoint::LIVE_STATUS) == 0);
+
+	cache.setTTL(ChzzkEndpoint::LIVE_STATUS, 5);
+	CHZZK_CHECK(cache.getTTL(ChzzkEndpoint::LIVE_STATUS) == 5);
+
+	//out of range
+	cache.setTTL(ChzzkEndpoint::COUNT, 5);
+	CHZZK_CHECK(cache.getTTL(ChzzkEndpoint::COUNT) == 0);
+}
+
+int main()
+{
+	testFind();
+	testDisabled();
+	testEviction();
+	testRevalidation();
+	testTTL();
+
+	return CHZZK_TEST_RESULT();
+}
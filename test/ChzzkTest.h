@@ -0,0 +1,30 @@
+#pragma once
+#ifndef _CHZZK_TEST_
+#define _CHZZK_TEST_
+
+#include <iostream>
+
+//minimal checks for the standalone tests. each test is a program returning the number of failed checks
+namespace chzzkpp
+{
+	inline int& testFailures()
+	{
+		static int failures = 0;
+		return failures;
+	}
+}
+
+#define CHZZK_CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+			chzzkpp::testFailures()++; \
+		} \
+	} while (0)
+
+#define CHZZK_TEST_RESULT() \
+	(std::cout << (chzzkpp::testFailures() ? "failed " : "passed ") << __FILE__ << std::endl, chzzkpp::testFailures())
+
+#endif
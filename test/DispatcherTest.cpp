@@ -0,0 +1,161 @@
+#include "ChzzkTest.h"
+
+#include <chzzkpp/ChzzkDispatcher.h>
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+using namespace chzzkpp;
+
+struct Item
+{
+	int type;		//0 is a message, 1 is a state, 2 is a lifecycle event
+	int index;
+};
+
+//handles the items on one worker, blocked until the producer is done, so the queue overflows
+struct Recorder
+{
+	std::atomic<bool> open;
+	std::mutex mutex;
+	std::vector<Item> handled;
+
+	Recorder() : open(false)
+	{
+	}
+
+	void handle(Item& item)
+	{
+		while (!open) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		std::lock_guard<std::mutex> guard(mutex);
+		handled.push_back(item);
+	}
+};
+
+static size_t coalesceKey(const Item& item)
+{
+	return item.type == 1 ? 1 : ChzzkDispatcher<Item>::UNIQUE_KEY;
+}
+
+static bool droppable(const Item& item)
+{
+	return item.type != 2;
+}
+
+static void testDropOldest()
+{
+	const int COUNT = 100;
+	Recorder recorder;
+	ChzzkDispatchStats stats;
+
+	{
+		ChzzkDispatcher<Item> dispatcher(8, 1, ChzzkOverflowPolicy::DROP_OLDEST, [&](Item& item) { recorder.handle(item); }, coalesceKey, droppable);
+
+		//every tenth item can't be dropped
+		for (int i = 0; i < COUNT; i++)
+			dispatcher.push({ i % 10 == 0 ? 2 : 0, i });
+
+		stats = dispatcher.getStats();
+		recorder.open = true;
+	}
+
+	size_t lifecycle = 0;
+	bool ordered = true;
+
+	for (size_t i = 0; i < recorder.handled.size(); i++)
+	{
+		if (recorder.handled[i].type == 2) lifecycle++;
+		if (i && recorder.handled[i].index <= recorder.handled[i - 1].index) ordered = false;
+	}
+
+	CHZZK_CHECK(stats.dropped > 0);
+	CHZZK_CHECK(recorder.handled.size() + stats.dropped == COUNT);
+	CHZZK_CHECK(lifecycle == COUNT / 10);
+	CHZZK_CHECK(ordered);
+}
+
+static void testCoalesce()
+{
+	const int COUNT = 100;
+	Recorder recorder;
+	ChzzkDispatchStats stats;
+
+	{
+		ChzzkDispatcher<Item> dispatcher(8, 1, ChzzkOverflowPolicy::COALESCE, [&](Item& item) { recorder.handle(item); }, coalesceKey, droppable);
+
+		//every fifth item is a state
+		for (int i = 0; i < COUNT; i++)
+			dispatcher.push({ i % 5 == 0 ? 1 : 0, i });
+
+		stats = dispatcher.getStats();
+		recorder.open = true;
+	}
+
+	size_t messages = 0;
+	int lastState = -1;
+
+	for (auto& item : recorder.handled)
+	{
+		if (item.type == 0) messages++;
+		else lastState = item.index;
+	}
+
+	//only the states are replaced, and the latest state is kept
+	CHZZK_CHECK(stats.coalesced > 0);
+	CHZZK_CHECK(messages == COUNT - COUNT / 5);
+	CHZZK_CHECK(recorder.handled.size() + stats.coalesced == COUNT);
+	CHZZK_CHECK(lastState == COUNT - 5);
+}
+
+static void testBlock()
+{
+	const int COUNT = 100;
+	Recorder recorder;
+	recorder.open = true;
+
+	{
+		ChzzkDispatcher<Item> dispatcher(8, 1, ChzzkOverflowPolicy::BLOCK, [&](Item& item) { recorder.handle(item); }, coalesceKey, droppable);
+
+		for (int i = 0; i < COUNT; i++)
+			dispatcher.push({ 0, i });
+	}
+
+	CHZZK_CHECK(recorder.handled.size() == COUNT);
+}
+
+static void testFailure()
+{
+	std::atomic<int> handled(0);
+	ChzzkDispatchStats stats;
+
+	{
+		ChzzkDispatcher<Item> dispatcher(8, 1, ChzzkOverflowPolicy::BLOCK, [&](Item& item) {
+			if (item.index % 2) throw std::runtime_error("handler failed");
+			handled++;
+		}, coalesceKey, droppable);
+
+		for (int i = 0; i < 10; i++)
+			dispatcher.push({ 0, i });
+
+		while (dispatcher.getStats().dispatched < 10) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		stats = dispatcher.getStats();
+	}
+
+	//a throwing handler doesn't stop the worker
+	CHZZK_CHECK(handled == 5);
+	CHZZK_CHECK(stats.failed == 5);
+}
+
+int main()
+{
+	testDropOldest();
+	testCoalesce();
+	testBlock();
+	testFailure();
+
+	return CHZZK_TEST_RESULT();
+}
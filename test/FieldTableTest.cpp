@@ -0,0 +1,290 @@
+#include "ChzzkTest.h"
+
+#include <chzzkpp/ChzzkUtils.h>
+#include <chzzkpp/ChzzkSax.h>
+
+#include <string>
+#include <vector>
+
+using namespace chzzkpp;
+
+//api responses in the shape captured from the service, with ids and urls replaced. korean texts are escaped
+
+static const std::string CHANNEL_RESPONSE = R"({"code":200,"message":null,"content":{
+	"channelId":"dec8d4a1e6b2c3f4a5b6c7d8e9f0a1b2","channelName":"\uCE58\uC9C0\uC9C1 \uCC44\uB110","channelImageUrl":"https://nng-phinf.pstatic.net/MjAyNDAx/profile.png",
+	"verifiedMask":true,"channelType":"STREAMING","channelDescription":"description\nwith \"quotes\"","followerCount":123456,"openLive":true,
+	"subscriptionAvailability":true,"sucbscriptionPaymentAvailability":{"iapAvailability":false,"iabAvailability":true},"adMonetizationAvailability":true,
+	"personalData":{"following":{"following":true,"notification":false,"followDate":"2024-01-02 03:04:05"},"privateUserBlock":false}}})";
+
+static const std::string LIVE_DETAIL_RESPONSE = R"({"code":200,"message":null,"content":{
+	"liveId":12345678,"liveTitle":"\uBC29\uC1A1 \uC81C\uBAA9","status":"OPEN","liveImageUrl":"https://livecloud-thumb.akamaized.net/chzzk/live/image_{type}.jpg",
+	"defaultThumbnailImageUrl":null,"concurrentUserCount":4321,"accumulateCount":98765,"openDate":"2024-01-01 12:00:00","closeDate":null,"adult":false,
+	"clipActive":true,"tags":["game","talk"],"chatChannelId":"N1abcd","categoryType":"GAME","liveCategory":"League_of_Legends",
+	"liveCategoryValue":"\uB9AC\uADF8 \uC624\uBE0C \uB808\uC804\uB4DC","chatActive":true,"chatAvailableGroup":"ALL","paidPromotion":false,
+	"chatAvailableCondition":"NONE","minFollowerMinute":0,"livePlaybackJson":"{\"meta\":{\"videoId\":\"abcdef\",\"liveId\":12345678},\"media\":[]}",
+	"p2pQuality":["720p","1080p"],"channel":{"channelId":"dec8d4a1e6b2c3f4a5b6c7d8e9f0a1b2","channelName":"\uCE58\uC9C0\uC9C1 \uCC44\uB110",
+	"channelImageUrl":"https://nng-phinf.pstatic.net/MjAyNDAx/profile.png","verifiedMask":true},
+	"livePollingStatusJson":"{\"status\":\"STARTED\",\"isPublishing\":true,\"playableStatus\":\"PLAYABLE\",\"trafficThrottling\":-1,\"callPeriodMilliSecond\":10000}",
+	"userAdultStatus":null,"chatDonationRankingExposure":true,"adParameter":{"tag":"live","positions":[1,2.5,null],"enabled":true},
+	"dropsCampaignNo":null,"watchPartyNo":null,"blindType":null}})";
+
+static const std::string LIVE_STATUS_RESPONSE = R"({"code":200,"message":null,"content":{
+	"liveTitle":"\uBC29\uC1A1 \uC81C\uBAA9","status":"OPEN","concurrentUserCount":4321,"accumulateCount":98765,"paidPromotion":false,"adult":false,
+	"krOnlyViewing":true,"openDate":"2024-01-01 12:00:00","closeDate":null,"clipActive":true,"chatChannelId":"N1abcd","tags":[],"categoryType":null,
+	"liveCategory":null,"liveCategoryValue":"",
+	"livePollingStatusJson":"{\"status\":\"STARTED\",\"isPublishing\":true,\"playableStatus\":\"PLAYABLE\",\"trafficThrottling\":-1,\"callPeriodMilliSecond\":10000}",
+	"faultStatus":null,"userAdultStatus":"ADULT","blindType":null,"chatActive":true,"chatAvailableGroup":"FOLLOWER","chatAvailableCondition":"REAL_NAME",
+	"minFollowerMinute":10,"chatDonationRankingExposure":false}})";
+
+static const std::string VIDEO_RESPONSE = R"({"code":200,"message":null,"content":{
+	"videoNo":1234567,"videoId":"ABCDEF0123456789","videoTitle":"\uB2E4\uC2DC\uBCF4\uAE30","videoType":"REPLAY","publishDate":"2024-01-01 18:00:00",
+	"thumbnailImageUrl":"https://video-phinf.pstatic.net/thumb.jpg","trailerUrl":null,"duration":7200,"readCount":3456,"publishDateAt":1704099600,
+	"categoryType":"GAME","videoCategory":"League_of_Legends","videoCategoryValue":"\uB9AC\uADF8 \uC624\uBE0C \uB808\uC804\uB4DC","exposure":true,
+	"adult":false,"clipActive":false,"livePv":0,"tags":[],"channel":{"channelId":"dec8d4a1e6b2c3f4a5b6c7d8e9f0a1b2","channelName":"\uCE58\uC9C0\uC9C1 \uCC44\uB110",
+	"channelImageUrl":null,"verifiedMask":false,"personalData":{"privateUserBlock":true}},"blindType":null,"watchTimeline":null,"paidProduct":null,
+	"inKey":"V1234","liveOpenDate":"2024-01-01 12:00:00","vodStatus":"ABR_HLS","prevVideo":{"videoNo":1234566,"videoTitle":"prev","publishDateAt":1704000000},
+	"nextVideo":null,"userAdultStatus":null,"adParameter":{"tag":"vod"}}})";
+
+static const std::string TOP_VIEWER_LIVES_RESPONSE = R"({"code":200,"message":null,"content":{"size":2,"page":{"next":{"concurrentUserCount":10,"liveId":2}},"data":[
+	{"liveId":1,"liveTitle":"first","liveImageUrl":null,"defaultThumbnailImageUrl":null,"concurrentUserCount":20,"accumulateCount":30,"openDate":"2024-01-01 00:00:00",
+	"adult":true,"tags":["a"],"categoryType":"ETC","liveCategory":"talk","liveCategoryValue":"\uD1A0\uD06C","channelId":"c1","blindType":null,
+	"channel":{"channelId":"c1","channelName":"one","channelImageUrl":"https://image/one.png","verifiedMask":true,"personalData":null}},
+	{"liveId":2,"liveTitle":"second","tags":[],"channelId":"c2","channel":{"channelId":"c2","channelName":"two","verifiedMask":false}}]}})";
+
+static const std::string SEARCH_LIVE_RESPONSE = R"({"code":200,"message":null,"content":{"size":2,"page":{"next":{"offset":2}},"data":[
+	{"live":{"liveId":3,"liveTitle":"third","concurrentUserCount":5,"tags":["x","y"],"chatChannelId":"N3","channelId":"c3",
+	"livePlaybackJson":"{\"media\":[{\"mediaId\":\"HLS\"}]}"},"channel":{"channelId":"c3","channelName":"three","verifiedMask":true,"followerCount":7}},
+	{"live":{"liveId":4,"liveTitle":"fourth","concurrentUserCount":6,"tags":[],"chatChannelId":null,"channelId":"c4","livePlaybackJson":null},
+	"channel":{"channelId":"c4","channelName":"four","verifiedMask":false}}]}})";
+
+//response of the api, decoded the same way as ChzzkClient does in ChzzkDecodeMode::STREAMING
+template <typename T>
+struct Response
+{
+	int code;
+	std::string message;
+	T content;
+};
+
+template <typename T>
+static bool streamContent(const std::string& data, const ChzzkFieldTable& table, T& content)
+{
+	ChzzkField fields[] = {
+		chzzk_field<Response<T>, &Response<T>::code>("code"),
+		chzzk_field<Response<T>, &Response<T>::message>("message"),
+		chzzk_object_field<Response<T>, &Response<T>::content>("content", table)
+	};
+
+	Response<T> response = Response<T>();
+	if (!parse_stream(data, chzzk_table(fields), &response)) return false;
+
+	content = std::move(response.content);
+	return response.code == 200;
+}
+
+//tables of the list endpoints, same as the content tables of ChzzkClient
+
+static constexpr ChzzkField TOP_VIEWER_LIVES_FIELDS[] = {
+	chzzk_list_field<ChzzkTopViewerResult, &ChzzkTopViewerResult::lives>("data", ChzzkFields<ChzzkLiveBase>::table)
+};
+
+static constexpr ChzzkFieldTable TOP_VIEWER_LIVES_TABLE = chzzk_table(TOP_VIEWER_LIVES_FIELDS);
+
+static constexpr ChzzkField SEARCH_LIVE_ELEMENT_FIELDS[] = {
+	chzzk_inline_field("live", ChzzkFields<ChzzkLive>::table),
+	chzzk_object_field<ChzzkLive, &ChzzkLive::channelInfo>("channel", ChzzkFields<ChzzkChannelInfo>::table)
+};
+
+static constexpr ChzzkFieldTable SEARCH_LIVE_ELEMENT_TABLE = chzzk_table(SEARCH_LIVE_ELEMENT_FIELDS);
+
+static constexpr ChzzkField SEARCH_LIVE_FIELDS[] = {
+	chzzk_list_field<ChzzkLiveResult, &ChzzkLiveResult::lives>("data", SEARCH_LIVE_ELEMENT_TABLE)
+};
+
+static constexpr ChzzkFieldTable SEARCH_LIVE_TABLE = chzzk_table(SEARCH_LIVE_FIELDS);
+
+static void checkField(bool equal, const std::string& path)
+{
+	if (!equal) std::cerr << "field differs: " << path << std::endl;
+	CHZZK_CHECK(equal);
+}
+
+//compares every field of the table, including the fields of the base tables and the nested structs
+static void compareTable(const ChzzkFieldTable& table, void* dom, void* stream, const std::string& path)
+{
+	for (const ChzzkFieldTable* current = &table; current; current = current->base)
+	{
+		if (current->available) checkField(*current->available(dom) == *current->available(stream), path + "(available)");
+
+		for (size_t i = 0; i < current->size; i++)
+		{
+			const ChzzkField& field = current->fields[i];
+			std::string name = path + "." + field.key;
+
+			void* a = field.member(dom);
+			void* b = field.member(stream);
+
+			switch (field.type)
+			{
+			case ChzzkFieldType::BOOL: checkField(*static_cast<bool*>(a) == *static_cast<bool*>(b), name); break;
+			case ChzzkFieldType::INT: checkField(*static_cast<int*>(a) == *static_cast<int*>(b), name); break;
+			case ChzzkFieldType::STRING: checkField(*static_cast<std::string*>(a) == *static_cast<std::string*>(b), name); break;
+			case ChzzkFieldType::STRING_LIST: checkField(*static_cast<std::vector<std::string>*>(a) == *static_cast<std::vector<std::string>*>(b), name); break;
+
+			//dumps of the same value, though the whitespace of the response may differ
+			case ChzzkFieldType::RAW:
+			{
+				auto& rawA = *static_cast<std::string*>(a);
+				auto& rawB = *static_cast<std::string*>(b);
+
+				checkField(rawA.empty() == rawB.empty() && (rawA.empty() || nlohmann::json::parse(rawA) == nlohmann::json::parse(rawB)), name);
+				break;
+			}
+
+			case ChzzkFieldType::OBJECT:
+			case ChzzkFieldType::NESTED:
+			case ChzzkFieldType::INLINE:
+				compareTable(*field.table, a, b, name);
+				break;
+
+			case ChzzkFieldType::OBJECT_LIST:
+			{
+				//element takes the struct, not the list
+				size_t index = 0;
+
+				for (; field.element(dom, index) && field.element(stream, index); index++)
+					compareTable(*field.table, field.element(dom, index), field.element(stream, index), name + "[" + std::to_string(index) + "]");
+
+				checkField(!field.element(dom, index) && !field.element(stream, index), name + ".size");
+				break;
+			}
+			}
+		}
+
+		if (current->toBase)
+		{
+			dom = current->toBase(dom);
+			stream = current->toBase(stream);
+		}
+	}
+}
+
+//decodes the content through parse<T> and parse_stream, and compares them field by field
+template <typename T>
+static T compareContent(const std::string& response, const std::string& name)
+{
+	T dom = parse<T>(nlohmann::json::parse(response)["content"]);
+
+	T stream = T();
+	CHZZK_CHECK(streamContent(response, ChzzkFields<T>::table, stream));
+
+	compareTable(ChzzkFields<T>::table, &dom, &stream, name);
+	return dom;
+}
+
+static void testChannel()
+{
+	ChzzkChannel channel = compareContent<ChzzkChannel>(CHANNEL_RESPONSE, "channel");
+
+	//the decoders agree on the values, not only on the defaults
+	CHZZK_CHECK(channel.ID == "dec8d4a1e6b2c3f4a5b6c7d8e9f0a1b2");
+	CHZZK_CHECK(channel.name == "\xEC\xB9\x98\xEC\xA7\x80\xEC\xA7\x81 \xEC\xB1\x84\xEB\x84\x90");
+	CHZZK_CHECK(channel.description == "description\nwith \"quotes\"");
+	CHZZK_CHECK(channel.followerCount == 123456);
+	CHZZK_CHECK(channel.openLive);
+	CHZZK_CHECK(channel.personalData.available);
+	CHZZK_CHECK(channel.personalData.followInfo.following);
+	CHZZK_CHECK(channel.personalData.followInfo.followDate == "2024-01-02 03:04:05");
+}
+
+static void testLiveDetail()
+{
+	ChzzkLiveDetail live = compareContent<ChzzkLiveDetail>(LIVE_DETAIL_RESPONSE, "liveDetail");
+
+	CHZZK_CHECK(live.ID == 12345678);
+	CHZZK_CHECK(live.tags.size() == 2);
+	CHZZK_CHECK(live.p2pQuality.size() == 2);
+	CHZZK_CHECK(live.chatChannelID == "N1abcd");
+	CHZZK_CHECK(live.channelInfo.verified);
+	CHZZK_CHECK(!live.channelInfo.personalData.available);
+	CHZZK_CHECK(!live.livePlayback.empty());
+	CHZZK_CHECK(nlohmann::json::parse(live.adParameter)["positions"].size() == 3);
+}
+
+static void testLiveStatus()
+{
+	ChzzkLiveStatus status = compareContent<ChzzkLiveStatus>(LIVE_STATUS_RESPONSE, "liveStatus");
+
+	CHZZK_CHECK(status.krOnlyViewing);
+	CHZZK_CHECK(status.tags.empty());
+	CHZZK_CHECK(status.categoryType.empty());
+	CHZZK_CHECK(status.livePollingStatus.status == "STARTED");
+	CHZZK_CHECK(status.minFollowerMinute == 10);
+}
+
+static void testVideo()
+{
+	ChzzkVideo video = compareContent<ChzzkVideo>(VIDEO_RESPONSE, "video");
+
+	CHZZK_CHECK(video.videoNo == 1234567);
+	CHZZK_CHECK(video.publishDateAt == 1704099600);
+	CHZZK_CHECK(video.channelInfo.personalData.available);
+	CHZZK_CHECK(video.channelInfo.personalData.privateUserBlock);
+	CHZZK_CHECK(nlohmann::json::parse(video.prevVideo)["videoNo"] == 1234566);
+	CHZZK_CHECK(video.nextVideo == "null");
+}
+
+//lists are decoded per element with parse<T> as ChzzkClient does in ChzzkDecodeMode::DOM
+static void testTopViewerLives()
+{
+	nlohmann::json json = nlohmann::json::parse(TOP_VIEWER_LIVES_RESPONSE);
+	ChzzkTopViewerResult dom;
+
+	for (auto& element : json["content"]["data"])
+		dom.lives.push_back(parse<ChzzkLiveBase>(element));
+
+	ChzzkTopViewerResult stream;
+	CHZZK_CHECK(streamContent(TOP_VIEWER_LIVES_RESPONSE, TOP_VIEWER_LIVES_TABLE, stream));
+
+	compareTable(TOP_VIEWER_LIVES_TABLE, &dom, &stream, "topViewerLives");
+
+	CHZZK_CHECK(dom.lives.size() == 2);
+	CHZZK_CHECK(dom.lives[0].channelInfo.imageURL == "https://image/one.png");
+	CHZZK_CHECK(dom.lives[1].ID == 2);
+}
+
+static void testSearchLive()
+{
+	nlohmann::json json = nlohmann::json::parse(SEARCH_LIVE_RESPONSE);
+	ChzzkLiveResult dom;
+
+	for (auto& element : json["content"]["data"])
+	{
+		ChzzkLive live = parse<ChzzkLive>(element["live"]);
+		live.channelInfo = parse<ChzzkChannelInfo>(element["channel"]);
+
+		dom.lives.push_back(live);
+	}
+
+	ChzzkLiveResult stream;
+	CHZZK_CHECK(streamContent(SEARCH_LIVE_RESPONSE, SEARCH_LIVE_TABLE, stream));
+
+	compareTable(SEARCH_LIVE_TABLE, &dom, &stream, "searchLive");
+
+	CHZZK_CHECK(dom.lives.size() == 2);
+	CHZZK_CHECK(dom.lives[0].chatChannelID == "N3");
+	CHZZK_CHECK(dom.lives[0].channelInfo.followerCount == 7);
+	CHZZK_CHECK(dom.lives[1].livePlayback.empty());
+}
+
+int main()
+{
+	testChannel();
+	testLiveDetail();
+	testLiveStatus();
+	testVideo();
+	testTopViewerLives();
+	testSearchLive();
+
+	return CHZZK_TEST_RESULT();
+}
@@ -0,0 +1,110 @@
+#include "ChzzkTest.h"
+
+#include <chzzkpp/ChzzkLatency.h>
+
+#include <thread>
+#include <vector>
+
+using namespace chzzkpp;
+
+static void testBuckets()
+{
+	//exact below 2 * SUB_BUCKET_COUNT
+	for (uint64_t value = 0; value < 2 * ChzzkHistogram::SUB_BUCKET_COUNT; value++)
+	{
+		CHZZK_CHECK(ChzzkHistogram::bucketIndex(value) == value);
+		CHZZK_CHECK(ChzzkHistogram::bucketUpperBound((size_t)value) == value);
+	}
+
+	//every value is in a bucket whose range holds it, and buckets don't go backwards
+	size_t previous = 0;
+
+	for (uint64_t value = 1; value < ((uint64_t)1 << ChzzkHistogram::MAX_VALUE_BITS); value += value / 7 + 1)
+	{
+		size_t index = ChzzkHistogram::bucketIndex(value);
+
+		CHZZK_CHECK(index < ChzzkHistogram::BUCKET_COUNT);
+		CHZZK_CHECK(index >= previous);
+		CHZZK_CHECK(ChzzkHistogram::bucketUpperBound(index) >= value);
+		CHZZK_CHECK(index == 0 || ChzzkHistogram::bucketUpperBound(index - 1) < value);
+
+		//relative error of the bucket is at most 1 / SUB_BUCKET_COUNT
+		CHZZK_CHECK((double)(ChzzkHistogram::bucketUpperBound(index) - value) / value <= 1.0 / ChzzkHistogram::SUB_BUCKET_COUNT);
+
+		previous = index;
+	}
+
+	//bounds of the buckets are contiguous
+	for (size_t index = 1; index < ChzzkHistogram::BUCKET_COUNT; index++)
+		CHZZK_CHECK(ChzzkHistogram::bucketIndex(ChzzkHistogram::bucketUpperBound(index - 1) + 1) == index);
+
+	//huge values are counted in the last bucket
+	CHZZK_CHECK(ChzzkHistogram::bucketIndex(~(uint64_t)0) == ChzzkHistogram::BUCKET_COUNT - 1);
+}
+
+static void testSnapshot()
+{
+	ChzzkHistogram histogram;
+
+	ChzzkHistogramSnapshot empty = histogram.snapshot();
+	CHZZK_CHECK(empty.count == 0);
+	CHZZK_CHECK(empty.percentile(99) == 0);
+
+	for (uint64_t value = 1; value <= 1000; value++)
+		histogram.record(value);
+
+	ChzzkHistogramSnapshot snapshot = histogram.snapshot();
+
+	CHZZK_CHECK(snapshot.count == 1000);
+	CHZZK_CHECK(snapshot.min == 1);
+	CHZZK_CHECK(snapshot.max == 1000);
+	CHZZK_CHECK(snapshot.mean == 500.5);
+
+	//rounded up to the bucket
+	uint64_t p50 = snapshot.percentile(50);
+	uint64_t p99 = snapshot.percentile(99);
+
+	CHZZK_CHECK(p50 >= 500 && p50 <= 500 * 33 / 32);
+	CHZZK_CHECK(p99 >= 990 && p99 <= 1000);
+	CHZZK_CHECK(snapshot.percentile(100) == 1000);
+	CHZZK_CHECK(snapshot.percentile(0) == 1);
+
+	histogram.reset();
+	CHZZK_CHECK(histogram.snapshot().count == 0);
+}
+
+static void testThreads()
+{
+	const int THREADS = 4;
+	const int COUNT = 100000;
+
+	ChzzkHistogram histogram;
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < THREADS; t++)
+	{
+		threads.emplace_back([&histogram, t]()
+			{
+				for (int i = 0; i < COUNT; i++)
+					histogram.record((uint64_t)(t + 1) * 100);
+			});
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	ChzzkHistogramSnapshot snapshot = histogram.snapshot();
+
+	CHZZK_CHECK(snapshot.count == THREADS * COUNT);
+	CHZZK_CHECK(snapshot.min == 100);
+	CHZZK_CHECK(snapshot.max == THREADS * 100);
+}
+
+int main()
+{
+	testBuckets();
+	testSnapshot();
+	testThreads();
+
+	return CHZZK_TEST_RESULT();
+}
@@ -0,0 +1,100 @@
+#include "ChzzkTest.h"
+
+#include <chzzkpp/ChzzkPolling.h>
+
+using namespace chzzkpp;
+
+//whether the interval is within the jitter of the expected interval
+static bool near(int interval, int expected)
+{
+	int range = expected * ChzzkPollSchedule::JITTER_PERCENT / 100;
+	return interval >= expected - range && interval <= expected + range;
+}
+
+static ChzzkLivePollingStatus makeStatus(int callPeriodMilliSecond, int trafficThrottling)
+{
+	ChzzkLivePollingStatus status;
+	status.isPublishing = true;
+	status.callPeriodMilliSecond = callPeriodMilliSecond;
+	status.trafficThrottling = trafficThrottling;
+
+	return status;
+}
+
+static void testJitter()
+{
+	for (int i = 0; i < 1000; i++)
+		CHZZK_CHECK(near(ChzzkPollSchedule::jitter(10000), 10000));
+
+	//too small to jitter
+	CHZZK_CHECK(ChzzkPollSchedule::jitter(5) == 5);
+}
+
+static void testFirst()
+{
+	ChzzkPollSchedule schedule(30000);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		int first = schedule.first();
+		CHZZK_CHECK(first >= ChzzkPollSchedule::MIN_INTERVAL && first <= 30000);
+	}
+}
+
+static void testPeriod()
+{
+	ChzzkPollSchedule schedule(30000);
+
+	//follows the period of the server
+	CHZZK_CHECK(near(schedule.next(makeStatus(10000, 0)), 10000));
+
+	//default interval if not advertised
+	CHZZK_CHECK(near(schedule.next(makeStatus(0, 0)), 30000));
+
+	//clamped to the bounds
+	CHZZK_CHECK(near(schedule.next(makeStatus(10, 0)), ChzzkPollSchedule::MIN_INTERVAL));
+	CHZZK_CHECK(near(schedule.next(makeStatus(60 * 60 * 1000, 0)), ChzzkPollSchedule::MAX_INTERVAL));
+}
+
+static void testBackoff()
+{
+	ChzzkPollSchedule schedule(30000, 1000, 100000);
+
+	CHZZK_CHECK(near(schedule.next(makeStatus(10000, 0)), 10000));
+
+	//doubles while throttled, up to the max interval
+	CHZZK_CHECK(near(schedule.next(makeStatus(10000, 1)), 20000));
+	CHZZK_CHECK(near(schedule.next(makeStatus(10000, 1)), 40000));
+	CHZZK_CHECK(near(schedule.next(makeStatus(10000, 1)), 80000));
+	CHZZK_CHECK(near(schedule.next(makeStatus(10000, 1)), 100000));
+	CHZZK_CHECK(schedule.getBackoff() == 4);
+
+	//a normal poll ends the backoff
+	CHZZK_CHECK(near(schedule.next(makeStatus(10000, 0)), 10000));
+	CHZZK_CHECK(schedule.getBackoff() == 0);
+
+	//failures back off from the last period
+	CHZZK_CHECK(near(schedule.fail(), 20000));
+	CHZZK_CHECK(near(schedule.fail(), 40000));
+	CHZZK_CHECK(near(schedule.fail(), 80000));
+
+	//the backoff is capped, so the shift never overflows
+	for (int i = 0; i < 100; i++)
+		CHZZK_CHECK(near(schedule.fail(), 100000));
+
+	CHZZK_CHECK(schedule.getBackoff() == 16);
+
+	schedule.reset();
+	CHZZK_CHECK(schedule.getBackoff() == 0);
+	CHZZK_CHECK(near(schedule.fail(), 60000));
+}
+
+int main()
+{
+	testJitter();
+	testFirst();
+	testPeriod();
+	testBackoff();
+
+	return CHZZK_TEST_RESULT();
+}
@@ -0,0 +1,110 @@
+#include "ChzzkTest.h"
+
+#include <chzzkpp/ChzzkRateLimit.h>
+
+#include <thread>
+
+using namespace chzzkpp;
+
+static void testUnlimited()
+{
+	ChzzkRateLimiter limiter;
+
+	for (int i = 0; i < 1000; i++)
+		CHZZK_CHECK(limiter.reserve("api.chzzk.naver.com") == 0);
+
+	CHZZK_CHECK(limiter.getThrottled() == 0);
+}
+
+static void testBucket()
+{
+	ChzzkRateLimiter limiter;
+	limiter.setLimit(10, 2);
+
+	//burst is sent at once
+	CHZZK_CHECK(limiter.reserve("a") == 0);
+	CHZZK_CHECK(limiter.reserve("a") == 0);
+
+	//then a token every 100ms. the tokens are reserved, so the waits add up
+	int wait = limiter.reserve("a");
+	CHZZK_CHECK(wait > 50 && wait <= 100);
+
+	wait = limiter.reserve("a");
+	CHZZK_CHECK(wait > 150 && wait <= 200);
+
+	CHZZK_CHECK(limiter.getThrottled() == 2);
+
+	//each host has its own bucket
+	CHZZK_CHECK(limiter.reserve("b") == 0);
+
+	//the bucket refills, but not over the burst
+	ChzzkRateLimiter refill;
+	refill.setLimit(100, 1);
+
+	CHZZK_CHECK(refill.reserve("a") == 0);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	CHZZK_CHECK(refill.reserve("a") == 0);
+	CHZZK_CHECK(refill.reserve("a") > 0);
+}
+
+static void testHostLimit()
+{
+	ChzzkRateLimiter limiter;
+	limiter.setLimit("comm-api.game.naver.com", 1, 1);
+
+	CHZZK_CHECK(limiter.reserve("comm-api.game.naver.com") == 0);
+	CHZZK_CHECK(limiter.reserve("comm-api.game.naver.com") > 0);
+
+	//other hosts stay unlimited
+	for (int i = 0; i < 10; i++)
+		CHZZK_CHECK(limiter.reserve("api.chzzk.naver.com") == 0);
+}
+
+static void testHost()
+{
+	CHZZK_CHECK(ChzzkRateLimiter::host("https://api.chzzk.naver.com/service/v1/channels") == "api.chzzk.naver.com");
+	CHZZK_CHECK(ChzzkRateLimiter::host("https://api.chzzk.naver.com?a=1") == "api.chzzk.naver.com");
+	CHZZK_CHECK(ChzzkRateLimiter::host("https://api.chzzk.naver.com") == "api.chzzk.naver.com");
+	CHZZK_CHECK(ChzzkRateLimiter::host("api.chzzk.naver.com/path") == "api.chzzk.naver.com");
+}
+
+static void testRetryPolicy()
+{
+	ChzzkRetryPolicy policy;
+	policy.baseDelay = 100;
+	policy.maxDelay = 1000;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		int delay = policy.delay(0);
+		CHZZK_CHECK(delay >= 0 && delay <= 100);
+
+		delay = policy.delay(2);
+		CHZZK_CHECK(delay >= 0 && delay <= 400);
+
+		//capped by maxDelay
+		delay = policy.delay(30);
+		CHZZK_CHECK(delay >= 0 && delay <= 1000);
+	}
+
+	//at least Retry-After, up to maxDelay
+	CHZZK_CHECK(policy.delay(0, 1) >= 1000);
+	CHZZK_CHECK(policy.delay(0, 60) == 1000);
+
+	CHZZK_CHECK(ChzzkRetryPolicy::retryable(429));
+	CHZZK_CHECK(ChzzkRetryPolicy::retryable(503));
+	CHZZK_CHECK(!ChzzkRetryPolicy::retryable(200));
+	CHZZK_CHECK(!ChzzkRetryPolicy::retryable(404));
+}
+
+int main()
+{
+	testUnlimited();
+	testBucket();
+	testHostLimit();
+	testHost();
+	testRetryPolicy();
+
+	return CHZZK_TEST_RESULT();
+}
@@ -0,0 +1,202 @@
+#include "ChzzkTest.h"
+
+#include <chzzkpp/ChzzkChatRecorder.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+
+using namespace chzzkpp;
+
+static std::string logPath()
+{
+	return (std::filesystem::temp_directory_path() / "chzzkpp_recorder_test").string();
+}
+
+static void removeLog(const std::string& path)
+{
+	for (size_t i = 0; std::filesystem::remove(ChzzkChatRecorder::getSegmentPath(path, i)); i++);
+}
+
+static std::string readFile(const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static uint32_t readU32(const std::string& data, size_t offset)
+{
+	uint32_t value = 0;
+
+	for (int i = 3; i >= 0; i--)
+		value = (value << 8) | (unsigned char)data[offset + i];
+
+	return value;
+}
+
+static uint64_t readU64(const std::string& data, size_t offset)
+{
+	return readU32(data, offset) | (uint64_t)readU32(data, offset + 4) << 32;
+}
+
+static void testSegmentPath()
+{
+	CHZZK_CHECK(ChzzkChatRecorder::getSegmentPath("chat.log", 1) == "chat.log.000001");
+	CHZZK_CHECK(ChzzkChatRecorder::getSegmentPath("chat.log", 1234567) == "chat.log.1234567");
+}
+
+static void testFormat()
+{
+	std::string path = logPath();
+	removeLog(path);
+
+	{
+		ChzzkRecorderOptions options;
+		options.flushTime = 0;
+
+		ChzzkChatRecorder recorder(path, options);
+		recorder.write("first", 0x0102030405060708ULL);
+		recorder.write("second frame", 42);
+	}
+
+	std::string data = readFile(ChzzkChatRecorder::getSegmentPath(path, 0));
+
+	//segment header
+	CHZZK_CHECK(data.size() > 12);
+	CHZZK_CHECK(data.compare(0, 8, "CHZZKLOG") == 0);
+	CHZZK_CHECK(readU32(data, 8) == 1);
+
+	//one uncompressed block with both frames
+	size_t rawSize = 2 * (8 + 4) + 5 + 12;
+
+	CHZZK_CHECK(data.size() == 12 + 12 + rawSize);
+	CHZZK_CHECK(readU32(data, 12) == rawSize);
+	CHZZK_CHECK(readU32(data, 16) == rawSize);
+	CHZZK_CHECK(readU32(data, 20) == 0);
+
+	CHZZK_CHECK(readU64(data, 24) == 0x0102030405060708ULL);
+	CHZZK_CHECK(readU32(data, 32) == 5);
+	CHZZK_CHECK(data.compare(36, 5, "first") == 0);
+
+	CHZZK_CHECK(readU64(data, 41) == 42);
+	CHZZK_CHECK(readU32(data, 49) == 12);
+	CHZZK_CHECK(data.compare(53, 12, "second frame") == 0);
+
+	removeLog(path);
+}
+
+static void testReplay()
+{
+	std::string path = logPath();
+	removeLog(path);
+
+	const int COUNT = 1000;
+
+	{
+		//small blocks and segments, so the frames span many of them
+		ChzzkRecorderOptions options;
+		options.flushTime = 0;
+		options.blockSize = 256;
+		options.segmentSize = 4096;
+
+		ChzzkChatRecorder recorder(path, options);
+
+		for (int i = 0; i < COUNT; i++)
+			recorder.write("frame " + std::to_string(i), i);
+
+		recorder.flush();
+		CHZZK_CHECK(recorder.getFrameCount() == COUNT);
+	}
+
+	ChzzkChatReplayer replayer(path);
+	CHZZK_CHECK(replayer.getSegments().size() > 1);
+
+	std::vector<std::string> frames;
+	bool ordered = true;
+
+	size_t count = replayer.replay([&](uint64_t time, std::string_view frame) {
+		if (time != frames.size()) ordered = false;
+		frames.emplace_back(frame);
+	});
+
+	CHZZK_CHECK(count == COUNT);
+	CHZZK_CHECK(ordered);
+	CHZZK_CHECK(frames.size() == COUNT && frames.front() == "frame 0" && frames.back() == "frame 999");
+
+	//a new recorder doesn't overwrite the segments
+	size_t segments = replayer.getSegments().size();
+	{
+		ChzzkRecorderOptions options;
+		options.flushTime = 0;
+
+		ChzzkChatRecorder recorder(path, options);
+		recorder.write("appended", COUNT);
+	}
+
+	ChzzkChatReplayer appended(path);
+	CHZZK_CHECK(appended.getSegments().size() == segments + 1);
+	CHZZK_CHECK(appended.replay([](uint64_t, std::string_view) {}) == COUNT + 1);
+
+	//a block cut by a crash is ignored
+	std::string last = appended.getSegments().back();
+	std::string data = readFile(last);
+	{
+		std::ofstream out(last, std::ios::binary | std::ios::trunc);
+		out.write(data.data(), data.size() - 3);
+	}
+
+	ChzzkChatReplayer truncated(path);
+	CHZZK_CHECK(truncated.replay([](uint64_t, std::string_view) {}) == COUNT);
+
+	removeLog(path);
+}
+
+#if _USE_ZLIB
+static void testCompressed()
+{
+	std::string path = logPath();
+	removeLog(path);
+
+	const int COUNT = 1000;
+	uint64_t written;
+
+	{
+		ChzzkRecorderOptions options;
+		options.flushTime = 0;
+		options.compress = true;
+
+		ChzzkChatRecorder recorder(path, options);
+
+		for (int i = 0; i < COUNT; i++)
+			recorder.write(R"({"cmd":93101,"bdy":[{"msg":"hello )" + std::to_string(i) + R"("}]})", i);
+
+		recorder.flush();
+		written = recorder.getWrittenBytes();
+	}
+
+	//repeated json compresses well
+	CHZZK_CHECK(written < COUNT * 30);
+
+	ChzzkChatReplayer replayer(path);
+	std::string last;
+
+	CHZZK_CHECK(replayer.replay([&](uint64_t, std::string_view frame) { last = frame; }) == COUNT);
+	CHZZK_CHECK(last == R"({"cmd":93101,"bdy":[{"msg":"hello 999"}]})");
+
+	removeLog(path);
+}
+#endif
+
+int main()
+{
+	testSegmentPath();
+	testFormat();
+	testReplay();
+#if _USE_ZLIB
+	testCompressed();
+#endif
+
+	return CHZZK_TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+#include "ChzzkTest.h"
+
+#include <chzzkpp/ChzzkDispatcher.h>
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+using namespace chzzkpp;
+
+static void testCapacity()
+{
+	ChzzkRingBuffer<int> small(1);
+	CHZZK_CHECK(small.capacity() == 2);
+
+	ChzzkRingBuffer<int> buffer(5);
+	CHZZK_CHECK(buffer.capacity() == 8);
+}
+
+static void testOrder()
+{
+	ChzzkRingBuffer<std::string> buffer(4);
+
+	for (int i = 0; i < 4; i++)
+		CHZZK_CHECK(buffer.push(std::to_string(i)));
+
+	//full
+	CHZZK_CHECK(!buffer.push("4"));
+	CHZZK_CHECK(buffer.size() == 4);
+
+	std::string value;
+
+	for (int i = 0; i < 4; i++)
+	{
+		CHZZK_CHECK(buffer.pop(value));
+		CHZZK_CHECK(value == std::to_string(i));
+	}
+
+	//empty
+	CHZZK_CHECK(!buffer.pop(value));
+	CHZZK_CHECK(buffer.size() == 0);
+}
+
+static void testWrapAround()
+{
+	ChzzkRingBuffer<int> buffer(4);
+	int value = 0;
+
+	//positions go around the cells many times
+	for (int i = 0; i < 1000; i++)
+	{
+		CHZZK_CHECK(buffer.push(+i));
+		CHZZK_CHECK(buffer.push(-i));
+		CHZZK_CHECK(buffer.pop(value) && value == i);
+		CHZZK_CHECK(buffer.pop(value) && value == -i);
+	}
+
+	CHZZK_CHECK(!buffer.pop(value));
+}
+
+static void testThreads()
+{
+	const int PRODUCERS = 4;
+	const int CONSUMERS = 4;
+	const int COUNT = 100000;
+
+	ChzzkRingBuffer<int> buffer(256);
+
+	std::atomic<long long> sum(0);
+	std::atomic<int> popped(0);
+	std::vector<std::thread> threads;
+
+	for (int p = 0; p < PRODUCERS; p++)
+	{
+		threads.emplace_back([&]()
+			{
+				for (int i = 1; i <= COUNT; i++)
+					while (!buffer.push(+i)) std::this_thread::yield();
+			});
+	}
+
+	for (int c = 0; c < CONSUMERS; c++)
+	{
+		threads.emplace_back([&]()
+			{
+				int value;
+
+				while (popped < PRODUCERS * COUNT)
+				{
+					if (buffer.pop(value))
+					{
+						sum += value;
+						popped++;
+					}
+					else std::this_thread::yield();
+				}
+			});
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	//every pushed item is popped exactly once
+	CHZZK_CHECK(popped == PRODUCERS * COUNT);
+	CHZZK_CHECK(sum == (long long)PRODUCERS * COUNT * (COUNT + 1) / 2);
+}
+
+int main()
+{
+	testCapacity();
+	testOrder();
+	testWrapAround();
+	testThreads();
+
+	return CHZZK_TEST_RESULT();
+}